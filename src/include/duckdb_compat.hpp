@@ -58,9 +58,10 @@ inline string CompatMakeIdentifier(string name) {
 #ifdef DUCKDB_HAS_NEW_VECTOR_HEADERS
 
 // --- Bind function signature ---
-#define DUCKDB_SCALAR_BIND_PARAMS  BindScalarFunctionInput &bind_input
-#define DUCKDB_SCALAR_BIND_CONTEXT bind_input.GetClientContext()
-#define DUCKDB_SCALAR_BIND_ARGS    bind_input.GetArguments()
+#define DUCKDB_SCALAR_BIND_PARAMS   BindScalarFunctionInput &bind_input
+#define DUCKDB_SCALAR_BIND_CONTEXT  bind_input.GetClientContext()
+#define DUCKDB_SCALAR_BIND_ARGS     bind_input.GetArguments()
+#define DUCKDB_SCALAR_BIND_FUNCTION bind_input.GetBoundFunction()
 
 // --- ScalarFunction property setters (fields are now private) ---
 inline void SetScalarFunctionNullHandling(ScalarFunction &func, FunctionNullHandling handling) {
@@ -69,6 +70,9 @@ inline void SetScalarFunctionNullHandling(ScalarFunction &func, FunctionNullHand
 inline void SetScalarFunctionVarArgs(ScalarFunction &func, LogicalType varargs) {
 	func.SetVarArgs(std::move(varargs));
 }
+inline void SetScalarFunctionReturnType(ScalarFunction &func, LogicalType return_type) {
+	func.SetReturnType(std::move(return_type));
+}
 
 // --- Vector helpers ---
 // ListVector::GetEntry deprecated in favor of GetChild
@@ -117,8 +121,9 @@ inline LogicalType CompatForceMaxLogicalType(const LogicalType &left, const Logi
 
 #define DUCKDB_SCALAR_BIND_PARAMS                                                                                      \
 	ClientContext &context, ScalarFunction &bound_function, vector<unique_ptr<Expression>> &arguments
-#define DUCKDB_SCALAR_BIND_CONTEXT context
-#define DUCKDB_SCALAR_BIND_ARGS    arguments
+#define DUCKDB_SCALAR_BIND_CONTEXT  context
+#define DUCKDB_SCALAR_BIND_ARGS     arguments
+#define DUCKDB_SCALAR_BIND_FUNCTION bound_function
 
 inline void SetScalarFunctionNullHandling(ScalarFunction &func, FunctionNullHandling handling) {
 	func.null_handling = handling;
@@ -126,6 +131,9 @@ inline void SetScalarFunctionNullHandling(ScalarFunction &func, FunctionNullHand
 inline void SetScalarFunctionVarArgs(ScalarFunction &func, LogicalType varargs) {
 	func.varargs = std::move(varargs);
 }
+inline void SetScalarFunctionReturnType(ScalarFunction &func, LogicalType return_type) {
+	func.return_type = std::move(return_type);
+}
 
 inline Vector &CompatListGetChild(Vector &v) {
 	return ListVector::GetEntry(v);
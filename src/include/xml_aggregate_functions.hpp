@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+class XMLAggregateFunctions {
+public:
+	static void Register(ExtensionLoader &loader);
+};
+
+} // namespace duckdb
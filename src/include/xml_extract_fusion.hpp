@@ -0,0 +1,26 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+
+namespace duckdb {
+
+// Optimizer pass that merges the XPath scalars of a projection which share one input expression.
+//
+//   SELECT xml_extract_text(doc, '//title'), xml_extract_attributes(doc, '//item') FROM t
+//
+// parses every `doc` twice. The pass inserts a projection below that computes a single fused call
+// (one parse per row, one STRUCT field per original call) and rewrites each original call as a
+// struct_extract of that column, so generated SQL gets parse-once behavior without changes.
+//
+// Only the 2-argument forms with a constant XPath that every row evaluates are fused; namespace-aware
+// calls keep their own parse since AUTO mode may rewrite the XPath per document, and calls under CASE,
+// AND / OR or COALESCE are left alone so rows that skip them are not parsed for them.
+class XMLExtractFusionOptimizer {
+public:
+	static OptimizerExtension GetExtension();
+
+	static void Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan);
+};
+
+} // namespace duckdb
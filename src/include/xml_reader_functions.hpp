@@ -3,7 +3,9 @@
 #include "duckdb.hpp"
 #include "xml_sax_reader.hpp"
 #include "xml_schema_inference.hpp"
+#include "xml_schema_validator.hpp"
 
+#include <atomic>
 #include <mutex>
 
 namespace duckdb {
@@ -14,6 +16,13 @@ enum class ParseMode {
 	HTML // Lenient HTML parsing
 };
 
+// What read_xml does with a file that does not validate against its `xsd` schema (on_invalid)
+enum class XSDInvalidFileAction {
+	RAISE_ERROR, // 'error': fail the query (or skip the file under ignore_errors)
+	SKIP_FILE,   // 'skip_file': emit no rows from the file
+	FLAG         // 'flag': emit its rows with xsd_valid = false
+};
+
 class XMLReaderFunctions {
 public:
 	static void Register(ExtensionLoader &loader);
@@ -40,6 +49,8 @@ private:
 	                                                                 GlobalTableFunctionState *global_state);
 	static OperatorPartitionData ReadDocumentGetPartitionData(ClientContext &context,
 	                                                          TableFunctionGetPartitionInput &input);
+	// EXPLAIN ANALYZE detail: DOM/SAX engine decisions and the budget they were made against.
+	static InsertionOrderPreservingMap<string> ReadDocumentToString(TableFunctionDynamicToStringInput &input);
 
 	// Public XML functions (delegate to internal functions)
 	static void ReadXMLObjectsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
@@ -72,6 +83,13 @@ private:
 	static unique_ptr<GlobalTableFunctionState> HTMLExtractTablesInit(ClientContext &context,
 	                                                                  TableFunctionInitInput &input);
 
+	// xml_document_cache_stats - counters of the per-thread parsed-document cache (XMLDocumentCache)
+	static void XMLDocumentCacheStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
+	static unique_ptr<FunctionData> XMLDocumentCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+	                                                          vector<LogicalType> &return_types, vector<string> &names);
+	static unique_ptr<GlobalTableFunctionState> XMLDocumentCacheStatsInit(ClientContext &context,
+	                                                                      TableFunctionInitInput &input);
+
 	// parse_xml_objects / parse_html_objects - parse XML/HTML strings and return raw content
 	static void ParseDocumentObjectsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
 	static unique_ptr<FunctionData> ParseDocumentObjectsBind(ClientContext &context, TableFunctionBindInput &input,
@@ -105,9 +123,18 @@ private:
 struct XMLReadFunctionData : public TableFunctionData {
 	vector<string> files;
 	bool ignore_errors = false;
-	idx_t max_file_size = 16777216;        // 16MB default (files above this use SAX streaming)
+	idx_t max_file_size = 16777216;        // 16MB default (hard cap for read_*_objects)
 	ParseMode parse_mode = ParseMode::XML; // Parsing mode (XML or HTML)
 
+	// DOM/SAX engine selection for read_xml/read_html. An explicit maximum_file_size keeps the
+	// legacy fixed threshold (files above it stream via SAX or are rejected). Otherwise each file's
+	// DOM footprint is estimated as file_size * dom_expansion_factor and compared against the
+	// per-document share of memory_limit. The factor is measured on the DOM-parsed sample files at
+	// bind; DEFAULT_DOM_EXPANSION_FACTOR is used when nothing was DOM-parsed (explicit columns).
+	static constexpr double DEFAULT_DOM_EXPANSION_FACTOR = 8.0;
+	bool has_explicit_max_file_size = false;
+	double dom_expansion_factor = DEFAULT_DOM_EXPANSION_FACTOR;
+
 	// For _objects functions
 	bool include_filename = false;
 
@@ -133,21 +160,64 @@ struct XMLReadFunctionData : public TableFunctionData {
 	// schema robust to columns/types a leading file happens not to exhibit, without the cost of
 	// opening an entire glob. `sample_files := -1` samples every file; values < 1 are treated as 1.
 	int64_t schema_sample_files = 8;
+
+	// XSD validation (read_xml's `xsd` / `on_invalid`). The schema is compiled once at bind and shared
+	// by every worker; each worker validates through its own XMLSchemaValidator.
+	string xsd_path;
+	XMLSharedSchemaPtr xsd_schema;
+	XSDInvalidFileAction on_invalid = XSDInvalidFileAction::RAISE_ERROR;
+
+	// Output columns ahead of the record's own: filename, then xsd_valid (on_invalid := 'flag')
+	idx_t LeadingColumnCount() const {
+		return (include_filename ? 1 : 0) + (xsd_schema && on_invalid == XSDInvalidFileAction::FLAG ? 1 : 0);
+	}
+};
+
+// A parsed DOM whose records are extracted by several workers at once. The worker that parsed
+// the file publishes it to the global state; any worker may then claim a slice of
+// STANDARD_VECTOR_SIZE records, so each slice fills exactly one output chunk and its slice number
+// doubles as the within-file chunk index (batch indices stay in document order). The tree is
+// only read after publication; the last slice holder to finish releases it.
+struct SharedXMLDocument {
+	idx_t file_index = 0;
+	string filename;
+	XMLDocRAII doc;
+	std::vector<xmlNodePtr> record_elements; // Pointers into doc
+	int remaining_depth = 0;                 // For extraction depth calculation
+	bool shaped_extraction = false;          // Records go through XMLReadGlobalState::record_plan
+	bool xsd_valid = true;                   // Verdict of the `xsd` schema, when one is given
+	idx_t slice_count = 0;
+	idx_t next_slice = 0; // Guarded by XMLReadGlobalState::file_lock
 };
 
-// Shared, read-only-after-init state plus a mutex-guarded file dispatcher. All per-file
+// Shared, read-only-after-init state plus a mutex-guarded work dispatcher. All per-file
 // cursor state lives in XMLReadLocalState (below), so each worker thread can process a
-// different file concurrently. See issue #72.
+// different file concurrently (issue #72), or a slice of a shared DOM (SharedXMLDocument).
 struct XMLReadGlobalState : public GlobalTableFunctionState {
 	vector<string> files;
 
+	// Per-document DOM memory budget (memory_limit / the DOMs a scan holds at once), fixed at
+	// init, and the memory_limit it is taken from. Engine decisions are counted for EXPLAIN
+	// ANALYZE (see ReadDocumentToString).
+	idx_t dom_memory_budget = 0;
+	idx_t memory_limit = 0;
+	std::atomic<idx_t> dom_files {0};
+	std::atomic<idx_t> sax_files {0};
+	std::atomic<idx_t> xsd_invalid_files {0};
+
+	// Shape-specialized extraction plan for the bound schema (GENERIC: use the generic extractor)
+	XMLRecordPlan record_plan;
+
+	// Worker count: one per file, raised to the thread count by read_xml/read_html so a single
+	// large DOM can be extracted in parallel. DuckDB caps this to the available threads.
+	idx_t max_workers = 0;
+
 	idx_t MaxThreads() const override {
-		// One worker per file; a single-file read stays single-threaded (behaviour unchanged,
-		// including the 2-4 GiB whole-document path). DuckDB caps this to the available threads.
-		return files.empty() ? 1 : files.size();
+		return MaxValue<idx_t>(1, MaxValue<idx_t>(files.size(), max_workers));
 	}
 
 	// Hand the next file index to a worker, or INVALID_INDEX once the work list is exhausted.
+	// Used by read_*_objects, which never shares documents.
 	idx_t ClaimNextFile() {
 		std::lock_guard<std::mutex> guard(file_lock);
 		if (next_file_index >= files.size()) {
@@ -156,13 +226,73 @@ struct XMLReadGlobalState : public GlobalTableFunctionState {
 		return next_file_index++;
 	}
 
+	// One unit of record-reader work: a slice of a published DOM, or a whole file to open.
+	struct WorkItem {
+		shared_ptr<SharedXMLDocument> document; // set for a slice
+		idx_t slice = 0;
+		idx_t file_index = DConstants::INVALID_INDEX; // set for a file
+	};
+
+	// Claim the next work item for read_xml/read_html, preferring slices of already-parsed
+	// documents (finishing them first bounds how many DOMs are alive). DuckDB requires each
+	// worker's batch indices to be non-decreasing, so only documents at or after `min_file_index`
+	// (the worker's last file) are eligible, and the earliest of them is taken: the publishing
+	// worker then always drains its own document before moving past it, so no slice is stranded.
+	// Never waits: with no slice or file left it returns false and the worker finishes, so a scan
+	// never holds a scheduler thread while another worker is still parsing a file.
+	bool ClaimNextWork(idx_t min_file_index, WorkItem &item) {
+		std::lock_guard<std::mutex> guard(file_lock);
+		// Erasing only shifts entries after `earliest`, so its index stays valid
+		idx_t earliest = DConstants::INVALID_INDEX;
+		for (idx_t i = 0; i < shared_documents.size();) {
+			auto &document = shared_documents[i];
+			if (document->next_slice >= document->slice_count) {
+				// Fully claimed; the slice holders keep it alive.
+				shared_documents.erase(shared_documents.begin() + static_cast<int64_t>(i));
+				continue;
+			}
+			if (document->file_index >= min_file_index &&
+			    (earliest == DConstants::INVALID_INDEX ||
+			     document->file_index < shared_documents[earliest]->file_index)) {
+				earliest = i;
+			}
+			i++;
+		}
+		if (earliest != DConstants::INVALID_INDEX) {
+			item.document = shared_documents[earliest];
+			item.slice = item.document->next_slice++;
+			return true;
+		}
+		if (next_file_index < files.size()) {
+			item.file_index = next_file_index++;
+			return true;
+		}
+		return false;
+	}
+
+	// Publish a parsed DOM for sliced extraction by any worker still claiming work
+	void PublishDocument(shared_ptr<SharedXMLDocument> document) {
+		if (document->slice_count == 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> guard(file_lock);
+		shared_documents.push_back(std::move(document));
+	}
+
+	// Stop handing out slices of a document (ignore_errors skipped the rest of the file).
+	void AbandonDocument(SharedXMLDocument &document) {
+		std::lock_guard<std::mutex> guard(file_lock);
+		document.next_slice = document.slice_count;
+	}
+
 private:
 	std::mutex file_lock;
 	idx_t next_file_index = 0;
+	std::vector<shared_ptr<SharedXMLDocument>> shared_documents;
 };
 
-// Per-worker cursor over one file at a time. A worker claims a file from the global
-// dispatcher, emits at most ONE file's rows per output chunk (partial chunks at file
+// Per-worker cursor over one file (or one shared-DOM slice) at a time. A worker claims work from
+// the global dispatcher, emits at most ONE file's rows per output chunk (partial chunks at file
 // boundaries are expected), and tags each chunk with a batch index so DuckDB's
 // order-preserving reassembly restores glob/file order under parallel execution.
 struct XMLReadLocalState : public LocalTableFunctionState {
@@ -179,13 +309,12 @@ struct XMLReadLocalState : public LocalTableFunctionState {
 	bool have_file = false;     // a file is claimed and being processed
 	bool file_loaded = false;   // per-file resources are initialized
 
-	// Lazy DOM iteration state
-	XMLDocRAII current_doc;                  // DOM stays alive across scan calls
-	std::vector<xmlNodePtr> record_elements; // Pointers into DOM; valid only while current_doc is alive
-	idx_t current_record_index = 0;          // Position in record_elements
-	int remaining_depth = 0;                 // For extraction depth calculation
+	// DOM slice iteration state: records [current_record_index, record_end_index) of shared_doc
+	shared_ptr<SharedXMLDocument> shared_doc; // Keeps the DOM alive across scan calls
+	idx_t current_record_index = 0;
+	idx_t record_end_index = 0;
 
-	// SAX streaming state (used when streaming=true and file exceeds maximum_file_size)
+	// SAX streaming state (used when streaming=true and the file's estimated DOM exceeds the budget)
 	bool use_sax = false;
 	std::unique_ptr<SAXRecordAccumulator> sax_accumulator; // Accumulator state (persists across scan calls)
 	std::unique_ptr<SAXCallbackContext> sax_ctx;           // Callback context (persists across scan calls)
@@ -194,6 +323,24 @@ struct XMLReadLocalState : public LocalTableFunctionState {
 	xmlSAXHandler sax_handler;                             // SAX handler (must outlive parser context)
 	std::vector<SAXRecordAccumulator> sax_pending_records; // Records completed during current chunk
 
+	// XSD validation: this worker's validator (created on first use), whether it is plugged into the
+	// current file's push parser, and the current file's verdict when it is known up front
+	unique_ptr<XMLSchemaValidator> xsd_validator;
+	bool xsd_plugged = false;
+	bool file_xsd_valid = true;
+
+	// Deferred columns (DOM path) are not produced as Values: batch-cast columns have their text
+	// staged for the current chunk's rows [batch_start, batch_start + batch_rows) and converted by one
+	// vector cast per column; vector-write (LIST/STRUCT) columns are written straight into the output.
+	bool deferred_columns_initialized = false;
+	std::vector<bool> deferred_columns;     // Per schema column: skipped by the Value extraction
+	std::vector<idx_t> batch_cast_indexes;  // Schema column index of each staged column
+	std::vector<idx_t> vector_write_indexes; // Schema column index of each vector-write column
+	DataChunk batch_text;                   // One VARCHAR vector per staged column
+	std::string batch_cell;                 // Reused per-cell text buffer
+	idx_t batch_start = 0;
+	idx_t batch_rows = 0;
+
 	~XMLReadLocalState() {
 		if (sax_parser_ctx) {
 			xmlFreeParserCtxt(sax_parser_ctx);
@@ -201,12 +348,19 @@ struct XMLReadLocalState : public LocalTableFunctionState {
 		}
 	}
 
+	XMLSchemaValidator &GetXSDValidator(const XMLReadFunctionData &bind_data) {
+		if (!xsd_validator) {
+			xsd_validator = make_uniq<XMLSchemaValidator>(bind_data.xsd_schema);
+		}
+		return *xsd_validator;
+	}
+
 	// Release all per-file resources (when a file is finished or skipped). Keeps file_index /
 	// last_batch_index so a just-produced chunk can still be tagged by get_partition_data.
 	void ResetFileResources() {
-		current_doc = XMLDocRAII();
-		record_elements.clear();
+		shared_doc.reset();
 		current_record_index = 0;
+		record_end_index = 0;
 		if (sax_parser_ctx) {
 			xmlFreeParserCtxt(sax_parser_ctx);
 			sax_parser_ctx = nullptr;
@@ -215,6 +369,11 @@ struct XMLReadLocalState : public LocalTableFunctionState {
 		sax_ctx.reset();
 		sax_file_handle.reset();
 		sax_pending_records.clear();
+		if (xsd_plugged) {
+			xsd_validator->Unplug();
+			xsd_plugged = false;
+		}
+		file_xsd_valid = true;
 		use_sax = false;
 		file_loaded = false;
 	}
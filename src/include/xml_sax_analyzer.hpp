@@ -0,0 +1,205 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "xml_utils.hpp"
+#include <libxml/xmlstring.h>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace duckdb {
+
+// An element start as seen by an analyzer, with libxml2's SAX2 arguments
+struct XMLSAXElement {
+	const xmlChar *localname;
+	const xmlChar *prefix;
+	const xmlChar *uri;
+	int nb_namespaces;
+	const xmlChar **namespaces; // (prefix, URI) pairs declared on the element
+	int nb_attributes;
+	const xmlChar **attributes; // (localname, prefix, URI, value, value end) for each attribute
+	idx_t depth;                // 1 for the root element
+};
+
+// Receives the events of one SAX pass over a document. Line numbers are those the node starts on.
+class XMLSAXAnalyzer {
+public:
+	virtual ~XMLSAXAnalyzer() {
+	}
+
+	virtual void StartElement(const XMLSAXElement &element) {
+	}
+	virtual void EndElement() {
+	}
+	// Character data, possibly split across several calls
+	virtual void Characters(const char *data, idx_t size) {
+	}
+	// A CDATA section; adjacent sections form one node, as in the DOM, and arrive with `append` set
+	virtual void CData(const char *data, idx_t size, int64_t line_number, bool append) {
+	}
+	virtual void Comment(const char *content, int64_t line_number) {
+	}
+	virtual void ProcessingInstruction() {
+	}
+};
+
+enum class XMLSAXAnalysisResult {
+	COMPLETE,
+	// Not well-formed; whatever the analyzers collected must be discarded, like a failed DOM parse
+	MALFORMED,
+	// The document has a DOCTYPE, whose entities and default attributes only the DOM applies
+	UNSUPPORTED
+};
+
+// Runs any number of analyzers over a single streaming parse, so whole-document statistics and
+// collections need neither a DOM nor one parse per analyzer. Memory is bounded by what the
+// analyzers keep, not by the size of the document.
+class XMLSAXAnalysis {
+public:
+	static XMLSAXAnalysisResult Run(const string_t &xml_str, const std::vector<XMLSAXAnalyzer *> &analyzers);
+
+private:
+	static constexpr idx_t CHUNK_SIZE = 65536;
+};
+
+// xml_stats: element, attribute and namespace counts and the depth of the tree (a level below an
+// element for any child node, as the DOM traversal counts it)
+class XMLStatsAnalyzer : public XMLSAXAnalyzer {
+public:
+	void StartElement(const XMLSAXElement &element) override;
+	void EndElement() override;
+	void Characters(const char *data, idx_t size) override;
+	void CData(const char *data, idx_t size, int64_t line_number, bool append) override;
+	void Comment(const char *content, int64_t line_number) override;
+	void ProcessingInstruction() override;
+
+	XMLStats GetStats(idx_t size_bytes) const;
+
+private:
+	void AddChild();
+
+	int64_t element_count = 0;
+	int64_t attribute_count = 0;
+	int64_t max_depth = 0;
+	idx_t depth = 0;
+	std::unordered_set<std::string> namespace_uris;
+};
+
+// xml_namespaces: each distinct (prefix, URI) in document order, from element names and declarations
+class XMLNamespaceAnalyzer : public XMLSAXAnalyzer {
+public:
+	void StartElement(const XMLSAXElement &element) override;
+
+	std::vector<XMLNamespace> namespaces;
+
+private:
+	void Add(const xmlChar *prefix, const xmlChar *uri);
+
+	std::set<std::pair<std::string, std::string>> seen;
+};
+
+// xml_extract_comments
+class XMLCommentAnalyzer : public XMLSAXAnalyzer {
+public:
+	void Comment(const char *content, int64_t line_number) override;
+
+	std::vector<XMLComment> comments;
+};
+
+// xml_extract_cdata
+class XMLCDataAnalyzer : public XMLSAXAnalyzer {
+public:
+	void CData(const char *data, idx_t size, int64_t line_number, bool append) override;
+
+	std::vector<XMLComment> sections;
+};
+
+// xml_extract_all_text: every text and CDATA node, concatenated in document order
+class XMLTextAnalyzer : public XMLSAXAnalyzer {
+public:
+	void Characters(const char *data, idx_t size) override;
+	void CData(const char *data, idx_t size, int64_t line_number, bool append) override;
+
+	std::string text;
+};
+
+// xml_to_json: writes a document's JSON as its events arrive, into one buffer that is reused from
+// document to document. An element's members are its attributes, its direct text, then its child
+// elements grouped by name in order of first appearance (a name that occurs more than once, or is
+// in force_list, becomes a list). Documents with a DOCTYPE are replayed from their DOM instead.
+class XMLToJSONWriter : public XMLSAXAnalyzer {
+public:
+	explicit XMLToJSONWriter(const XMLToJSONOptions &options);
+
+	void StartElement(const XMLSAXElement &element) override;
+	void EndElement() override;
+	void Characters(const char *data, idx_t size) override;
+	void CData(const char *data, idx_t size, int64_t line_number, bool append) override;
+
+	// Start a new document
+	void Reset();
+	// Write the document from its DOM instead (documents with a DOCTYPE, see XMLSAXAnalysis)
+	void WriteDocument(xmlDocPtr doc);
+	// The JSON of the document; "{}" when no root element was written
+	const std::string &Finish();
+
+private:
+	enum class NamespaceMode { STRIP, EXPAND, KEEP };
+
+	struct ChildValue {
+		idx_t offset; // Of the value in `json`
+		idx_t size;
+		idx_t next; // Next child of the same name, DConstants::INVALID_INDEX for the last
+	};
+	struct ChildGroup {
+		std::string key;
+		bool as_list;
+		idx_t first;
+		idx_t last;
+	};
+	// An open element. Its value starts at `start` in `json` with '{' and its attributes, followed by
+	// its child elements' members as they close. Same-named children normally arrive together, so
+	// the members are written in their final form as they come (`in_place`); only text after child
+	// elements or a name that reappears after another one makes the end tag rebuild them.
+	struct Frame {
+		std::string key;
+		idx_t group; // Index of the element's name among its parent's groups
+		idx_t start;
+		idx_t members_size; // Attributes and namespace declarations, after the '{'
+		bool in_place;
+		std::string text;
+		std::vector<ChildValue> children;
+		std::vector<ChildGroup> groups;
+		std::unordered_map<std::string, idx_t> group_index;
+	};
+
+	void OpenElement(const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri);
+	void AddAttribute(const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri, const char *value,
+	                  idx_t size);
+	void AddNamespace(const xmlChar *prefix, const xmlChar *uri);
+	void EndStartTag();
+	void CloseElement();
+	void CloseLastGroup(const Frame &frame);
+	void StartMember(const Frame &frame);
+	void WriteKey(const std::string &key);
+	void AppendText(std::string &out, const std::string &text);
+	void AppendName(std::string &out, const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri,
+	                bool escape) const;
+	void WriteDOMElement(xmlDocPtr doc, xmlNodePtr node);
+
+	XMLToJSONOptions options;
+	NamespaceMode namespace_mode;
+	std::unordered_set<std::string> force_list;
+
+	std::vector<Frame> frames; // frames[0, depth) are the open elements, the root first
+	idx_t depth = 0;
+	bool namespaces_open = false; // The root's namespace object has been started
+	bool has_root = false;
+	std::string json;
+	std::string value;   // An element value being rebuilt
+	std::string scratch; // Decoded attribute values
+};
+
+} // namespace duckdb
@@ -5,10 +5,41 @@
 
 namespace duckdb {
 
+// The XPath scalars XMLExtractFusionOptimizer can merge into one parse of their shared input
+enum class XPathExtractKind : uint8_t {
+	TEXT_LIST,       // xml_extract_text
+	ELEMENTS_LIST,   // xml_extract_elements
+	ELEMENTS_STRING, // xml_extract_elements_string
+	ATTRIBUTES       // xml_extract_attributes
+};
+
+// Bind data of a fused extraction: field i of the STRUCT result is what the `kinds[i]` scalar would
+// return for XPath `paths[i]`.
+struct XPathFusedBindData : public FunctionData {
+	vector<XPathExtractKind> kinds;
+	vector<string> paths;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<XPathFusedBindData>();
+		result->kinds = kinds;
+		result->paths = paths;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<XPathFusedBindData>();
+		return kinds == other.kinds && paths == other.paths;
+	}
+};
+
 class XMLScalarFunctions {
 public:
 	static void Register(ExtensionLoader &loader);
 
+	// The fused parse-once extraction the fusion optimizer substitutes for several XPath scalars over
+	// one input. Not registered in the catalog; `return_type` is the STRUCT of the original results.
+	static ScalarFunction GetFusedExtractFunction(const LogicalType &input_type, const LogicalType &return_type);
+
 private:
 	// Validation functions
 	static void XMLValidFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -34,6 +65,18 @@ private:
 	static void XMLWrapFragmentFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void XMLExtractAttributesFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void XMLExtractAttributesWithNamespacesFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	// First-match functions that stop parsing once the answer is known, for simple paths
+	static void XMLExistsFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void XMLExtractFirstFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	// Typed extraction: the first match (or every match, for LIST results) written as a typed value
+	static void XMLExtractNumberFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void XMLExtractBigintFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void XMLExtractBooleanFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void XMLExtractTimestampFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	// Multi-path extraction: one STRUCT field per XPath, evaluated against a single parse of each row
+	static void XMLExtractStructFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static unique_ptr<FunctionData> XMLExtractStructBind(DUCKDB_SCALAR_BIND_PARAMS);
+	static void XMLExtractFusedFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void XMLExtractCommentsFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void XMLExtractCDataFunction(DataChunk &args, ExpressionState &state, Vector &result);
 
@@ -45,8 +88,11 @@ private:
 	static void XMLToJSONFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void XMLToJSONWithSchemaFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static unique_ptr<FunctionData> XMLToJSONWithSchemaBind(DUCKDB_SCALAR_BIND_PARAMS);
+	static void XMLToStructFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static unique_ptr<FunctionData> XMLToStructBind(DUCKDB_SCALAR_BIND_PARAMS);
 	static void JSONToXMLFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void ValueToXMLFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static unique_ptr<FunctionData> ValueToXMLBind(DUCKDB_SCALAR_BIND_PARAMS);
 
 	// Analysis functions
 	static void XMLStatsFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -64,6 +110,8 @@ private:
 	static void HTMLExtractTextFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void HTMLExtractTextWithXPathFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void HTMLExtractTextListFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void HTMLExtractStructFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static unique_ptr<FunctionData> HTMLExtractStructBind(DUCKDB_SCALAR_BIND_PARAMS);
 	static void HTMLExtractLinksFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void HTMLExtractImagesFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void HTMLExtractTableRowsFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -92,6 +92,31 @@ struct XMLColumnInfo {
 	}
 };
 
+// Record shapes that have a specialized extraction loop (ExtractShapedRecord). GENERIC records
+// go through ExtractSingleRecord / ExtractSingleRecordWithSchema.
+enum class XMLRecordShape : uint8_t {
+	GENERIC,
+	ATTRIBUTES_ONLY, // Inferred schema whose scalar columns are all attributes (e.g. <node id lat lon/>)
+	FLAT             // Scalar attribute and child-element columns; LIST/STRUCT columns are vector-written
+};
+
+// Bind-time extraction plan for a record shape: per-column metadata plus name -> column lookups so
+// a record's attributes and children are each visited once instead of once per column.
+struct XMLRecordPlan {
+	struct Column {
+		std::string name;
+		LogicalType type;
+		std::string datetime_format;
+		bool is_attribute; // Inferred schema only: attribute column, never matched to elements
+	};
+
+	XMLRecordShape shape = XMLRecordShape::GENERIC;
+	bool explicit_schema = false;
+	std::vector<Column> columns;
+	std::unordered_map<std::string, idx_t> attribute_columns; // Attribute name -> column index
+	std::unordered_map<std::string, idx_t> element_columns;   // Child element name -> column index
+};
+
 // Statistics about element patterns
 struct ElementPattern {
 	std::string name;                                          // Element name
@@ -191,15 +216,53 @@ public:
 	                      const XMLSchemaOptions &options = XMLSchemaOptions {},
 	                      const std::vector<std::string> &column_datetime_formats = {});
 
-	// Extract one row from a record node using inferred schema
+	// Extract one row from a record node using inferred schema. Columns flagged in `skip_columns` are
+	// left as NULL placeholders (the caller writes them with WriteInferredColumn).
 	static std::vector<Value> ExtractSingleRecord(xmlNodePtr record, const std::vector<XMLColumnInfo> &schema,
-	                                              int remaining_depth, const XMLSchemaOptions &options);
+	                                              int remaining_depth, const XMLSchemaOptions &options,
+	                                              const std::vector<bool> *skip_columns = nullptr);
 
-	// Extract one row using explicit column names/types
+	// Extract one row using explicit column names/types. Columns flagged in `skip_columns` are left
+	// as NULL placeholders (their values are produced by a vector cast or WriteColumnWithSchema).
 	static std::vector<Value>
 	ExtractSingleRecordWithSchema(xmlNodePtr record, const std::vector<std::string> &column_names,
 	                              const std::vector<LogicalType> &column_types, const XMLSchemaOptions &options,
-	                              const std::vector<std::string> &column_datetime_formats = {});
+	                              const std::vector<std::string> &column_datetime_formats = {},
+	                              const std::vector<bool> *skip_columns = nullptr);
+
+	// Batch conversion: columns whose typed values can be produced for a whole output vector at once
+	// by VectorOperations::TryCast from VARCHAR. Limited to the types whose DuckDB string cast matches
+	// ConvertToValue exactly (INTEGER, BIGINT, DOUBLE, DATE) and that have no datetime_format.
+	static bool IsBatchCastColumn(const LogicalType &type, const std::string &datetime_format);
+	// Raw text for a batch-cast column, located as ExtractSingleRecordWithSchema does (attribute,
+	// first matching child, then the record itself). Returns false where ConvertToValue would yield
+	// NULL without parsing (missing, empty, or a nullstr match).
+	static bool ExtractRawColumnText(xmlNodePtr record, const std::string &column_name,
+	                                 const XMLSchemaOptions &options, std::string &text);
+
+	// Shape-specialized extraction. PlanRecordShape classifies a bound schema (GENERIC when no
+	// specialized loop applies); ExtractShapedRecord produces the same row as the generic extractor
+	// for the same schema. SupportsShapedExtraction rejects documents whose DTD declares attribute
+	// defaults, which xmlGetProp reports but a record's own attribute list does not hold.
+	static XMLRecordPlan PlanRecordShape(const std::vector<XMLColumnInfo> &schema, const XMLSchemaOptions &options);
+	static XMLRecordPlan PlanRecordShape(const std::vector<std::string> &column_names,
+	                                     const std::vector<LogicalType> &column_types,
+	                                     const std::vector<std::string> &column_datetime_formats,
+	                                     const XMLSchemaOptions &options);
+	static bool SupportsShapedExtraction(xmlDocPtr doc);
+	static std::vector<Value> ExtractShapedRecord(xmlNodePtr record, const XMLRecordPlan &plan,
+	                                              const XMLSchemaOptions &options,
+	                                              const std::vector<bool> *skip_columns = nullptr);
+
+	// Vector writers: LIST and STRUCT columns are written straight into the output vector's
+	// ListVector / StructVector children instead of being built as Value trees and copied in by
+	// SetValue. Each writer stores exactly what the matching ExtractSingleRecord* path would return.
+	static bool IsVectorWriteColumn(const LogicalType &type, const std::string &datetime_format);
+	static void WriteColumnWithSchema(xmlNodePtr record, const std::string &column_name,
+	                                  const LogicalType &column_type, const XMLSchemaOptions &options, Vector &result,
+	                                  idx_t row);
+	static void WriteInferredColumn(xmlNodePtr record, const XMLColumnInfo &column, const XMLSchemaOptions &options,
+	                                Vector &result, idx_t row);
 
 	// Identify record elements in a parsed document
 	static std::vector<xmlNodePtr> IdentifyRecordElements(XMLDocRAII &doc, xmlNodePtr root,
@@ -220,6 +283,8 @@ public:
 
 	// Type detection helpers
 	static bool IsBoolean(const std::string &value);
+	// Boolean spelled as read_xml accepts it (true/false, yes/no, 1/0, on/off; case-insensitive)
+	static bool TryParseBoolean(const std::string &value, bool &result);
 	static bool IsInteger(const std::string &value);
 	static bool IsDouble(const std::string &value);
 
@@ -227,6 +292,10 @@ public:
 	static LogicalType ClassifyDatetimeFormat(const std::string &format);
 	static void ValidateDatetimeFormatString(const std::string &format);
 
+	// Compiled strptime form of `format`, shared by ConvertToValue and the typed XPath scalars. Each
+	// distinct format is compiled once per thread; the reference is valid until the thread's next call.
+	static const StrpTimeFormat &GetDatetimeFormat(const std::string &format);
+
 	// Public wrapper for ConvertToValue (used by SAX streaming reader)
 	static Value ConvertToValuePublic(const std::string &text, const LogicalType &target_type,
 	                                  const XMLSchemaOptions &options, const std::string &datetime_format = "");
@@ -260,6 +329,11 @@ public:
 	// VARCHAR so textual data is preserved.
 	static LogicalType MergeXMLColumnType(const LogicalType &a, const LogicalType &b);
 
+	// Vector counterpart of ExtractValueFromNode: writes `node` as a value of `target_type` at `row`
+	// of `result`, STRUCT fields and LIST elements straight into their child vectors (xml_to_struct)
+	static void WriteNodeToVector(xmlNodePtr node, const LogicalType &target_type, const XMLSchemaOptions &options,
+	                              Vector &result, idx_t row);
+
 private:
 	// 3-phase schema inference helpers
 	// Returns columns in first-seen document order so the inferred column order is deterministic.
@@ -298,6 +372,23 @@ private:
 	                                   const XMLSchemaOptions &options);
 	static Value ExtractListFromNode(xmlNodePtr node, const LogicalType &list_type, const XMLSchemaOptions &options);
 	static Value ExtractXMLArrayFromNode(xmlNodePtr node);
+	// Value of a non-LIST element column of an inferred schema from its first matching child
+	// (nullptr when the record has none)
+	static Value ExtractElementColumnValue(xmlNodePtr child, const LogicalType &type,
+	                                       const std::string &datetime_format, const XMLSchemaOptions &options);
+	template <XMLRecordShape SHAPE>
+	static std::vector<Value> ExtractShapedRecordInternal(xmlNodePtr record, const XMLRecordPlan &plan,
+	                                                      const XMLSchemaOptions &options,
+	                                                      const std::vector<bool> *skip_columns);
+
+	// Vector counterpart of ExtractStructFromNode. AppendChildElementsToList writes the element
+	// children of `parent` (only those named `child_name` when given) as the list at `row` and
+	// returns how many it appended.
+	static void WriteStructToVector(xmlNodePtr node, const LogicalType &struct_type, const XMLSchemaOptions &options,
+	                                Vector &result, idx_t row);
+	static idx_t AppendChildElementsToList(xmlNodePtr parent, const std::string *child_name, bool case_insensitive,
+	                                       const LogicalType &element_type, const XMLSchemaOptions &options,
+	                                       Vector &list_vector, idx_t row);
 };
 
 } // namespace duckdb
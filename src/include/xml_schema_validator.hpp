@@ -0,0 +1,88 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "xml_utils.hpp"
+#include "duckdb/common/file_system.hpp"
+#include <libxml/parser.h>
+#include <libxml/xmlschemas.h>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+
+namespace duckdb {
+
+// A compiled XSD schema. libxml2 only reads a schema while validating against it, so one compiled
+// schema can back the validators of every thread.
+using XMLSharedSchemaPtr = std::shared_ptr<xmlSchema>;
+
+// Validates documents against one compiled schema. Documents are streamed through the schema's SAX
+// plug, so no DOM is built; documents with a DOCTYPE, whose entities only a DOM parse records, are
+// validated on a DOM instead. The validation context is reused from document to document, so keep
+// one validator per thread rather than one per row. Not thread-safe.
+class XMLSchemaValidator {
+public:
+	explicit XMLSchemaValidator(XMLSharedSchemaPtr schema);
+	~XMLSchemaValidator();
+	XMLSchemaValidator(const XMLSchemaValidator &) = delete;
+	XMLSchemaValidator &operator=(const XMLSchemaValidator &) = delete;
+
+	// Compile the XSD in `size` bytes at `data`; nullptr when it is not a usable schema. External
+	// resources (xs:import / xs:include) are refused, as for every parse.
+	static XMLSharedSchemaPtr Compile(const char *data, idx_t size);
+
+	// True when the document is well-formed and valid against the schema
+	bool Validate(const string_t &xml_str);
+	// Validate a file as it is read, in fixed-size chunks. Entities declared in a DOCTYPE are not
+	// expanded, as in read_xml's streaming parse.
+	bool ValidateStream(FileHandle &handle);
+	// Validate an already-parsed document
+	bool ValidateDocument(xmlDocPtr doc);
+
+	// Validate the events of a parse the caller drives. Plug returns the handler to parse with (pass
+	// PluggedUserData() as its context): it validates each event, then forwards it to `sax` with
+	// `user_data`. Returns nullptr when the validator cannot be plugged. Unplug once the parse is done.
+	xmlSAXHandlerPtr Plug(xmlSAXHandlerPtr sax, void *user_data);
+	void *PluggedUserData() const {
+		return plugged_user_data;
+	}
+	// False once the plugged parse has broken a rule of the schema
+	bool IsValidSoFar() const;
+	void Unplug();
+
+private:
+	// Streams the chunks `next_chunk` returns (false once there are none left) through the plug.
+	// With `stop_at_doctype`, stops at a DOCTYPE and sets `has_doctype` instead.
+	bool ValidateChunks(const std::function<bool(const char *&data, idx_t &size)> &next_chunk, bool stop_at_doctype,
+	                    bool &has_doctype);
+
+	XMLSharedSchemaPtr schema;
+	XMLSchemaValidPtr valid_ctx;
+	xmlSchemaSAXPlugPtr plug = nullptr;
+	// Written by libxml2 while plugged: xmlSchemaSAXPlug keeps their addresses
+	xmlSAXHandlerPtr plugged_sax = nullptr;
+	void *plugged_user_data = nullptr;
+
+	static constexpr idx_t CHUNK_SIZE = 65536;
+};
+
+// Small per-thread LRU of validators for XSD arguments that vary by row, keyed by the schema text,
+// so a handful of schemas cycling through a column are each compiled once per thread.
+class XMLSchemaCache {
+public:
+	static constexpr idx_t CAPACITY = 4;
+
+	// The validator for the schema in `xsd`, compiling it on a miss. nullptr when the schema does not
+	// compile; that outcome is cached too, so a broken schema is not recompiled for every row.
+	XMLSchemaValidator *Lookup(const string_t &xsd);
+
+private:
+	struct Entry {
+		hash_t hash;
+		std::string xsd;
+		unique_ptr<XMLSchemaValidator> validator;
+	};
+	std::list<Entry> entries; // most recently used first
+};
+
+} // namespace duckdb
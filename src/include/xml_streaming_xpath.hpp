@@ -0,0 +1,84 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <libxml/tree.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// An attribute predicate on a step: `[@name]`, or `[@name='value']` for an exact value
+struct StreamingAttributePredicate {
+	std::string name;
+	bool has_value = false;
+	std::string value;
+};
+
+// One location step of a streaming XPath: an element name test reached through the child ('/') or
+// descendant ('//') axis, with any attribute predicates the element must satisfy
+struct StreamingXPathStep {
+	bool descendant = false;
+	std::string name; // local name of a no-namespace element, or "*" for any element
+	std::vector<StreamingAttributePredicate> predicates;
+};
+
+// What a streaming XPath selects below its last element step
+enum class StreamingXPathTarget {
+	ELEMENT,   // the element itself
+	ATTRIBUTE, // its attribute `@name` in no namespace, or all of its attributes (`@*`)
+	TEXT       // its text and CDATA children (`text()`)
+};
+
+// An absolute location path simple enough to evaluate from SAX events, without building a DOM:
+// unprefixed element names or `*` joined by '/' and '//', each optionally followed by attribute
+// predicates, and optionally ending in `@name`, `@*` or `text()`. Matches follow XPath 1.0, so an
+// unprefixed name only matches an element (or attribute) in no namespace.
+struct StreamingXPath {
+	static constexpr idx_t MAX_STEPS = 63;
+
+	std::vector<StreamingXPathStep> steps;
+	StreamingXPathTarget target = StreamingXPathTarget::ELEMENT;
+	std::string attribute_name;
+
+	// Parses `xpath` into `result`. False when the expression needs anything else (positional or
+	// other predicates, prefixes, functions, other axes, relative paths, whitespace), in which case
+	// callers evaluate it on a DOM.
+	static bool TryCompile(const std::string &xpath, StreamingXPath &result);
+};
+
+enum class StreamingMatchResult {
+	NO_MATCH,
+	MATCH,
+	// The document declares a DTD, whose entities and default attributes only the DOM parser
+	// applies; evaluate on a DOM instead
+	UNSUPPORTED
+};
+
+class StreamingXPathMatcher {
+public:
+	// Scans `data` for the first node `path` selects in document order and stops parsing there.
+	// With `value`, it also receives the node's string value (the DOM's xmlNodeGetContent), which
+	// may read on to the end of a matched element. A well-formedness error before the match gives
+	// NO_MATCH, as on the DOM path; the rest of the document is never read, so one after it does not.
+	static StreamingMatchResult FindFirst(const StreamingXPath &path, const char *data, idx_t size,
+	                                      std::string *value);
+
+	// Calls `process_node` for every node `path` selects, in document order, once the whole document
+	// has parsed. Only the matched subtrees and their ancestors are built (elements that cannot lead
+	// to a match are not built at all, and others are freed as they close), so memory follows the
+	// size of the matches rather than of the document. Like the DOM path, a document that is not
+	// well-formed yields no matches.
+	static StreamingMatchResult ForEachMatch(const StreamingXPath &path, const char *data, idx_t size,
+	                                         const std::function<void(xmlNodePtr)> &process_node);
+
+	// Documents at least this large are streamed by the xml_extract_* list functions when their
+	// XPath qualifies; smaller ones use the cached DOM. The default of the client's
+	// xml_streaming_xpath_threshold setting, which the functions read when a query starts.
+	static constexpr idx_t DEFAULT_THRESHOLD = 1024 * 1024;
+
+private:
+	static constexpr idx_t CHUNK_SIZE = 65536;
+};
+
+} // namespace duckdb
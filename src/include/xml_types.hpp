@@ -18,8 +18,12 @@ public:
 	static void Register(ExtensionLoader &loader);
 
 private:
+	// Reads the client's xml_validate_casts setting: when set, VARCHAR -> XML casts check that each
+	// value is a well-formed document
+	static unique_ptr<FunctionLocalState> InitVarcharToXMLCastLocalState(CastLocalStateParameters &parameters);
 	static bool XMLToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
 	static bool VarcharToXMLCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
+	static bool VarcharToXMLFragmentCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
 	static bool XMLToJSONCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
 	static bool JSONToXMLCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
 	static bool HTMLToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters);
@@ -4,12 +4,16 @@
 #include <libxml/parser.h>
 #include <libxml/xpath.h>
 #include <libxml/xmlschemas.h>
+#include <list>
 #include <set>
 #include <string>
 #include <vector>
 
 namespace duckdb {
 
+class XMLToJSONWriter;
+struct ExpressionState;
+
 // Schema options for XML to JSON conversion
 struct XMLToJSONOptions {
 	std::vector<std::string> force_list;   // Element names to always convert to arrays
@@ -51,6 +55,8 @@ struct XMLDocRAII {
 	XMLDocRAII() = default;
 	XMLDocRAII(const std::string &xml_str);
 	XMLDocRAII(const std::string &content, bool is_html);
+	// Parses straight from the string's buffer (e.g. a row of a VARCHAR vector) without copying it
+	XMLDocRAII(const string_t &content, bool is_html = false);
 	~XMLDocRAII();
 
 	// Delete copy operations for safety
@@ -70,6 +76,9 @@ struct XMLDocRAII {
 		return resource_error;
 	}
 
+	// Parse `size` bytes at `data` into `doc` and set up `xpath_ctx`; shared by the constructors
+	void Parse(const char *data, idx_t size, bool is_html);
+
 	// Register custom namespace prefix-to-URI mappings for XPath evaluation
 	void RegisterCustomNamespaces(const case_insensitive_map_t<string> &namespaces);
 
@@ -113,12 +122,171 @@ struct XMLDocDeleter {
 	}
 };
 
+struct XMLXPathCompExprDeleter {
+	void operator()(xmlXPathCompExprPtr ptr) const {
+		if (ptr)
+			xmlXPathFreeCompExpr(ptr);
+	}
+};
+
 // Type aliases for DuckDB-style smart pointers
 using XMLSchemaParserPtr = std::unique_ptr<xmlSchemaParserCtxt, XMLSchemaParserDeleter>;
 using XMLSchemaPtr = std::unique_ptr<xmlSchema, XMLSchemaDeleter>;
 using XMLSchemaValidPtr = std::unique_ptr<xmlSchemaValidCtxt, XMLSchemaValidDeleter>;
 using XMLCharPtr = std::unique_ptr<xmlChar, XMLCharDeleter>;
 using XMLDocPtr = std::unique_ptr<xmlDoc, XMLDocDeleter>;
+using XMLCompiledXPathPtr = std::unique_ptr<xmlXPathCompExpr, XMLXPathCompExprDeleter>;
+
+// Small per-thread LRU of compiled XPath expressions, keyed by the expression text. Used by the
+// XPath scalars for non-constant XPath arguments so a handful of distinct expressions cycling
+// through a column are tokenized and compiled once instead of once per row.
+// Not thread-safe: libxml2 caches function lookups inside a compiled expression on first
+// evaluation, so compiled expressions must not be shared between threads.
+class XPathCompileCache {
+public:
+	static constexpr idx_t CAPACITY = 16;
+
+	// Return the compiled form of `xpath`, compiling it on a miss. Returns nullptr when the
+	// expression does not compile (callers then fall back to xmlXPathEvalExpression, which
+	// reports the same failure). The pointer stays valid until the entry is evicted.
+	xmlXPathCompExprPtr Lookup(const std::string &xpath);
+
+private:
+	std::list<std::pair<std::string, XMLCompiledXPathPtr>> entries; // most recently used first
+};
+
+struct XMLDocumentCacheStats {
+	idx_t hits = 0;
+	idx_t misses = 0;
+	idx_t evictions = 0;
+};
+
+// Per-query, per-thread LRU of parsed documents, so a value passed through several XML functions in
+// one query (filters, projections, CASE branches) is parsed once per thread instead of once per call.
+// Keyed by parser, length and content hash; a candidate only hits when its bytes match. Bounded per
+// thread by the client's `xml_document_cache_size` setting (estimated DOM bytes); 0 disables the
+// cache. The caches belong to the client's running query and are freed when it ends.
+// Only for helpers that treat the document and its XPath context as read-only: a namespace-aware
+// helper registers prefixes on the context and must parse its own copy.
+class XMLDocumentCache {
+public:
+	static constexpr idx_t DEFAULT_CAPACITY = 16 * 1024 * 1024;
+
+	// While a Scope lives, Get and Contains on this thread use the cache of the query evaluating
+	// `state`. Outside any scope nothing is cached. Open one for each call of a scalar function.
+	class Scope {
+	public:
+		explicit Scope(ExpressionState &state);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		void *previous_cache;
+		idx_t previous_capacity;
+	};
+
+	// The parsed form of `content`, from this thread's cache or freshly parsed and inserted. A
+	// document that does not fit the budget is parsed into `uncached`, which is returned instead. The
+	// reference is valid until the next Get on this thread.
+	static XMLDocRAII &Get(const string_t &content, bool is_html, XMLDocRAII &uncached);
+	static XMLDocRAII &Get(const std::string &content, bool is_html, XMLDocRAII &uncached);
+	// True when this thread's cache already holds the parsed form of `content`. Neither parses nor
+	// counts a hit or miss; lets callers with a cheaper non-DOM path use a DOM that is already built.
+	static bool Contains(const string_t &content, bool is_html);
+
+	// The per-thread budget the xml_document_cache_size setting gives `context`
+	static idx_t GetCapacity(ClientContext &context);
+	static XMLDocumentCacheStats GetStats();
+	static void ResetStats();
+};
+
+// Serializes matched nodes the way the xml_extract_elements family returns them: a standalone copy
+// of the node (so namespaces declared on ancestors stay declared), literal UTF-8, no XML
+// declaration and no surrounding whitespace. The output buffer is reused from node to node, so keep
+// one serializer for a whole call or chunk rather than one per node. Not thread-safe.
+class XMLNodeSerializer {
+public:
+	XMLNodeSerializer();
+	~XMLNodeSerializer();
+	XMLNodeSerializer(const XMLNodeSerializer &) = delete;
+	XMLNodeSerializer &operator=(const XMLNodeSerializer &) = delete;
+
+	// Serialize `node` into `result`, which points into the serializer's buffer and stays valid until
+	// the next call. Returns false when the node could not be copied or written.
+	bool Serialize(xmlNodePtr node, string_t &result);
+
+private:
+	xmlBufferPtr buffer;
+	xmlOutputBufferPtr output;
+};
+
+// Serializes values the way to_xml does, straight from their vectors: a LIST named `name` as
+// <name_list> holding one <name> per element, a STRUCT as one child element per field, XML values
+// verbatim and anything else as escaped text. No tree is built; only VARCHAR values that are XML
+// documents themselves are parsed, to be embedded as elements. Keep one per chunk. Not thread-safe.
+class XMLValueSerializer {
+public:
+	// Throws InvalidInputException when a STRUCT field name anywhere in `type` is not a valid XML
+	// element name
+	static void ValidateFieldNames(const LogicalType &type);
+
+	// An element name argument read row by row and validated whenever it changes from the row
+	// before; NULL gives the default
+	class ElementName {
+	public:
+		explicit ElementName(std::string default_name_p) : default_name(std::move(default_name_p)) {
+		}
+		const std::string &Read(const UnifiedVectorFormat &names, idx_t row);
+		const std::string &Default() const {
+			return default_name;
+		}
+
+	private:
+		std::string default_name;
+		std::string name;
+		bool checked = false;
+	};
+
+	// Read the first `count` rows of `input`, which must stay alive while they are written
+	void Initialize(Vector &input, idx_t count);
+	bool RowIsValid(idx_t row) const;
+	// Append the to_xml result for a valid `row` with root element `name` to `out`
+	void WriteDocument(idx_t row, const std::string &name, std::string &out);
+	// Append the root element WriteDocument would write, without the XML declaration; a value that is
+	// an XML document is embedded as its root element rather than passed through. For xml_agg's items.
+	void WriteRecord(idx_t row, const std::string &name, std::string &out);
+
+private:
+	enum class ValueKind : uint8_t { XML, JSON, VARCHAR, LIST, STRUCT, OTHER };
+
+	// One vector of the input: its values, and for LIST and STRUCT those of its children
+	struct Column {
+		ValueKind kind;
+		UnifiedVectorFormat format;
+		// A VARCHAR cast of OTHER values, or a flat copy of a dictionary STRUCT
+		unique_ptr<Vector> owned;
+		vector<unique_ptr<Column>> children;
+		vector<std::string> field_names;
+	};
+
+	static ValueKind GetValueKind(const LogicalType &type);
+	static void InitializeColumn(Column &column, Vector &vector, idx_t count);
+	void WriteElement(Column &column, idx_t row, const std::string &name, bool list_name, bool as_text);
+	bool WriteContent(Column &column, idx_t row, const std::string &name, bool as_text);
+	// The root element of a document that is not passed through, for the row at `idx`
+	void WriteRootElement(idx_t idx, const std::string &name);
+	bool WriteJSONContent(const string_t &json);
+	// Write the root element of the document in `text`; false when it does not parse
+	bool WriteEmbeddedDocument(const string_t &text);
+	void WriteText(const string_t &text);
+
+	Column root;
+	std::string *out = nullptr;
+	std::string json_buffer;
+	std::string json_error;
+	XMLNodeSerializer node_serializer;
+};
 
 // Structure to hold extracted XML element information
 struct XMLElement {
@@ -177,20 +345,18 @@ NamespaceConfig ParseNamespacesParam(const Value &param);
 // Returns set of prefix strings (excluding XPath axis names like 'child', 'descendant', etc.)
 std::set<std::string> DetectXPathPrefixes(const std::string &xpath);
 
-// Transform XPath to use local-name() matching for specified prefixes
-// Used when prefixes are undeclared in the document (AUTO mode)
-// Example: //gml:pos -> //*[local-name()='pos' and starts-with(name(),'gml:')]
+// Rewrite name tests that use undeclared prefixes (prefix -> uri) to match nodes in that namespace
+// or nodes named with the literal, undeclared prefix
+// Example: //gml:pos -> //*[(name()='gml:pos' and namespace-uri()='') or
+//                           (local-name()='pos' and namespace-uri()='http://www.opengis.net/gml')]
 std::string TransformXPathForUndeclaredPrefixes(const std::string &xpath,
-                                                const std::set<std::string> &undeclared_prefixes);
+                                                const case_insensitive_map_t<string> &undeclared_prefixes);
 
 // Inject namespace declarations into an XML document's root element
 // Returns modified XML string with xmlns:prefix="uri" declarations added
 std::string InjectNamespaceDeclarations(const std::string &xml_str,
                                         const case_insensitive_map_t<string> &namespaces_to_inject);
 
-// Detect namespace prefixes used in an XML document (scans for prefix:name patterns)
-std::set<std::string> DetectDocumentPrefixes(const std::string &xml_str);
-
 // Get common namespace URI for a well-known prefix (returns empty if not found)
 std::string GetCommonNamespaceURI(const std::string &prefix);
 
@@ -228,79 +394,149 @@ enum class XMLValidity { Valid, Malformed, ResourceError };
 class XMLUtils {
 public:
 	// Validation functions
+	//
+	// Functions taking the document as a `string_t` parse it in place, so scalar functions can hand
+	// over a row of their input vector without first copying it into a std::string. The std::string
+	// overloads are for callers that already own a copy (file readers, rewritten documents); those
+	// that delegate to a string_t overload reject documents above 4 GiB with InvalidInputException.
 	static bool IsValidXML(const std::string &xml_str);
+	static bool IsValidXML(const string_t &xml_str);
 	static bool IsWellFormedXML(const std::string &xml_str);
-	// Like IsValidXML but distinguishes an allocation failure from malformed input.
+	static bool IsWellFormedXML(const string_t &xml_str);
+	// Like IsValidXML but distinguishes an allocation failure from malformed input. These checks
+	// only scan the document, without building a tree (documents with a DOCTYPE are parsed in full).
 	static XMLValidity CheckXML(const std::string &xml_str);
+	static XMLValidity CheckXML(const string_t &xml_str);
+	// CheckXML that also reports the parsed tree's approximate heap footprint (0 unless Valid).
+	static XMLValidity CheckXML(const std::string &xml_str, idx_t &dom_footprint);
+	// Approximate heap bytes held by a parsed document: nodes, attributes, namespace definitions
+	// and text. Interned names are not counted. read_xml divides this by the source size to get the
+	// bytes-to-DOM expansion factor that drives its DOM/SAX engine choice.
+	static idx_t EstimateDOMFootprint(xmlDocPtr doc);
+	// A memory-size setting (e.g. '16MiB') as `context` sees it, so SET SESSION applies to that
+	// client only; `default_bytes` when it cannot be read
+	static idx_t GetMemorySetting(ClientContext &context, const char *name, idx_t default_bytes);
+	// One-off validation that compiles `xsd_schema` for this call only; xml_validate_schema keeps
+	// compiled schemas across rows through XMLSchemaValidator / XMLSchemaCache.
 	static bool ValidateXMLSchema(const std::string &xml_str, const std::string &xsd_schema);
+	static bool ValidateXMLSchema(const string_t &xml_str, const std::string &xsd_schema);
 	// Throw InvalidInputException unless `name` is a usable XML element name. Used to prevent markup
 	// injection through user-controlled names (to_xml's node_name argument and STRUCT field names),
 	// which are otherwise concatenated/emitted into trusted `xml`-typed output unvalidated.
 	static void ValidateXMLElementName(const std::string &name);
 
-	// Extraction functions
-	static std::vector<XMLElement> ExtractByXPath(const std::string &xml_str, const std::string &xpath);
+	// Extraction functions. The `compiled` arguments take an expression precompiled from `xpath`
+	// (see CompileXPath / XPathCompileCache); when null, `xpath` is compiled during evaluation.
+	// The XMLDocRAII overloads evaluate against an already-parsed document, so several paths can
+	// share one parse.
+	static std::vector<XMLElement> ExtractByXPath(const std::string &xml_str, const std::string &xpath,
+	                                              xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<XMLElement> ExtractByXPath(const string_t &xml_str, const std::string &xpath,
+	                                              xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<XMLElement> ExtractByXPath(XMLDocRAII &xml_doc, const std::string &xpath,
+	                                              xmlXPathCompExprPtr compiled = nullptr);
 	static std::vector<XMLElement> ExtractByXPath(const std::string &xml_str, const std::string &xpath,
 	                                              const case_insensitive_map_t<string> &namespaces);
 	static std::vector<XMLElement> ExtractByXPath(const std::string &xml_str, const std::string &xpath,
 	                                              const NamespaceConfig &ns_config);
+	static std::vector<XMLElement> ExtractByXPath(const string_t &xml_str, const std::string &xpath,
+	                                              const NamespaceConfig &ns_config);
 	static std::string ExtractTextByXPath(const std::string &xml_str, const std::string &xpath);
+	static std::string ExtractTextByXPath(const string_t &xml_str, const std::string &xpath);
 	static std::string ExtractTextByXPath(const std::string &xml_str, const std::string &xpath,
 	                                      const case_insensitive_map_t<string> &namespaces);
-	static std::vector<std::string> ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath);
+	static std::vector<std::string> ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath,
+	                                                      xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<std::string> ExtractAllTextByXPath(const string_t &xml_str, const std::string &xpath,
+	                                                      xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<std::string> ExtractAllTextByXPath(XMLDocRAII &xml_doc, const std::string &xpath,
+	                                                      xmlXPathCompExprPtr compiled = nullptr);
 	static std::vector<std::string> ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath,
 	                                                      const case_insensitive_map_t<string> &namespaces);
 	static std::vector<std::string> ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath,
 	                                                      const NamespaceConfig &ns_config);
+	static std::vector<std::string> ExtractAllTextByXPath(const string_t &xml_str, const std::string &xpath,
+	                                                      const NamespaceConfig &ns_config);
 	static std::vector<XMLComment> ExtractComments(const std::string &xml_str);
+	static std::vector<XMLComment> ExtractComments(const string_t &xml_str);
 	static std::vector<XMLComment> ExtractCData(const std::string &xml_str);
+	static std::vector<XMLComment> ExtractCData(const string_t &xml_str);
 	static std::vector<XMLNamespace> ExtractNamespaces(const std::string &xml_str);
+	static std::vector<XMLNamespace> ExtractNamespaces(const string_t &xml_str);
 
 	// Content manipulation
 	static std::string PrettyPrintXML(const std::string &xml_str);
+	static std::string PrettyPrintXML(const string_t &xml_str);
 	static std::string MinifyXML(const std::string &xml_str);
+	static std::string MinifyXML(const string_t &xml_str);
 
 	// Analysis functions
 	static XMLStats GetXMLStats(const std::string &xml_str);
+	static XMLStats GetXMLStats(const string_t &xml_str);
 
 	// Conversion functions
 	static std::string XMLToJSON(const std::string &xml_str);
+	static std::string XMLToJSON(const string_t &xml_str);
 	static std::string XMLToJSON(const std::string &xml_str, const XMLToJSONOptions &options);
+	static std::string XMLToJSON(const string_t &xml_str, const XMLToJSONOptions &options);
+	// Converts through `writer`, whose buffers are reused from call to call; the result is valid
+	// until the writer's next use
+	static const std::string &XMLToJSON(const string_t &xml_str, XMLToJSONWriter &writer);
 	static std::string JSONToXML(const std::string &json_str);
-	static std::string ScalarToXML(const std::string &value, const std::string &node_name);
+	// Converts into `out`, whose buffer is reused from call to call. False, with the reason in
+	// `error`, when the input is not JSON or one of its keys is not a usable XML name.
+	static bool TryJSONToXML(const string_t &json_str, std::string &out, std::string &error);
+	// Appends `size` bytes at `data` escaped as libxml2 serializes element text or, with
+	// `attribute`, attribute values
+	static void AppendXMLEscaped(std::string &out, const char *data, idx_t size, bool attribute);
 
 	// XMLFragment extraction
 	static std::string ExtractXMLFragment(const std::string &xml_str, const std::string &xpath);
+	static std::string ExtractXMLFragment(const string_t &xml_str, const std::string &xpath);
 	static std::string ExtractXMLFragment(const std::string &xml_str, const std::string &xpath,
 	                                      const case_insensitive_map_t<string> &namespaces);
 	static std::string ExtractXMLFragment(const std::string &xml_str, const std::string &xpath,
 	                                      const NamespaceConfig &ns_config);
-	static std::string ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath);
+	static std::string ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
+	                                         xmlXPathCompExprPtr compiled = nullptr);
+	static std::string ExtractXMLFragmentAll(const string_t &xml_str, const std::string &xpath,
+	                                         xmlXPathCompExprPtr compiled = nullptr);
+	static std::string ExtractXMLFragmentAll(XMLDocRAII &xml_doc, const std::string &xpath,
+	                                         xmlXPathCompExprPtr compiled = nullptr);
 	static std::string ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
 	                                         const case_insensitive_map_t<string> &namespaces);
 	static std::string ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
 	                                         const NamespaceConfig &ns_config);
-	static std::vector<std::string> ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath);
+	static std::string ExtractXMLFragmentAll(const string_t &xml_str, const std::string &xpath,
+	                                         const NamespaceConfig &ns_config);
+	static std::vector<std::string> ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
+	                                                       xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<std::string> ExtractXMLFragmentList(const string_t &xml_str, const std::string &xpath,
+	                                                       xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<std::string> ExtractXMLFragmentList(XMLDocRAII &xml_doc, const std::string &xpath,
+	                                                       xmlXPathCompExprPtr compiled = nullptr);
 	static std::vector<std::string> ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
 	                                                       const case_insensitive_map_t<string> &namespaces);
 	static std::vector<std::string> ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
 	                                                       const NamespaceConfig &ns_config);
-
-	// Complex type conversion functions for to_xml()
-	static void ConvertListToXML(Vector &input_vector, Vector &result, idx_t count, const std::string &node_name);
-	static void ConvertStructToXML(Vector &input_vector, Vector &result, idx_t count, const std::string &node_name);
-
-	// Recursive value conversion for nested types - returns xmlNodePtr for direct attachment
-	static xmlNodePtr ConvertValueToXMLNode(const Value &value, const LogicalType &type, const std::string &node_name,
-	                                        xmlDocPtr doc);
+	static std::vector<std::string> ExtractXMLFragmentList(const string_t &xml_str, const std::string &xpath,
+	                                                       const NamespaceConfig &ns_config);
 
 	// HTML-specific extraction functions
 	static std::vector<HTMLLink> ExtractHTMLLinks(const std::string &html_str);
+	static std::vector<HTMLLink> ExtractHTMLLinks(const string_t &html_str);
 	static std::vector<HTMLImage> ExtractHTMLImages(const std::string &html_str);
+	static std::vector<HTMLImage> ExtractHTMLImages(const string_t &html_str);
 	static std::vector<HTMLTable> ExtractHTMLTables(const std::string &html_str);
+	static std::vector<HTMLTable> ExtractHTMLTables(const string_t &html_str);
 	static std::string ExtractHTMLText(const std::string &html_str, const std::string &selector = "");
+	static std::string ExtractHTMLText(const string_t &html_str, const std::string &selector = "");
 	static std::string ExtractHTMLTextByXPath(const std::string &html_str, const std::string &xpath);
-	static std::vector<std::string> ExtractHTMLAllTextByXPath(const std::string &html_str, const std::string &xpath);
+	static std::string ExtractHTMLTextByXPath(const string_t &html_str, const std::string &xpath);
+	static std::vector<std::string> ExtractHTMLAllTextByXPath(const std::string &html_str, const std::string &xpath,
+	                                                          xmlXPathCompExprPtr compiled = nullptr);
+	static std::vector<std::string> ExtractHTMLAllTextByXPath(const string_t &html_str, const std::string &xpath,
+	                                                          xmlXPathCompExprPtr compiled = nullptr);
 	// NOTE: Namespace overloads intentionally omitted - HTML5 parsing doesn't support
 	// XML namespace declarations. Prefixed elements are treated as literal names.
 
@@ -308,6 +544,13 @@ public:
 	static std::string HTMLUnescape(const std::string &html_str);
 	static std::string HTMLEscape(const std::string &text);
 
+	// XPath compilation. CompileXPath returns nullptr for an expression that does not compile;
+	// compile errors are not reported to stderr. EvaluateXPath runs `compiled` when present and
+	// otherwise evaluates `xpath` directly.
+	static XMLCompiledXPathPtr CompileXPath(const std::string &xpath);
+	static xmlXPathObjectPtr EvaluateXPath(const std::string &xpath, xmlXPathContextPtr xpath_ctx,
+	                                       xmlXPathCompExprPtr compiled);
+
 	// Internal helper functions
 	static XMLElement ProcessXMLNode(xmlNodePtr node);
 	static std::string GetNodePath(xmlNodePtr node);
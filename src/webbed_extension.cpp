@@ -3,6 +3,8 @@
 #include "webbed_extension.hpp"
 #include "xml_types.hpp"
 #include "xml_scalar_functions.hpp"
+#include "xml_aggregate_functions.hpp"
+#include "xml_extract_fusion.hpp"
 #include "xml_reader_functions.hpp"
 #include "xml_utils.hpp"
 #include "duck_block_functions.hpp"
@@ -12,6 +14,12 @@
 
 namespace duckdb {
 
+// Memory-size settings are read from each client's context when a query runs; setting one only
+// checks that the value parses
+static void CheckMemorySetting(ClientContext &context, SetScope scope, Value &parameter) {
+	DBConfig::ParseMemoryLimit(parameter.ToString());
+}
+
 static void LoadInternal(ExtensionLoader &loader) {
 	// JSON extension is automatically available as a dependency
 
@@ -24,6 +32,9 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register scalar functions
 	XMLScalarFunctions::Register(loader);
 
+	// Register aggregate functions
+	XMLAggregateFunctions::Register(loader);
+
 	// Register table functions
 	XMLReaderFunctions::Register(loader);
 
@@ -33,6 +44,27 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register replacement scan for direct file querying (FROM 'file.xml')
 	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
 	config.replacement_scans.emplace_back(XMLReaderFunctions::ReadXMLReplacement);
+
+	// Per-thread byte budget of the parsed-document cache shared by the XPath helpers
+	config.AddExtensionOption("xml_document_cache_size",
+	                          "Per-thread memory budget for caching parsed XML/HTML documents across function calls "
+	                          "on the same value within a query (e.g. '16MiB'; 0 disables)",
+	                          LogicalType::VARCHAR, Value("16MiB"), CheckMemorySetting);
+
+	// Size from which xml_extract_text/elements/attributes stream simple paths instead of parsing a DOM
+	config.AddExtensionOption("xml_streaming_xpath_threshold",
+	                          "Document size from which XPath list extractors evaluate simple paths while streaming "
+	                          "instead of building a DOM (e.g. '1MiB'; 0 streams every qualifying document)",
+	                          LogicalType::VARCHAR, Value("1MiB"), CheckMemorySetting);
+
+	// Opt-in well-formedness check on VARCHAR -> XML casts
+	config.AddExtensionOption("xml_validate_casts",
+	                          "Check that strings cast to XML are well-formed documents; one that is not raises an "
+	                          "error (NULL under TRY_CAST)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+
+	// Fuse XPath scalars over the same input into one parse per row
+	config.optimizer_extensions.push_back(XMLExtractFusionOptimizer::GetExtension());
 }
 
 void WebbedExtension::Load(ExtensionLoader &loader) {
@@ -0,0 +1,217 @@
+#include "xml_aggregate_functions.hpp"
+#include "xml_types.hpp"
+#include "xml_utils.hpp"
+#include "duckdb_compat.hpp"
+#include "duckdb/function/aggregate_function.hpp"
+#include "duckdb/planner/expression.hpp"
+
+#include <cstring>
+#include <iterator>
+
+namespace duckdb {
+
+namespace {
+
+const char XML_AGG_DECLARATION[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+const char XML_AGG_DEFAULT_ROOT[] = "root";
+const char XML_AGG_DEFAULT_ITEM[] = "item";
+
+// The serialized items of one group. Items are appended to chunks of about CHUNK_SIZE bytes, so the
+// chunks already filled are not copied as the document grows, and a destructive combine only moves
+// them. Text is still copied when a chunk outgrows its reservation (the first one starts empty) and
+// when a window combine must keep its source.
+struct XMLAggBuffer {
+	static constexpr idx_t CHUNK_SIZE = 1 << 20;
+
+	std::string root_name;
+	vector<std::string> chunks;
+
+	// The chunk to append the next item to. The first chunk grows with the group, so small groups
+	// stay small; later ones are allocated at full size up front.
+	std::string &Append() {
+		if (chunks.empty() || chunks.back().size() >= CHUNK_SIZE) {
+			bool first = chunks.empty();
+			chunks.emplace_back();
+			if (!first) {
+				chunks.back().reserve(CHUNK_SIZE);
+			}
+		}
+		return chunks.back();
+	}
+
+	void CheckRootName(const std::string &name) const {
+		if (name != root_name) {
+			throw InvalidInputException(
+			    "xml_agg: root_name must be the same for every row of a group, got '%s' and '%s'", root_name, name);
+		}
+	}
+};
+
+struct XMLAggState {
+	XMLAggBuffer *buffer;
+};
+
+struct XMLAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.buffer = nullptr;
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+		delete state.buffer;
+		state.buffer = nullptr;
+	}
+};
+
+} // namespace
+
+static void XMLAggUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count, Vector &state_vector,
+                         idx_t count) {
+	auto &values = inputs[0];
+	XMLValueSerializer serializer;
+	serializer.Initialize(values, count);
+
+	UnifiedVectorFormat root_names;
+	UnifiedVectorFormat item_names;
+	if (input_count > 1) {
+		CompatToUnifiedFormat(inputs[1], count, root_names);
+	}
+	if (input_count > 2) {
+		CompatToUnifiedFormat(inputs[2], count, item_names);
+	}
+	XMLValueSerializer::ElementName root_name(XML_AGG_DEFAULT_ROOT);
+	XMLValueSerializer::ElementName item_name(XML_AGG_DEFAULT_ITEM);
+
+	UnifiedVectorFormat states_data;
+	CompatToUnifiedFormat(state_vector, count, states_data);
+	auto states = UnifiedVectorFormat::GetData<XMLAggState *>(states_data);
+
+	for (idx_t i = 0; i < count; i++) {
+		// NULL values add no item
+		if (!serializer.RowIsValid(i)) {
+			continue;
+		}
+		auto &state = *states[states_data.sel->get_index(i)];
+		auto &root = input_count > 1 ? root_name.Read(root_names, i) : root_name.Default();
+		auto &item = input_count > 2 ? item_name.Read(item_names, i) : item_name.Default();
+		if (!state.buffer) {
+			state.buffer = new XMLAggBuffer();
+			state.buffer->root_name = root;
+		} else {
+			state.buffer->CheckRootName(root);
+		}
+		serializer.WriteRecord(i, item, state.buffer->Append());
+	}
+}
+
+static void XMLAggCombine(Vector &source_vector, Vector &target_vector, AggregateInputData &aggr_input_data,
+                          idx_t count) {
+	UnifiedVectorFormat sources_data;
+	CompatToUnifiedFormat(source_vector, count, sources_data);
+	auto sources = UnifiedVectorFormat::GetData<XMLAggState *>(sources_data);
+	auto targets = FlatVector::GetData<XMLAggState *>(target_vector);
+
+	// Window aggregates combine the same source into several targets, so its chunks may only be
+	// moved when the caller allows it
+	bool destructive = aggr_input_data.combine_type == AggregateCombineType::ALLOW_DESTRUCTIVE;
+	for (idx_t i = 0; i < count; i++) {
+		auto &source = *sources[sources_data.sel->get_index(i)];
+		auto &target = *targets[i];
+		if (!source.buffer) {
+			continue;
+		}
+		if (!target.buffer) {
+			if (destructive) {
+				target.buffer = source.buffer;
+				source.buffer = nullptr;
+			} else {
+				target.buffer = new XMLAggBuffer(*source.buffer);
+			}
+			continue;
+		}
+		target.buffer->CheckRootName(source.buffer->root_name);
+		auto &chunks = source.buffer->chunks;
+		if (destructive) {
+			target.buffer->chunks.insert(target.buffer->chunks.end(), std::make_move_iterator(chunks.begin()),
+			                             std::make_move_iterator(chunks.end()));
+			chunks.clear();
+		} else {
+			target.buffer->chunks.insert(target.buffer->chunks.end(), chunks.begin(), chunks.end());
+		}
+	}
+}
+
+static void XMLAggFinalize(Vector &state_vector, AggregateInputData &aggr_input_data, Vector &result, idx_t count,
+                           idx_t offset) {
+	UnifiedVectorFormat states_data;
+	CompatToUnifiedFormat(state_vector, count, states_data);
+	auto states = UnifiedVectorFormat::GetData<XMLAggState *>(states_data);
+	auto result_data = FlatVector::GetData<string_t>(result);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto &state = *states[states_data.sel->get_index(i)];
+		auto rid = i + offset;
+		// Like string_agg, a group without any non-NULL value gives NULL
+		if (!state.buffer) {
+			FlatVector::SetNull(result, rid, true);
+			continue;
+		}
+		auto &buffer = *state.buffer;
+		auto &root = buffer.root_name;
+
+		// The document is written once, straight into the result
+		idx_t size = sizeof(XML_AGG_DECLARATION) - 1 + root.size() * 2 + 6;
+		for (auto &chunk : buffer.chunks) {
+			size += chunk.size();
+		}
+		auto document = StringVector::EmptyString(result, size);
+		auto ptr = document.GetDataWriteable();
+		auto write = [&ptr](const char *data, idx_t length) {
+			memcpy(ptr, data, length);
+			ptr += length;
+		};
+		write(XML_AGG_DECLARATION, sizeof(XML_AGG_DECLARATION) - 1);
+		write("<", 1);
+		write(root.data(), root.size());
+		write(">", 1);
+		for (auto &chunk : buffer.chunks) {
+			write(chunk.data(), chunk.size());
+		}
+		write("</", 2);
+		write(root.data(), root.size());
+		write(">\n", 2);
+		document.Finalize();
+		result_data[rid] = document;
+	}
+}
+
+// STRUCT field names become element names; reject any that would inject markup once, before any
+// row is aggregated, as to_xml does
+static unique_ptr<FunctionData> XMLAggBind(ClientContext &context, AggregateFunction &function,
+                                           vector<unique_ptr<Expression>> &arguments) {
+	if (arguments[0]->HasParameter()) {
+		throw ParameterNotResolvedException();
+	}
+	XMLValueSerializer::ValidateFieldNames(arguments[0]->return_type);
+	return nullptr;
+}
+
+static AggregateFunction GetXMLAggFunction(const vector<LogicalType> &arguments) {
+	return AggregateFunction("xml_agg", arguments, XMLTypes::XMLType(), AggregateFunction::StateSize<XMLAggState>,
+	                         AggregateFunction::StateInitialize<XMLAggState, XMLAggFunction>, XMLAggUpdate,
+	                         XMLAggCombine, XMLAggFinalize, FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr,
+	                         XMLAggBind, AggregateFunction::StateDestroy<XMLAggState, XMLAggFunction>);
+}
+
+void XMLAggregateFunctions::Register(ExtensionLoader &loader) {
+	// xml_agg(value [, root_name [, item_name]]): one document whose root holds an item per non-NULL row,
+	// in the order of the aggregate's ORDER BY
+	AggregateFunctionSet xml_agg("xml_agg");
+	xml_agg.AddFunction(GetXMLAggFunction({LogicalType::ANY}));
+	xml_agg.AddFunction(GetXMLAggFunction({LogicalType::ANY, LogicalType::VARCHAR}));
+	xml_agg.AddFunction(GetXMLAggFunction({LogicalType::ANY, LogicalType::VARCHAR, LogicalType::VARCHAR}));
+	loader.RegisterFunction(xml_agg);
+}
+
+} // namespace duckdb
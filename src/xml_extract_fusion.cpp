@@ -0,0 +1,273 @@
+#include "xml_extract_fusion.hpp"
+#include "xml_scalar_functions.hpp"
+#include "duckdb_compat.hpp"
+#include "duckdb/function/function_binder.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/column_binding_map.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+
+namespace duckdb {
+
+// Whether `expr` is a fusable XPath call (one of the XPath scalars in its 2-argument form, with a
+// non-NULL constant XPath over a non-constant input); if so, sets the scalar's kind and the XPath.
+static bool GetFusableCall(Expression &expr, XPathExtractKind &kind, string &path) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	auto &name = func_expr.function.name;
+	if (name == "xml_extract_text") {
+		kind = XPathExtractKind::TEXT_LIST;
+	} else if (name == "xml_extract_elements") {
+		kind = XPathExtractKind::ELEMENTS_LIST;
+	} else if (name == "xml_extract_elements_string") {
+		kind = XPathExtractKind::ELEMENTS_STRING;
+	} else if (name == "xml_extract_attributes") {
+		kind = XPathExtractKind::ATTRIBUTES;
+	} else {
+		return false;
+	}
+	if (func_expr.children.size() != 2) {
+		return false;
+	}
+	auto &input = *func_expr.children[0];
+	if (input.IsFoldable() || input.IsVolatile()) {
+		return false;
+	}
+	auto &xpath = *func_expr.children[1];
+	if (xpath.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	auto &xpath_value = xpath.Cast<BoundConstantExpression>().value;
+	if (xpath_value.IsNull()) {
+		return false;
+	}
+	path = xpath_value.ToString();
+	return true;
+}
+
+// Whether `expr` may skip evaluating its children for some rows (CASE, AND / OR, COALESCE, TRY). A
+// call below it must not be fused: the fused column would evaluate it for every row.
+static bool EvaluatesChildrenConditionally(Expression &expr) {
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::BOUND_CASE:
+	case ExpressionClass::BOUND_CONJUNCTION:
+		return true;
+	case ExpressionClass::BOUND_OPERATOR:
+		return expr.GetExpressionType() == ExpressionType::OPERATOR_COALESCE ||
+		       expr.GetExpressionType() == ExpressionType::OPERATOR_TRY;
+	default:
+		return false;
+	}
+}
+
+namespace {
+
+struct FusedCall {
+	XPathExtractKind kind;
+	string path;
+	LogicalType return_type;
+};
+
+// The fusable calls of one projection that share an input expression
+struct FusionGroup {
+	unique_ptr<Expression> input;
+	vector<FusedCall> calls;
+	// Column of the fused STRUCT in the inserted projection
+	idx_t column_index = 0;
+
+	idx_t FindCall(XPathExtractKind kind, const string &path) const {
+		for (idx_t i = 0; i < calls.size(); i++) {
+			if (calls[i].kind == kind && calls[i].path == path) {
+				return i;
+			}
+		}
+		return DConstants::INVALID_INDEX;
+	}
+};
+
+class ExtractFusion {
+public:
+	ExtractFusion(ClientContext &context, Binder &binder) : context(context), binder(binder) {
+	}
+
+	void VisitOperator(unique_ptr<LogicalOperator> &op) {
+		for (auto &child : op->children) {
+			VisitOperator(child);
+		}
+		if (op->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+			FuseProjection(op->Cast<LogicalProjection>());
+		}
+	}
+
+private:
+	ClientContext &context;
+	Binder &binder;
+	vector<FusionGroup> groups;
+	bool only_child_references = true;
+
+	FusionGroup &GetGroup(Expression &input) {
+		for (auto &group : groups) {
+			if (group.input->Equals(input)) {
+				return group;
+			}
+		}
+		groups.emplace_back();
+		groups.back().input = input.Copy();
+		return groups.back();
+	}
+
+	// Collect the fusable calls of an expression tree that are evaluated for every row. A call's own
+	// input is not searched: it moves below the projection as a whole.
+	void CollectCalls(Expression &expr, bool conditional) {
+		XPathExtractKind kind;
+		string path;
+		if (!conditional && GetFusableCall(expr, kind, path)) {
+			auto &group = GetGroup(*expr.Cast<BoundFunctionExpression>().children[0]);
+			if (group.FindCall(kind, path) == DConstants::INVALID_INDEX) {
+				group.calls.push_back(FusedCall {kind, path, expr.return_type});
+			}
+			return;
+		}
+		if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF &&
+		    expr.Cast<BoundColumnRefExpression>().depth > 0) {
+			only_child_references = false;
+		}
+		conditional = conditional || EvaluatesChildrenConditionally(expr);
+		ExpressionIterator::EnumerateChildren(expr, [&](Expression &child) { CollectCalls(child, conditional); });
+	}
+
+	unique_ptr<Expression> ExtractField(FusionGroup &group, idx_t field_idx, const LogicalType &struct_type,
+	                                    idx_t table_index) {
+		vector<unique_ptr<Expression>> arguments;
+		arguments.push_back(
+		    make_uniq<BoundColumnRefExpression>(struct_type, ColumnBinding(table_index, group.column_index)));
+		arguments.push_back(make_uniq<BoundConstantExpression>(Value("xpath_" + std::to_string(field_idx))));
+		ErrorData error;
+		FunctionBinder function_binder(context);
+		auto result =
+		    function_binder.BindScalarFunction(DEFAULT_SCHEMA, "struct_extract", std::move(arguments), error);
+		if (!result) {
+			error.Throw();
+		}
+		return result;
+	}
+
+	// Replace fused calls with a field of their group's column and redirect references to the old child
+	// to the pass-through columns of the inserted projection. A conditional call that matches a fused
+	// one reads the computed field too, since it is evaluated for every row anyway.
+	void RewriteExpression(unique_ptr<Expression> &expr, const column_binding_map_t<idx_t> &child_columns,
+	                       const vector<LogicalType> &struct_types, idx_t table_index) {
+		XPathExtractKind kind;
+		string path;
+		if (GetFusableCall(*expr, kind, path)) {
+			for (idx_t g = 0; g < groups.size(); g++) {
+				auto &group = groups[g];
+				auto &input = *expr->Cast<BoundFunctionExpression>().children[0];
+				if (group.calls.size() < 2 || !group.input->Equals(input)) {
+					continue;
+				}
+				auto field_idx = group.FindCall(kind, path);
+				if (field_idx == DConstants::INVALID_INDEX) {
+					break;
+				}
+				auto field = ExtractField(group, field_idx, struct_types[g], table_index);
+				field->SetAlias(expr->GetAlias());
+				expr = std::move(field);
+				return;
+			}
+		}
+		if (expr->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+			auto &colref = expr->Cast<BoundColumnRefExpression>();
+			auto entry = child_columns.find(colref.binding);
+			D_ASSERT(entry != child_columns.end());
+			colref.binding = ColumnBinding(table_index, entry->second);
+			return;
+		}
+		ExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<Expression> &child) {
+			RewriteExpression(child, child_columns, struct_types, table_index);
+		});
+	}
+
+	void FuseProjection(LogicalProjection &proj) {
+		groups.clear();
+		only_child_references = true;
+		for (auto &expr : proj.expressions) {
+			CollectCalls(*expr, false);
+		}
+		bool has_fusion = false;
+		for (auto &group : groups) {
+			has_fusion = has_fusion || group.calls.size() >= 2;
+		}
+		if (!has_fusion || !only_child_references) {
+			return;
+		}
+
+		// The inserted projection passes every child column through, followed by one fused STRUCT per group
+		auto &child = proj.children[0];
+		child->ResolveOperatorTypes();
+		auto child_bindings = child->GetColumnBindings();
+		column_binding_map_t<idx_t> child_columns;
+		vector<unique_ptr<Expression>> select_list;
+		for (idx_t i = 0; i < child_bindings.size(); i++) {
+			child_columns[child_bindings[i]] = i;
+			select_list.push_back(make_uniq<BoundColumnRefExpression>(child->types[i], child_bindings[i]));
+		}
+
+		vector<LogicalType> struct_types(groups.size());
+		for (idx_t g = 0; g < groups.size(); g++) {
+			auto &group = groups[g];
+			if (group.calls.size() < 2) {
+				continue;
+			}
+			auto fused_data = make_uniq<XPathFusedBindData>();
+			child_list_t<LogicalType> fields;
+			for (idx_t i = 0; i < group.calls.size(); i++) {
+				fused_data->kinds.push_back(group.calls[i].kind);
+				fused_data->paths.push_back(group.calls[i].path);
+				fields.emplace_back(CompatMakeIdentifier("xpath_" + std::to_string(i)), group.calls[i].return_type);
+			}
+			struct_types[g] = LogicalType::STRUCT(std::move(fields));
+
+			auto function = XMLScalarFunctions::GetFusedExtractFunction(group.input->return_type, struct_types[g]);
+			vector<unique_ptr<Expression>> arguments;
+			arguments.push_back(group.input->Copy());
+			group.column_index = select_list.size();
+			select_list.push_back(make_uniq<BoundFunctionExpression>(struct_types[g], std::move(function),
+			                                                         std::move(arguments), std::move(fused_data)));
+		}
+
+		auto table_index = binder.GenerateTableIndex();
+		for (auto &expr : proj.expressions) {
+			RewriteExpression(expr, child_columns, struct_types, table_index);
+		}
+
+		auto fused = make_uniq<LogicalProjection>(table_index, std::move(select_list));
+		if (child->has_estimated_cardinality) {
+			fused->SetEstimatedCardinality(child->estimated_cardinality);
+		}
+		fused->children.push_back(std::move(child));
+		fused->ResolveOperatorTypes();
+		proj.children[0] = std::move(fused);
+	}
+};
+
+} // namespace
+
+OptimizerExtension XMLExtractFusionOptimizer::GetExtension() {
+	OptimizerExtension extension;
+	extension.optimize_function = Optimize;
+	return extension;
+}
+
+void XMLExtractFusionOptimizer::Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	ExtractFusion fusion(input.context, input.optimizer.binder);
+	fusion.VisitOperator(plan);
+}
+
+} // namespace duckdb
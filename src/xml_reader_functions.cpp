@@ -14,6 +14,9 @@
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/common/multi_file/multi_file_reader.hpp"
 #include "duckdb/function/scalar/strftime_format.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
 
 #include <algorithm>
 
@@ -213,6 +216,70 @@ static void MergeInferredColumns(const std::vector<XMLColumnInfo> &inferred_colu
 	}
 }
 
+// How many libxml2 DOMs a scan holds at once: one per file, and at most one per thread. A worker
+// holds a single document at a time (its own or a slice of another's), slice workers share their
+// file's DOM, and a publisher claims every slice of its document before it loads another file.
+static idx_t MaxLiveDocuments(ClientContext &context, idx_t file_count) {
+	auto threads = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	return MaxValue<idx_t>(1, MinValue<idx_t>(threads, file_count));
+}
+
+// Memory budget for one DOM. libxml2 allocates outside DuckDB's buffer manager, so memory_limit is
+// treated as the total and split across the documents that can be alive at the same time.
+static idx_t ComputeDOMMemoryBudget(ClientContext &context, idx_t file_count) {
+	return BufferManager::GetBufferManager(context).GetMaxMemory() / MaxLiveDocuments(context, file_count);
+}
+
+static idx_t EstimateDOMBytes(const XMLReadFunctionData &bind_data, idx_t file_size) {
+	return static_cast<idx_t>(static_cast<double>(file_size) * bind_data.dom_expansion_factor);
+}
+
+// Whether a file above the per-document budget that cannot stream (HTML, XPath record_element,
+// ...) may still be parsed, over its share: its estimated DOM fits memory_limit as a whole. An
+// explicit maximum_file_size is a hard limit.
+static bool FitsMemoryLimit(const XMLReadFunctionData &bind_data, idx_t file_size, idx_t memory_limit) {
+	return !bind_data.has_explicit_max_file_size && EstimateDOMBytes(bind_data, file_size) <= memory_limit;
+}
+
+// Whether a file is too large to load as a DOM: above an explicit maximum_file_size, or (by
+// default) when its estimated DOM footprint exceeds the per-document budget. Callers stream such
+// files through SAX when the schema allows it and reject them otherwise.
+static bool ExceedsDOMLimit(const XMLReadFunctionData &bind_data, idx_t file_size, idx_t dom_budget) {
+	if (bind_data.has_explicit_max_file_size) {
+		return file_size > bind_data.max_file_size;
+	}
+	return EstimateDOMBytes(bind_data, file_size) > dom_budget;
+}
+
+// read_xml/read_html: allow a worker per thread even for fewer files, so the workers without a file
+// of their own can extract slices of a large shared DOM (see XMLReadGlobalState::ClaimNextWork).
+static void EnableSharedDOMExtraction(ClientContext &context, XMLReadGlobalState &gstate) {
+	gstate.max_workers = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
+[[noreturn]] static void ThrowDOMLimitExceeded(const XMLReadFunctionData &bind_data, const string &file_path,
+                                               idx_t file_size, idx_t memory_limit) {
+	if (bind_data.has_explicit_max_file_size) {
+		throw InvalidInputException("File %s exceeds maximum size limit (%llu bytes)", file_path,
+		                            bind_data.max_file_size);
+	}
+	throw InvalidInputException("File %s exceeds maximum size limit: its DOM needs an estimated %llu bytes but "
+	                            "memory_limit is %llu bytes. Use streaming with a simple record_element, or raise "
+	                            "memory_limit",
+	                            file_path, EstimateDOMBytes(bind_data, file_size), memory_limit);
+}
+
+// Fold one sampled file's DOM footprint into the bind-time expansion factor. The first
+// measurement replaces the default; later samples keep the largest (most conservative) ratio.
+static void RecordDOMExpansion(XMLReadFunctionData &bind_data, idx_t source_bytes, idx_t dom_bytes, bool &measured) {
+	if (source_bytes == 0 || dom_bytes == 0) {
+		return;
+	}
+	double factor = MaxValue<double>(1.0, static_cast<double>(dom_bytes) / static_cast<double>(source_bytes));
+	bind_data.dom_expansion_factor = measured ? MaxValue<double>(bind_data.dom_expansion_factor, factor) : factor;
+	measured = true;
+}
+
 // =============================================================================
 // Internal Unified Functions (used by both XML and HTML)
 // =============================================================================
@@ -314,6 +381,15 @@ unique_ptr<GlobalTableFunctionState> XMLReaderFunctions::ReadDocumentInit(Client
 
 	// Shared work list only; per-file cursor state lives in each worker's local state.
 	result->files = bind_data.files;
+	result->dom_memory_budget = ComputeDOMMemoryBudget(context, result->files.size());
+	result->memory_limit = BufferManager::GetBufferManager(context).GetMaxMemory();
+	if (bind_data.has_explicit_schema) {
+		result->record_plan =
+		    XMLSchemaInference::PlanRecordShape(bind_data.column_names, bind_data.column_types,
+		                                        bind_data.column_datetime_formats, bind_data.schema_options);
+	} else if (!bind_data.inferred_schema.empty()) {
+		result->record_plan = XMLSchemaInference::PlanRecordShape(bind_data.inferred_schema, bind_data.schema_options);
+	}
 
 	return std::move(result);
 }
@@ -333,6 +409,38 @@ OperatorPartitionData XMLReaderFunctions::ReadDocumentGetPartitionData(ClientCon
 	return OperatorPartitionData(lstate.last_batch_index);
 }
 
+InsertionOrderPreservingMap<string> XMLReaderFunctions::ReadDocumentToString(TableFunctionDynamicToStringInput &input) {
+	InsertionOrderPreservingMap<string> result;
+	if (!input.global_state) {
+		return result;
+	}
+	auto &gstate = input.global_state->Cast<XMLReadGlobalState>();
+	auto &bind_data = input.bind_data->Cast<XMLReadFunctionData>();
+	result["DOM Files"] = to_string(gstate.dom_files.load());
+	result["SAX Files"] = to_string(gstate.sax_files.load());
+	if (bind_data.xsd_schema) {
+		result["XSD Invalid Files"] = to_string(gstate.xsd_invalid_files.load());
+	}
+	if (bind_data.has_explicit_max_file_size) {
+		result["DOM Limit"] = StringUtil::BytesToHumanReadableString(bind_data.max_file_size) + " (maximum_file_size)";
+	} else {
+		result["DOM Limit"] = StringUtil::BytesToHumanReadableString(gstate.dom_memory_budget) + " per document";
+		result["DOM Expansion Factor"] = StringUtil::Format("%.1fx", bind_data.dom_expansion_factor);
+	}
+	switch (gstate.record_plan.shape) {
+	case XMLRecordShape::ATTRIBUTES_ONLY:
+		result["Record Shape"] = "attributes only";
+		break;
+	case XMLRecordShape::FLAT:
+		result["Record Shape"] = "flat";
+		break;
+	default:
+		result["Record Shape"] = "generic";
+		break;
+	}
+	return result;
+}
+
 unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &context, TableFunctionBindInput &input,
                                                               vector<LogicalType> &return_types, vector<string> &names,
                                                               ParseMode mode) {
@@ -412,6 +520,7 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &con
 			result->schema_sample_files = kv.second.GetValue<int64_t>();
 		} else if (kv.first == "maximum_file_size") {
 			result->max_file_size = kv.second.GetValue<idx_t>();
+			result->has_explicit_max_file_size = true;
 			schema_options.maximum_file_size = result->max_file_size;
 		} else if (kv.first == "root_element") {
 			schema_options.root_element = kv.second.ToString();
@@ -601,16 +710,22 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &con
 			std::unordered_map<std::string, std::string> union_formats; // Per-column winning datetime format
 			std::vector<std::string> column_order;                      // Track order of first appearance
 
+			// DOM/SAX decisions here use the default expansion factor until the first sample is measured.
+			// Samples are parsed one at a time, so one that cannot stream only has to fit memory_limit.
+			idx_t dom_budget = ComputeDOMMemoryBudget(context, result->files.size());
+			idx_t memory_limit = BufferManager::GetBufferManager(context).GetMaxMemory();
+			bool measured_expansion = false;
+
 			// Scan each file for schema
 			for (const auto &file_path : files_to_scan) {
 				try {
 					auto file_handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
 					auto file_size = fs.GetFileSize(*file_handle);
+					bool exceeds_dom_limit = ExceedsDOMLimit(*result, static_cast<idx_t>(file_size), dom_budget);
 
 					// Determine if SAX inference should be used
 					bool use_sax_inference = false;
-					if (schema_options.streaming && mode == ParseMode::XML &&
-					    static_cast<idx_t>(file_size) > result->max_file_size) {
+					if (schema_options.streaming && mode == ParseMode::XML && exceeds_dom_limit) {
 						if (!HasComplexXPath(schema_options.record_element)) {
 							use_sax_inference = true;
 						}
@@ -622,11 +737,11 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &con
 						// SAX-based schema inference (no DOM needed)
 						inferred_columns = SAXStreamReader::InferSchemaFromStream(fs, file_path, schema_options);
 					} else {
-						// DOM-based: enforce file size limit
-						if (static_cast<idx_t>(file_size) > result->max_file_size) {
+						// DOM-based: enforce the DOM size limit
+						if (exceeds_dom_limit &&
+						    !FitsMemoryLimit(*result, static_cast<idx_t>(file_size), memory_limit)) {
 							if (!result->ignore_errors) {
-								throw InvalidInputException("File %s exceeds maximum size limit (%llu bytes)",
-								                            file_path, result->max_file_size);
+								ThrowDOMLimitExceeded(*result, file_path, static_cast<idx_t>(file_size), memory_limit);
 							}
 							continue;
 						}
@@ -636,7 +751,8 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &con
 						ReadFileFully(*file_handle, (char *)content.data(), file_size);
 
 						if (mode == ParseMode::XML) {
-							auto validity = XMLUtils::CheckXML(content);
+							idx_t dom_footprint = 0;
+							auto validity = XMLUtils::CheckXML(content, dom_footprint);
 							if (validity == XMLValidity::ResourceError) {
 								ThrowLibxmlOutOfMemory(file_path);
 							}
@@ -646,6 +762,14 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadDocumentBind(ClientContext &con
 								}
 								continue;
 							}
+							RecordDOMExpansion(*result, content.size(), dom_footprint, measured_expansion);
+						} else if (!measured_expansion) {
+							// HTML has no validity pre-check to piggyback on; measure the first sample only.
+							XMLDocRAII sample_doc(content, true);
+							if (sample_doc.IsValid()) {
+								RecordDOMExpansion(*result, content.size(), XMLUtils::EstimateDOMFootprint(sample_doc.doc),
+								                   measured_expansion);
+							}
 						}
 
 						inferred_columns = XMLSchemaInference::InferSchema(content, schema_options);
@@ -839,17 +963,25 @@ void XMLReaderFunctions::ReadDocumentObjectsFunction(ClientContext &context, Tab
 	CompatSetOutputCardinality(output, output_idx);
 }
 
-// Write one extracted row into the output chunk: optional filename column first, then the row's
-// values. Any output columns the row does not provide are NULL-filled so no vector slot is left
-// uninitialized (e.g. fallback schemas where extraction yields fewer values).
-static void EmitRow(DataChunk &output, idx_t output_idx, const std::vector<Value> &row, bool include_filename,
-                    const string &filename) {
+// Write one extracted row into the output chunk: optional filename and xsd_valid columns first, then
+// the row's values. Any output columns the row does not provide are NULL-filled so no vector slot is
+// left uninitialized (e.g. fallback schemas where extraction yields fewer values).
+// Columns flagged in `skip_columns` are filled by WriteVectorColumns / FlushBatchCast instead.
+static void EmitRow(DataChunk &output, idx_t output_idx, const std::vector<Value> &row,
+                    const XMLReadFunctionData &bind_data, const string &filename, bool xsd_valid,
+                    const std::vector<bool> *skip_columns = nullptr) {
 	idx_t output_col_idx = 0;
-	if (include_filename) {
+	if (bind_data.include_filename) {
 		output.data[output_col_idx++].SetValue(output_idx, Value(filename));
 	}
+	if (bind_data.xsd_schema && bind_data.on_invalid == XSDInvalidFileAction::FLAG) {
+		output.data[output_col_idx++].SetValue(output_idx, Value::BOOLEAN(xsd_valid));
+	}
 	for (idx_t row_col_idx = 0; row_col_idx < row.size() && output_col_idx < output.ColumnCount();
 	     row_col_idx++, output_col_idx++) {
+		if (skip_columns && (*skip_columns)[row_col_idx]) {
+			continue;
+		}
 		output.data[output_col_idx].SetValue(output_idx, row[row_col_idx]);
 	}
 	for (; output_col_idx < output.ColumnCount(); output_col_idx++) {
@@ -857,6 +989,146 @@ static void EmitRow(DataChunk &output, idx_t output_idx, const std::vector<Value
 	}
 }
 
+// Deferred columns for the DOM path. With a known schema, INTEGER/BIGINT/DOUBLE/DATE columns
+// without a datetime_format are not converted cell by cell: their raw text is staged in VARCHAR
+// vectors (string_t in the vector's string heap) for the whole chunk and converted with one
+// VectorOperations::TryCast per column. LIST and STRUCT columns (known or inferred schema) are
+// written into their ListVector / StructVector children directly rather than through Value trees.
+// Other columns keep the per-cell ConvertToValue path.
+static void InitializeDeferredColumns(ClientContext &context, const XMLReadFunctionData &bind_data,
+                                      XMLReadLocalState &lstate) {
+	if (lstate.deferred_columns_initialized) {
+		return;
+	}
+	lstate.deferred_columns_initialized = true;
+	if (!bind_data.has_explicit_schema) {
+		lstate.deferred_columns.assign(bind_data.inferred_schema.size(), false);
+		for (idx_t col_idx = 0; col_idx < bind_data.inferred_schema.size(); col_idx++) {
+			const auto &column = bind_data.inferred_schema[col_idx];
+			if (XMLSchemaInference::IsVectorWriteColumn(column.type, column.winning_datetime_format)) {
+				lstate.deferred_columns[col_idx] = true;
+				lstate.vector_write_indexes.push_back(col_idx);
+			}
+		}
+		return;
+	}
+	lstate.deferred_columns.assign(bind_data.column_types.size(), false);
+	vector<LogicalType> staging_types;
+	for (idx_t col_idx = 0; col_idx < bind_data.column_types.size(); col_idx++) {
+		const std::string &fmt =
+		    col_idx < bind_data.column_datetime_formats.size() ? bind_data.column_datetime_formats[col_idx] : "";
+		if (XMLSchemaInference::IsBatchCastColumn(bind_data.column_types[col_idx], fmt)) {
+			lstate.deferred_columns[col_idx] = true;
+			lstate.batch_cast_indexes.push_back(col_idx);
+			staging_types.push_back(LogicalType::VARCHAR);
+		} else if (XMLSchemaInference::IsVectorWriteColumn(bind_data.column_types[col_idx], fmt)) {
+			lstate.deferred_columns[col_idx] = true;
+			lstate.vector_write_indexes.push_back(col_idx);
+		}
+	}
+	if (!staging_types.empty()) {
+		lstate.batch_text.Initialize(Allocator::Get(context), staging_types);
+	}
+}
+
+static void WriteVectorColumns(xmlNodePtr record, const XMLReadFunctionData &bind_data,
+                               const XMLReadLocalState &lstate, DataChunk &output, idx_t output_idx) {
+	idx_t column_offset = bind_data.LeadingColumnCount();
+	for (auto col_idx : lstate.vector_write_indexes) {
+		if (col_idx + column_offset >= output.ColumnCount()) {
+			break;
+		}
+		auto &target = output.data[col_idx + column_offset];
+		if (bind_data.has_explicit_schema) {
+			XMLSchemaInference::WriteColumnWithSchema(record, bind_data.column_names[col_idx],
+			                                          bind_data.column_types[col_idx], bind_data.schema_options,
+			                                          target, output_idx);
+		} else {
+			XMLSchemaInference::WriteInferredColumn(record, bind_data.inferred_schema[col_idx],
+			                                        bind_data.schema_options, target, output_idx);
+		}
+	}
+}
+
+static void StageBatchText(xmlNodePtr record, const XMLReadFunctionData &bind_data, XMLReadLocalState &lstate) {
+	idx_t row = lstate.batch_rows++;
+	for (idx_t staged_idx = 0; staged_idx < lstate.batch_cast_indexes.size(); staged_idx++) {
+		auto &text_vector = lstate.batch_text.data[staged_idx];
+		const auto &column_name = bind_data.column_names[lstate.batch_cast_indexes[staged_idx]];
+		if (XMLSchemaInference::ExtractRawColumnText(record, column_name, bind_data.schema_options,
+		                                             lstate.batch_cell)) {
+			FlatVector::GetData<string_t>(text_vector)[row] = StringVector::AddString(text_vector, lstate.batch_cell);
+		} else {
+			FlatVector::SetNull(text_vector, row, true);
+		}
+	}
+}
+
+// Convert the staged text into the output columns. A failed cast (some cell does not parse)
+// re-runs that column through ConvertToValue, so ignore_errors NULLs and the #102 error are
+// exactly those of the per-cell path.
+static void FlushBatchCast(ClientContext &context, const XMLReadFunctionData &bind_data, XMLReadLocalState &lstate,
+                           DataChunk &output) {
+	idx_t count = lstate.batch_rows;
+	if (count == 0) {
+		return;
+	}
+	idx_t column_offset = bind_data.LeadingColumnCount();
+	for (idx_t staged_idx = 0; staged_idx < lstate.batch_cast_indexes.size(); staged_idx++) {
+		auto col_idx = lstate.batch_cast_indexes[staged_idx];
+		auto &text_vector = lstate.batch_text.data[staged_idx];
+		auto &target = output.data[col_idx + column_offset];
+		const auto &target_type = bind_data.column_types[col_idx];
+
+		// Chunks normally start with the batch (one file or slice per chunk); cast in place then.
+		unique_ptr<Vector> converted;
+		if (lstate.batch_start != 0) {
+			converted = make_uniq<Vector>(target_type, count);
+		}
+		Vector &cast_target = converted ? *converted : target;
+		string error_message;
+		bool all_converted = VectorOperations::TryCast(context, text_vector, cast_target, count, &error_message);
+		if (!all_converted && !bind_data.ignore_errors) {
+			auto texts = FlatVector::GetData<string_t>(text_vector);
+			auto &validity = FlatVector::Validity(text_vector);
+			for (idx_t row = 0; row < count; row++) {
+				if (!validity.RowIsValid(row)) {
+					continue;
+				}
+				cast_target.SetValue(row, XMLSchemaInference::ConvertToValuePublic(texts[row].GetString(), target_type,
+				                                                                   bind_data.schema_options));
+			}
+		}
+		if (converted) {
+			VectorOperations::Copy(*converted, target, count, 0, lstate.batch_start);
+		}
+	}
+	lstate.batch_text.Reset();
+	lstate.batch_rows = 0;
+}
+
+[[noreturn]] static void ThrowXSDInvalid(const XMLReadFunctionData &bind_data, const string &filename) {
+	throw InvalidInputException("File %s does not validate against XSD schema %s", filename, bind_data.xsd_path);
+}
+
+// Whether a streamed file needs its XSD verdict before its first row. Only on_invalid := 'error'
+// can validate on the row pass itself; skip_file, flag and 'error' under ignore_errors (which skips
+// an invalid file) decide what to do with a file's rows from its verdict.
+static bool NeedsVerdictFirst(const XMLReadFunctionData &bind_data) {
+	return bind_data.xsd_schema &&
+	       (bind_data.on_invalid != XSDInvalidFileAction::RAISE_ERROR || bind_data.ignore_errors);
+}
+
+// on_invalid := 'error' on a streamed file: the validator plugged into the push parser has seen every
+// event fed so far, so a violation is raised before the records it affects are emitted
+static void CheckStreamedXSD(const XMLReadFunctionData &bind_data, XMLReadGlobalState &gstate,
+                             XMLReadLocalState &lstate, const string &filename) {
+	if (lstate.xsd_plugged && !lstate.xsd_validator->IsValidSoFar()) {
+		gstate.xsd_invalid_files++;
+		ThrowXSDInvalid(bind_data, filename);
+	}
+}
+
 void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 	auto &bind_data = data_p.bind_data->Cast<XMLReadFunctionData>();
 	auto &gstate = data_p.global_state->Cast<XMLReadGlobalState>();
@@ -868,17 +1140,31 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 	const auto &schema_options = bind_data.schema_options;
 
 	while (output_idx < STANDARD_VECTOR_SIZE) {
-		// Ensure this worker owns a file; claim the next one otherwise.
+		// Ensure this worker owns work: a slice of a shared DOM, or the next file.
 		if (!lstate.have_file) {
-			idx_t claimed = gstate.ClaimNextFile();
-			if (claimed == DConstants::INVALID_INDEX) {
+			XMLReadGlobalState::WorkItem work;
+			idx_t min_file_index = lstate.file_index == DConstants::INVALID_INDEX ? 0 : lstate.file_index;
+			if (!gstate.ClaimNextWork(min_file_index, work)) {
 				break; // no more work for this worker
 			}
-			lstate.file_index = claimed;
-			lstate.current_filename = gstate.files[claimed];
-			lstate.chunk_counter = 0;
-			lstate.have_file = true;
-			lstate.file_loaded = false;
+			if (work.document) {
+				// Slice k covers records [k * STANDARD_VECTOR_SIZE, ...) and is chunk k of its file.
+				lstate.shared_doc = std::move(work.document);
+				lstate.file_index = lstate.shared_doc->file_index;
+				lstate.current_filename = lstate.shared_doc->filename;
+				lstate.current_record_index = work.slice * STANDARD_VECTOR_SIZE;
+				lstate.record_end_index = MinValue<idx_t>(lstate.current_record_index + STANDARD_VECTOR_SIZE,
+				                                          lstate.shared_doc->record_elements.size());
+				lstate.chunk_counter = work.slice;
+				lstate.have_file = true;
+				lstate.file_loaded = true;
+			} else {
+				lstate.file_index = work.file_index;
+				lstate.current_filename = gstate.files[work.file_index];
+				lstate.chunk_counter = 0;
+				lstate.have_file = true;
+				lstate.file_loaded = false;
+			}
 		}
 
 		// Per-file value source: the file THIS worker claimed, never the global cursor.
@@ -891,21 +1177,25 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 				auto file_handle = fs.OpenFile(filename, FileFlags::FILE_FLAGS_READ);
 				auto file_size = fs.GetFileSize(*file_handle);
 
-				// Determine whether to use SAX or DOM
-				bool use_sax = false;
-				if (schema_options.streaming && !is_html && static_cast<idx_t>(file_size) > bind_data.max_file_size) {
-					// File exceeds max size — use SAX if possible
-					if (!HasComplexXPath(schema_options.record_element) &&
-					    !SchemaHasUnsupportedSAXType(bind_data.column_types)) {
-						use_sax = true;
-					}
-				}
-
-				// If not using SAX, enforce file size limit
-				if (!use_sax && static_cast<idx_t>(file_size) > bind_data.max_file_size) {
+				// Determine whether to use SAX or DOM: stream when the estimated DOM would not fit
+				// one document's share of memory_limit (or an explicit maximum_file_size).
+				bool exceeds_dom_limit =
+				    ExceedsDOMLimit(bind_data, static_cast<idx_t>(file_size), gstate.dom_memory_budget);
+				bool streamable = schema_options.streaming && !is_html &&
+				                  !HasComplexXPath(schema_options.record_element) &&
+				                  !SchemaHasUnsupportedSAXType(bind_data.column_types);
+				bool use_sax = exceeds_dom_limit && streamable;
+				// A file that must be a DOM but is above its share is admitted over it when it fits
+				// memory_limit as a whole; the scan never waits for other documents to be freed.
+				bool over_share =
+				    !use_sax && exceeds_dom_limit &&
+				    FitsMemoryLimit(bind_data, static_cast<idx_t>(file_size), gstate.memory_limit);
+
+				// If not using SAX, enforce the DOM size limit
+				if (!use_sax && exceeds_dom_limit && !over_share) {
 					if (!bind_data.ignore_errors) {
-						throw InvalidInputException("File %s exceeds maximum size limit (%llu bytes)", filename,
-						                            bind_data.max_file_size);
+						ThrowDOMLimitExceeded(bind_data, filename, static_cast<idx_t>(file_size),
+						                      gstate.memory_limit);
 					}
 					// Skip this file: release and claim the next one without emitting a chunk.
 					lstate.ResetFileResources();
@@ -914,8 +1204,28 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 				}
 
 				lstate.use_sax = use_sax;
+				if (use_sax) {
+					gstate.sax_files++;
+				} else {
+					gstate.dom_files++;
+				}
 
 				if (use_sax) {
+					// A file to skip or flag needs its verdict before the first row, so it is validated
+					// in a streaming pass of its own (no DOM); otherwise the validator rides on the rows.
+					if (NeedsVerdictFirst(bind_data)) {
+						auto validation_handle = fs.OpenFile(filename, FileFlags::FILE_FLAGS_READ);
+						lstate.file_xsd_valid = lstate.GetXSDValidator(bind_data).ValidateStream(*validation_handle);
+						if (!lstate.file_xsd_valid) {
+							gstate.xsd_invalid_files++;
+							if (bind_data.on_invalid != XSDInvalidFileAction::FLAG) {
+								lstate.ResetFileResources();
+								lstate.have_file = false;
+								continue;
+							}
+						}
+					}
+
 					// SAX mode: initialize push parser for incremental streaming
 					lstate.sax_accumulator = make_uniq<SAXRecordAccumulator>();
 					lstate.sax_accumulator->namespace_mode = schema_options.namespaces;
@@ -938,10 +1248,22 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					lstate.sax_ctx->preserve_whitespace = bind_data.schema_options.preserve_whitespace;
 
 					lstate.sax_handler = SAXStreamReader::CreateSAXHandler();
+					xmlSAXHandlerPtr handler = &lstate.sax_handler;
+					void *handler_ctx = lstate.sax_ctx.get();
+					if (bind_data.xsd_schema && !NeedsVerdictFirst(bind_data)) {
+						// Every event is validated, then handed on to the record accumulator
+						auto &validator = lstate.GetXSDValidator(bind_data);
+						handler = validator.Plug(handler, handler_ctx);
+						if (!handler) {
+							throw IOException("Could not set up XSD validation for '%s'", filename);
+						}
+						handler_ctx = validator.PluggedUserData();
+						lstate.xsd_plugged = true;
+					}
 					// Fail-closed entity loader: refuse external DTD/entity fetch during streaming parse.
 					XMLUtils::EnsureSecureParsing();
-					lstate.sax_parser_ctx = xmlCreatePushParserCtxt(&lstate.sax_handler, lstate.sax_ctx.get(), nullptr,
-					                                                0, filename.c_str());
+					lstate.sax_parser_ctx =
+					    xmlCreatePushParserCtxt(handler, handler_ctx, nullptr, 0, filename.c_str());
 					if (!lstate.sax_parser_ctx) {
 						throw IOException("Could not create SAX push parser for '%s'", filename);
 					}
@@ -960,10 +1282,14 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					// Parse DOM — DOM makes its own copy, so content string can be freed.
 					// This single parse is also the validity check: a separate pre-validation
 					// pass would parse the document twice and could not see why a parse failed.
-					lstate.current_doc = XMLDocRAII(content, is_html);
-
-					if (!lstate.current_doc.IsValid()) {
-						if (lstate.current_doc.HadResourceError()) {
+					auto document = make_shared_ptr<SharedXMLDocument>();
+					document->file_index = lstate.file_index;
+					document->filename = filename;
+					document->doc = XMLDocRAII(content, is_html);
+					content = string();
+
+					if (!document->doc.IsValid()) {
+						if (document->doc.HadResourceError()) {
 							ThrowLibxmlOutOfMemory(filename);
 						}
 						if (bind_data.ignore_errors) {
@@ -977,7 +1303,7 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 						throw InvalidInputException("File %s contains invalid XML", filename);
 					}
 
-					xmlNodePtr root = xmlDocGetRootElement(lstate.current_doc.doc);
+					xmlNodePtr root = xmlDocGetRootElement(document->doc.doc);
 					if (!root) {
 						if (bind_data.ignore_errors) {
 							lstate.ResetFileResources();
@@ -987,19 +1313,47 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 						throw InvalidInputException("File %s has no root element", filename);
 					}
 
+					// The tree is already built, so it is validated as it stands
+					if (bind_data.xsd_schema) {
+						document->xsd_valid = lstate.GetXSDValidator(bind_data).ValidateDocument(document->doc.doc);
+						if (!document->xsd_valid) {
+							gstate.xsd_invalid_files++;
+							bool raise = bind_data.on_invalid == XSDInvalidFileAction::RAISE_ERROR;
+							bool skip =
+							    bind_data.on_invalid == XSDInvalidFileAction::SKIP_FILE || (raise && bind_data.ignore_errors);
+							if (skip) {
+								lstate.ResetFileResources();
+								lstate.have_file = false;
+								continue;
+							}
+							if (raise) {
+								ThrowXSDInvalid(bind_data, filename);
+							}
+						}
+					}
+
 					// Find record elements in the DOM
-					lstate.record_elements =
-					    XMLSchemaInference::IdentifyRecordElements(lstate.current_doc, root, schema_options);
+					document->record_elements =
+					    XMLSchemaInference::IdentifyRecordElements(document->doc, root, schema_options);
 
 					// Calculate remaining depth for inferred schema extraction
 					int effective_depth = schema_options.max_depth;
 					if (effective_depth > 20 || effective_depth < 0) {
 						effective_depth = 20;
 					}
-					lstate.remaining_depth = effective_depth - 2;
-
-					lstate.current_record_index = 0;
-					lstate.file_loaded = true;
+					document->remaining_depth = effective_depth - 2;
+					document->shaped_extraction = gstate.record_plan.shape != XMLRecordShape::GENERIC &&
+					                              document->remaining_depth >= 0 &&
+					                              XMLSchemaInference::SupportsShapedExtraction(document->doc.doc);
+					document->slice_count =
+					    (document->record_elements.size() + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+
+					// Hand the records to the slice dispatcher; this worker claims a slice like any
+					// other (an empty document publishes nothing and simply finishes the file).
+					gstate.PublishDocument(std::move(document));
+					lstate.ResetFileResources();
+					lstate.have_file = false;
+					continue;
 				}
 			}
 
@@ -1018,7 +1372,7 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 						    record, bind_data.column_names, bind_data.column_types, schema_options,
 						    bind_data.column_datetime_formats, bind_data.inferred_schema);
 
-						EmitRow(output, output_idx, row, bind_data.include_filename, filename);
+						EmitRow(output, output_idx, row, bind_data, filename, lstate.file_xsd_valid);
 
 						output_idx++;
 						lstate.sax_pending_records.erase(lstate.sax_pending_records.begin());
@@ -1034,6 +1388,7 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					if (bytes_read == 0) {
 						// EOF — finalize parser
 						xmlParseChunk(lstate.sax_parser_ctx, nullptr, 0, 1);
+						CheckStreamedXSD(bind_data, gstate, lstate, filename);
 						file_exhausted = true;
 						break;
 					}
@@ -1043,6 +1398,7 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					if (parse_result != 0 && !bind_data.ignore_errors) {
 						throw IOException("SAX parsing error in file '%s'", filename);
 					}
+					CheckStreamedXSD(bind_data, gstate, lstate, filename);
 				}
 
 				// Emit any remaining pending records after EOF
@@ -1052,7 +1408,7 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					                                             schema_options, bind_data.column_datetime_formats,
 					                                             bind_data.inferred_schema);
 
-					EmitRow(output, output_idx, row, bind_data.include_filename, filename);
+					EmitRow(output, output_idx, row, bind_data, filename, lstate.file_xsd_valid);
 					output_idx++;
 					lstate.sax_pending_records.erase(lstate.sax_pending_records.begin());
 				}
@@ -1062,29 +1418,48 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 					file_done = true;
 				}
 			} else {
-				// DOM extraction: extract records one at a time
-				while (lstate.current_record_index < lstate.record_elements.size() &&
-				       output_idx < STANDARD_VECTOR_SIZE) {
-					xmlNodePtr record = lstate.record_elements[lstate.current_record_index];
+				// DOM extraction: extract this worker's slice one record at a time
+				auto &document = *lstate.shared_doc;
+				InitializeDeferredColumns(context, bind_data, lstate);
+				const bool batch_cast = !lstate.batch_cast_indexes.empty();
+				// A negative remaining_depth yields the whole record as one XML column: nothing to defer
+				const bool vector_write = !lstate.vector_write_indexes.empty() &&
+				                          (bind_data.has_explicit_schema || document.remaining_depth >= 0);
+				const std::vector<bool> *skip_columns =
+				    (batch_cast || vector_write) ? &lstate.deferred_columns : nullptr;
+				lstate.batch_start = output_idx;
+				while (lstate.current_record_index < lstate.record_end_index && output_idx < STANDARD_VECTOR_SIZE) {
+					xmlNodePtr record = document.record_elements[lstate.current_record_index];
 
 					std::vector<Value> row;
-					if (bind_data.has_explicit_schema) {
-						row = XMLSchemaInference::ExtractSingleRecordWithSchema(record, bind_data.column_names,
-						                                                        bind_data.column_types, schema_options,
-						                                                        bind_data.column_datetime_formats);
+					if (document.shaped_extraction) {
+						row = XMLSchemaInference::ExtractShapedRecord(record, gstate.record_plan, schema_options,
+						                                              skip_columns);
+					} else if (bind_data.has_explicit_schema) {
+						row = XMLSchemaInference::ExtractSingleRecordWithSchema(
+						    record, bind_data.column_names, bind_data.column_types, schema_options,
+						    bind_data.column_datetime_formats, skip_columns);
 					} else {
 						row = XMLSchemaInference::ExtractSingleRecord(record, bind_data.inferred_schema,
-						                                              lstate.remaining_depth, schema_options);
+						                                              document.remaining_depth, schema_options,
+						                                              skip_columns);
+					}
+					if (batch_cast) {
+						StageBatchText(record, bind_data, lstate);
 					}
 
-					EmitRow(output, output_idx, row, bind_data.include_filename, filename);
+					EmitRow(output, output_idx, row, bind_data, filename, document.xsd_valid, skip_columns);
+					if (vector_write) {
+						WriteVectorColumns(record, bind_data, lstate, output, output_idx);
+					}
 
 					output_idx++;
 					lstate.current_record_index++;
 				}
+				FlushBatchCast(context, bind_data, lstate, output);
 
-				// Check if we've finished all records from this file
-				if (lstate.current_record_index >= lstate.record_elements.size()) {
+				// Check if we've finished this slice's records
+				if (lstate.current_record_index >= lstate.record_end_index) {
 					file_done = true;
 				}
 			}
@@ -1095,14 +1470,24 @@ void XMLReaderFunctions::ReadDocumentFunction(ClientContext &context, TableFunct
 			if (!bind_data.ignore_errors) {
 				throw;
 			}
-			// Skip the rest of this file and claim the next one.
+			// Skip the rest of this file (including slices no worker has claimed yet) and claim the
+			// next one. Rows already emitted keep this chunk's batch index, so return them first.
+			FlushBatchCast(context, bind_data, lstate, output);
+			if (lstate.shared_doc) {
+				gstate.AbandonDocument(*lstate.shared_doc);
+			}
 			lstate.ResetFileResources();
 			lstate.have_file = false;
+			if (output_idx > 0) {
+				lstate.last_batch_index = (lstate.file_index << XMLReadLocalState::FILE_SHIFT) | lstate.chunk_counter;
+				lstate.chunk_counter++;
+				break;
+			}
 			continue;
 		}
 
 		if (file_done) {
-			// File fully consumed. One file (with rows) per output chunk keeps batch indices
+			// File (or shared-DOM slice) fully consumed. One file (with rows) per output chunk keeps batch indices
 			// ordered, so if we produced rows we tag and return this chunk now; an empty file
 			// produced nothing, so keep claiming rather than returning a spurious 0-row chunk
 			// (which DuckDB reads as end-of-data for this worker).
@@ -1215,13 +1600,7 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLObjectsBind(ClientContext &c
 
 unique_ptr<GlobalTableFunctionState> XMLReaderFunctions::ReadXMLObjectsInit(ClientContext &context,
                                                                             TableFunctionInitInput &input) {
-	auto result = make_uniq<XMLReadGlobalState>();
-	auto &bind_data = input.bind_data->Cast<XMLReadFunctionData>();
-
-	// Shared work list only; per-file cursor state lives in each worker's local state.
-	result->files = bind_data.files;
-
-	return std::move(result);
+	return ReadDocumentInit(context, input);
 }
 
 void XMLReaderFunctions::ReadXMLObjectsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
@@ -1374,6 +1753,7 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 	// Set opaque type name based on parse mode
 	schema_options.opaque_type_name = (result->parse_mode == ParseMode::HTML) ? "HTML" : "XML";
 	bool has_explicit_columns = false;
+	bool has_on_invalid = false;
 
 	for (auto &kv : input.named_parameters) {
 		if (kv.first == "ignore_errors") {
@@ -1387,6 +1767,7 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 			result->schema_sample_files = kv.second.GetValue<int64_t>();
 		} else if (kv.first == "maximum_file_size") {
 			result->max_file_size = kv.second.GetValue<idx_t>();
+			result->has_explicit_max_file_size = true;
 			schema_options.maximum_file_size = result->max_file_size;
 		} else if (kv.first == "root_element") {
 			schema_options.root_element = kv.second.ToString();
@@ -1503,6 +1884,21 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 			schema_options.streaming = kv.second.GetValue<bool>();
 		} else if (kv.first == "preserve_whitespace") {
 			schema_options.preserve_whitespace = kv.second.GetValue<bool>();
+		} else if (kv.first == "xsd") {
+			result->xsd_path = kv.second.ToString();
+		} else if (kv.first == "on_invalid") {
+			auto action = StringUtil::Lower(kv.second.ToString());
+			if (action == "error") {
+				result->on_invalid = XSDInvalidFileAction::RAISE_ERROR;
+			} else if (action == "skip_file") {
+				result->on_invalid = XSDInvalidFileAction::SKIP_FILE;
+			} else if (action == "flag") {
+				result->on_invalid = XSDInvalidFileAction::FLAG;
+			} else {
+				throw BinderException(
+				    "read_xml \"on_invalid\" parameter must be 'error', 'skip_file' or 'flag', got: '%s'", action);
+			}
+			has_on_invalid = true;
 		} else if (kv.first == "columns") {
 			// Handle explicit column schema specification (like JSON extension)
 			auto &child_type = kv.second.type();
@@ -1547,6 +1943,22 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 		throw BinderException("read_xml cannot use both \"columns\" parameter and \"all_varchar\" option. "
 		                      "Use \"all_varchar\" for automatic schema inference, or specify explicit column types.");
 	}
+	if (has_on_invalid && result->xsd_path.empty()) {
+		throw BinderException("read_xml \"on_invalid\" parameter requires an \"xsd\" schema");
+	}
+
+	// Compile the XSD once; every worker validates against this compiled schema
+	if (!result->xsd_path.empty()) {
+		auto xsd_handle = fs.OpenFile(result->xsd_path, FileFlags::FILE_FLAGS_READ);
+		auto xsd_size = static_cast<idx_t>(fs.GetFileSize(*xsd_handle));
+		string xsd_content;
+		xsd_content.resize(xsd_size);
+		ReadFileFully(*xsd_handle, (char *)xsd_content.data(), xsd_size);
+		result->xsd_schema = XMLSchemaValidator::Compile(xsd_content.data(), xsd_content.size());
+		if (!result->xsd_schema) {
+			throw BinderException("read_xml could not compile XSD schema %s", result->xsd_path);
+		}
+	}
 
 	// Store schema options in bind_data for use during execution
 	result->schema_options = schema_options;
@@ -1574,15 +1986,22 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 			std::unordered_map<std::string, std::string> union_formats; // Per-column winning datetime format
 			std::vector<std::string> column_order;                      // Track order of first appearance
 
+			// DOM/SAX decisions here use the default expansion factor until the first sample is measured.
+			// Samples are parsed one at a time, so one that cannot stream only has to fit memory_limit.
+			idx_t dom_budget = ComputeDOMMemoryBudget(context, result->files.size());
+			idx_t memory_limit = BufferManager::GetBufferManager(context).GetMaxMemory();
+			bool measured_expansion = false;
+
 			// Scan each file for schema
 			for (const auto &file_path : files_to_scan) {
 				try {
 					auto file_handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
 					auto file_size = fs.GetFileSize(*file_handle);
+					bool exceeds_dom_limit = ExceedsDOMLimit(*result, static_cast<idx_t>(file_size), dom_budget);
 
 					// Determine if SAX inference should be used
 					bool use_sax_inference = false;
-					if (schema_options.streaming && static_cast<idx_t>(file_size) > result->max_file_size) {
+					if (schema_options.streaming && exceeds_dom_limit) {
 						if (!HasComplexXPath(schema_options.record_element)) {
 							use_sax_inference = true;
 						}
@@ -1593,11 +2012,11 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 					if (use_sax_inference) {
 						inferred_columns = SAXStreamReader::InferSchemaFromStream(fs, file_path, schema_options);
 					} else {
-						// DOM mode: enforce file size limit
-						if (static_cast<idx_t>(file_size) > result->max_file_size) {
+						// DOM mode: enforce the DOM size limit
+						if (exceeds_dom_limit &&
+						    !FitsMemoryLimit(*result, static_cast<idx_t>(file_size), memory_limit)) {
 							if (!result->ignore_errors) {
-								throw InvalidInputException("File %s exceeds maximum size limit (%llu bytes)",
-								                            file_path, result->max_file_size);
+								ThrowDOMLimitExceeded(*result, file_path, static_cast<idx_t>(file_size), memory_limit);
 							}
 							continue;
 						}
@@ -1606,7 +2025,8 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 						content.resize(file_size);
 						ReadFileFully(*file_handle, (char *)content.data(), file_size);
 
-						auto validity = XMLUtils::CheckXML(content);
+						idx_t dom_footprint = 0;
+						auto validity = XMLUtils::CheckXML(content, dom_footprint);
 						if (validity == XMLValidity::ResourceError) {
 							ThrowLibxmlOutOfMemory(file_path);
 						}
@@ -1616,6 +2036,7 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 							}
 							continue;
 						}
+						RecordDOMExpansion(*result, content.size(), dom_footprint, measured_expansion);
 
 						inferred_columns = XMLSchemaInference::InferSchema(content, schema_options);
 					}
@@ -1674,6 +2095,12 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 		}
 	}
 
+	// on_invalid := 'flag' reports each row's file verdict ahead of the record's columns
+	if (result->xsd_schema && result->on_invalid == XSDInvalidFileAction::FLAG) {
+		names.insert(names.begin(), "xsd_valid");
+		return_types.insert(return_types.begin(), LogicalType::BOOLEAN);
+	}
+
 	// Add filename column at the beginning if requested
 	// Note: Only add to output schema (names/return_types), NOT to stored schema
 	// (column_names/column_types) which is used for data extraction
@@ -1687,7 +2114,9 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadXMLBind(ClientContext &context,
 
 unique_ptr<GlobalTableFunctionState> XMLReaderFunctions::ReadXMLInit(ClientContext &context,
                                                                      TableFunctionInitInput &input) {
-	return ReadXMLObjectsInit(context, input);
+	auto result = ReadDocumentInit(context, input);
+	EnableSharedDOMExtraction(context, result->Cast<XMLReadGlobalState>());
+	return result;
 }
 
 void XMLReaderFunctions::ReadXMLFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
@@ -1745,7 +2174,9 @@ unique_ptr<FunctionData> XMLReaderFunctions::ReadHTMLBind(ClientContext &context
 
 unique_ptr<GlobalTableFunctionState> XMLReaderFunctions::ReadHTMLInit(ClientContext &context,
                                                                       TableFunctionInitInput &input) {
-	return ReadDocumentInit(context, input);
+	auto result = ReadDocumentInit(context, input);
+	EnableSharedDOMExtraction(context, result->Cast<XMLReadGlobalState>());
+	return result;
 }
 
 void XMLReaderFunctions::ReadHTMLFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
@@ -2225,8 +2656,11 @@ void XMLReaderFunctions::Register(ExtensionLoader &loader) {
 	read_xml_single.named_parameters["nullstr"] = LogicalType::ANY;
 	read_xml_single.named_parameters["streaming"] = LogicalType::BOOLEAN;
 	read_xml_single.named_parameters["preserve_whitespace"] = LogicalType::BOOLEAN;
+	read_xml_single.named_parameters["xsd"] = LogicalType::VARCHAR;
+	read_xml_single.named_parameters["on_invalid"] = LogicalType::VARCHAR; // 'error' | 'skip_file' | 'flag'
 	read_xml_single.init_local = ReadDocumentInitLocal;
 	read_xml_single.get_partition_data = ReadDocumentGetPartitionData;
+	read_xml_single.dynamic_to_string = ReadDocumentToString;
 	read_xml_set.AddFunction(read_xml_single);
 
 	// Variant 2: Array of strings parameter
@@ -2260,8 +2694,11 @@ void XMLReaderFunctions::Register(ExtensionLoader &loader) {
 	read_xml_array.named_parameters["nullstr"] = LogicalType::ANY;
 	read_xml_array.named_parameters["streaming"] = LogicalType::BOOLEAN;
 	read_xml_array.named_parameters["preserve_whitespace"] = LogicalType::BOOLEAN;
+	read_xml_array.named_parameters["xsd"] = LogicalType::VARCHAR;
+	read_xml_array.named_parameters["on_invalid"] = LogicalType::VARCHAR; // 'error' | 'skip_file' | 'flag'
 	read_xml_array.init_local = ReadDocumentInitLocal;
 	read_xml_array.get_partition_data = ReadDocumentGetPartitionData;
+	read_xml_array.dynamic_to_string = ReadDocumentToString;
 	read_xml_set.AddFunction(read_xml_array);
 
 	loader.RegisterFunction(read_xml_set);
@@ -2300,6 +2737,7 @@ void XMLReaderFunctions::Register(ExtensionLoader &loader) {
 	read_html_single.named_parameters["preserve_whitespace"] = LogicalType::BOOLEAN;
 	read_html_single.init_local = ReadDocumentInitLocal;
 	read_html_single.get_partition_data = ReadDocumentGetPartitionData;
+	read_html_single.dynamic_to_string = ReadDocumentToString;
 	read_html_set.AddFunction(read_html_single);
 
 	// Variant 2: Array of strings parameter
@@ -2334,6 +2772,7 @@ void XMLReaderFunctions::Register(ExtensionLoader &loader) {
 	read_html_array.named_parameters["preserve_whitespace"] = LogicalType::BOOLEAN;
 	read_html_array.init_local = ReadDocumentInitLocal;
 	read_html_array.get_partition_data = ReadDocumentGetPartitionData;
+	read_html_array.dynamic_to_string = ReadDocumentToString;
 	read_html_set.AddFunction(read_html_array);
 
 	loader.RegisterFunction(read_html_set);
@@ -2368,6 +2807,11 @@ void XMLReaderFunctions::Register(ExtensionLoader &loader) {
 	                                           HTMLExtractTablesBind, HTMLExtractTablesInit);
 	loader.RegisterFunction(html_extract_tables_function);
 
+	// Register xml_document_cache_stats table function (hit/miss counters for tuning xml_document_cache_size)
+	TableFunction xml_document_cache_stats_function("xml_document_cache_stats", {}, XMLDocumentCacheStatsFunction,
+	                                                XMLDocumentCacheStatsBind, XMLDocumentCacheStatsInit);
+	loader.RegisterFunction(xml_document_cache_stats_function);
+
 	// =============================================================================
 	// Register parse_xml_objects table function (parses XML string, returns raw content)
 	// =============================================================================
@@ -2533,4 +2977,47 @@ void XMLReaderFunctions::HTMLExtractTablesFunction(ClientContext &context, Table
 	CompatSetOutputCardinality(output, output_idx);
 }
 
+
+struct XMLDocumentCacheStatsGlobalState : public GlobalTableFunctionState {
+	bool finished = false;
+};
+
+unique_ptr<FunctionData> XMLReaderFunctions::XMLDocumentCacheStatsBind(ClientContext &context,
+                                                                       TableFunctionBindInput &input,
+                                                                       vector<LogicalType> &return_types,
+                                                                       vector<string> &names) {
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("hits");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("misses");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("evictions");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("capacity_bytes");
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> XMLReaderFunctions::XMLDocumentCacheStatsInit(ClientContext &context,
+                                                                                   TableFunctionInitInput &input) {
+	return make_uniq<XMLDocumentCacheStatsGlobalState>();
+}
+
+void XMLReaderFunctions::XMLDocumentCacheStatsFunction(ClientContext &context, TableFunctionInput &data_p,
+                                                       DataChunk &output) {
+	auto &gstate = data_p.global_state->Cast<XMLDocumentCacheStatsGlobalState>();
+	if (gstate.finished) {
+		CompatSetOutputCardinality(output, 0);
+		return;
+	}
+	gstate.finished = true;
+
+	// Counters are summed over all threads since the extension loaded
+	auto stats = XMLDocumentCache::GetStats();
+	output.data[0].SetValue(0, Value::UBIGINT(stats.hits));
+	output.data[1].SetValue(0, Value::UBIGINT(stats.misses));
+	output.data[2].SetValue(0, Value::UBIGINT(stats.evictions));
+	output.data[3].SetValue(0, Value::UBIGINT(XMLDocumentCache::GetCapacity(context)));
+	CompatSetOutputCardinality(output, 1);
+}
+
 } // namespace duckdb
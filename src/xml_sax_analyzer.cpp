@@ -0,0 +1,672 @@
+#include "xml_sax_analyzer.hpp"
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+namespace {
+
+struct XMLSAXAnalysisState {
+	const std::vector<XMLSAXAnalyzer *> *analyzers = nullptr;
+	xmlParserCtxtPtr parser = nullptr;
+	idx_t depth = 0;
+	// The last event was a CDATA section, which the next one extends
+	bool in_cdata = false;
+	int64_t cdata_line = 0;
+	bool unsupported = false;
+};
+
+XMLSAXAnalysisState &GetState(void *ctx) {
+	return *static_cast<XMLSAXAnalysisState *>(ctx);
+}
+
+// The line `content` starts on, given the line the parser is on once it has read the node. libxml2
+// normalizes line ends to '\n' before reporting content, and counts lines the same way.
+int64_t StartLine(const xmlChar *content, idx_t size, int64_t end_line) {
+	return end_line - std::count(content, content + size, '\n');
+}
+
+void AnalysisStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri,
+                          int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+                          const xmlChar **attributes) {
+	auto &state = GetState(ctx);
+	state.in_cdata = false;
+	XMLSAXElement element;
+	element.localname = localname;
+	element.prefix = prefix;
+	element.uri = uri;
+	element.nb_namespaces = nb_namespaces;
+	element.namespaces = namespaces;
+	element.nb_attributes = nb_attributes;
+	element.attributes = attributes;
+	element.depth = ++state.depth;
+	for (auto analyzer : *state.analyzers) {
+		analyzer->StartElement(element);
+	}
+}
+
+void AnalysisEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri) {
+	auto &state = GetState(ctx);
+	state.in_cdata = false;
+	state.depth--;
+	for (auto analyzer : *state.analyzers) {
+		analyzer->EndElement();
+	}
+}
+
+void AnalysisCharacters(void *ctx, const xmlChar *ch, int len) {
+	auto &state = GetState(ctx);
+	state.in_cdata = false;
+	for (auto analyzer : *state.analyzers) {
+		analyzer->Characters(reinterpret_cast<const char *>(ch), len);
+	}
+}
+
+// The push parser hands over a long section in pieces, the first of them while still on its first
+// line; a section right after another one continues the same DOM node
+void AnalysisCDataBlock(void *ctx, const xmlChar *value, int len) {
+	auto &state = GetState(ctx);
+	bool append = state.in_cdata;
+	if (!append) {
+		state.in_cdata = true;
+		state.cdata_line = xmlSAX2GetLineNumber(state.parser);
+	}
+	for (auto analyzer : *state.analyzers) {
+		analyzer->CData(reinterpret_cast<const char *>(value), len, state.cdata_line, append);
+	}
+}
+
+void AnalysisComment(void *ctx, const xmlChar *value) {
+	auto &state = GetState(ctx);
+	state.in_cdata = false;
+	auto line_number = StartLine(value, xmlStrlen(value), xmlSAX2GetLineNumber(state.parser));
+	for (auto analyzer : *state.analyzers) {
+		analyzer->Comment(reinterpret_cast<const char *>(value), line_number);
+	}
+}
+
+void AnalysisProcessingInstruction(void *ctx, const xmlChar *target, const xmlChar *data) {
+	auto &state = GetState(ctx);
+	state.in_cdata = false;
+	for (auto analyzer : *state.analyzers) {
+		analyzer->ProcessingInstruction();
+	}
+}
+
+void AnalysisInternalSubset(void *ctx, const xmlChar *name, const xmlChar *external_id, const xmlChar *system_id) {
+	auto &state = GetState(ctx);
+	state.unsupported = true;
+	xmlStopParser(state.parser);
+}
+
+} // namespace
+
+XMLSAXAnalysisResult XMLSAXAnalysis::Run(const string_t &xml_str, const std::vector<XMLSAXAnalyzer *> &analyzers) {
+	XMLUtils::EnsureSecureParsing();
+
+	xmlSAXHandler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.initialized = XML_SAX2_MAGIC;
+	handler.startElementNs = AnalysisStartElement;
+	handler.endElementNs = AnalysisEndElement;
+	handler.characters = AnalysisCharacters;
+	handler.ignorableWhitespace = AnalysisCharacters;
+	handler.cdataBlock = AnalysisCDataBlock;
+	handler.comment = AnalysisComment;
+	handler.processingInstruction = AnalysisProcessingInstruction;
+	handler.internalSubset = AnalysisInternalSubset;
+
+	XMLSAXAnalysisState state;
+	state.analyzers = &analyzers;
+	state.parser = xmlCreatePushParserCtxt(&handler, &state, nullptr, 0, nullptr);
+	if (!state.parser) {
+		return XMLSAXAnalysisResult::UNSUPPORTED;
+	}
+	xmlCtxtUseOptions(state.parser, XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
+
+	// Feed in chunks so the parser's input buffer stays small however large the document is
+	auto data = xml_str.GetData();
+	idx_t size = xml_str.GetSize();
+	idx_t offset = 0;
+	bool parsed = size > 0;
+	while (parsed && offset < size) {
+		auto chunk = MinValue<idx_t>(CHUNK_SIZE, size - offset);
+		bool last = offset + chunk == size;
+		if (xmlParseChunk(state.parser, data + offset, static_cast<int>(chunk), last ? 1 : 0) != 0) {
+			parsed = false;
+		}
+		offset += chunk;
+	}
+	parsed = parsed && state.parser->wellFormed;
+	xmlFreeParserCtxt(state.parser);
+
+	if (state.unsupported) {
+		return XMLSAXAnalysisResult::UNSUPPORTED;
+	}
+	return parsed ? XMLSAXAnalysisResult::COMPLETE : XMLSAXAnalysisResult::MALFORMED;
+}
+
+// ─── XMLStatsAnalyzer ────────────────────────────────────────────────────────
+
+void XMLStatsAnalyzer::StartElement(const XMLSAXElement &element) {
+	depth = element.depth;
+	element_count++;
+	attribute_count += element.nb_attributes;
+	max_depth = MaxValue<int64_t>(max_depth, depth);
+	if (element.uri) {
+		namespace_uris.insert(reinterpret_cast<const char *>(element.uri));
+	}
+}
+
+void XMLStatsAnalyzer::EndElement() {
+	depth--;
+}
+
+void XMLStatsAnalyzer::AddChild() {
+	max_depth = MaxValue<int64_t>(max_depth, depth + 1);
+}
+
+void XMLStatsAnalyzer::Characters(const char *data, idx_t size) {
+	AddChild();
+}
+
+void XMLStatsAnalyzer::CData(const char *data, idx_t size, int64_t line_number, bool append) {
+	AddChild();
+}
+
+// Comments and processing instructions outside the root element are not part of the tree counted
+void XMLStatsAnalyzer::Comment(const char *content, int64_t line_number) {
+	if (depth > 0) {
+		AddChild();
+	}
+}
+
+void XMLStatsAnalyzer::ProcessingInstruction() {
+	if (depth > 0) {
+		AddChild();
+	}
+}
+
+XMLStats XMLStatsAnalyzer::GetStats(idx_t size_bytes) const {
+	XMLStats stats;
+	stats.element_count = element_count;
+	stats.attribute_count = attribute_count;
+	stats.max_depth = max_depth;
+	stats.size_bytes = size_bytes;
+	stats.namespace_count = namespace_uris.size();
+	return stats;
+}
+
+// ─── XMLNamespaceAnalyzer ────────────────────────────────────────────────────
+
+void XMLNamespaceAnalyzer::Add(const xmlChar *prefix, const xmlChar *uri) {
+	std::string prefix_str = prefix ? reinterpret_cast<const char *>(prefix) : "";
+	std::string uri_str = reinterpret_cast<const char *>(uri);
+	if (seen.insert(std::make_pair(prefix_str, uri_str)).second) {
+		XMLNamespace ns;
+		ns.prefix = std::move(prefix_str);
+		ns.uri = std::move(uri_str);
+		namespaces.push_back(std::move(ns));
+	}
+}
+
+void XMLNamespaceAnalyzer::StartElement(const XMLSAXElement &element) {
+	// The element's own namespace first, then the declarations it carries
+	if (element.uri) {
+		Add(element.prefix, element.uri);
+	}
+	for (int i = 0; i < element.nb_namespaces; i++) {
+		auto prefix = element.namespaces[2 * i];
+		auto uri = element.namespaces[2 * i + 1];
+		if (uri) {
+			Add(prefix, uri);
+		}
+	}
+}
+
+// ─── Comments, CDATA and text ────────────────────────────────────────────────
+
+void XMLCommentAnalyzer::Comment(const char *content, int64_t line_number) {
+	XMLComment comment;
+	comment.content = content;
+	comment.line_number = line_number;
+	comments.push_back(std::move(comment));
+}
+
+void XMLCDataAnalyzer::CData(const char *data, idx_t size, int64_t line_number, bool append) {
+	if (append && !sections.empty()) {
+		sections.back().content.append(data, size);
+		return;
+	}
+	XMLComment section;
+	section.content.assign(data, size);
+	section.line_number = line_number;
+	sections.push_back(std::move(section));
+}
+
+void XMLTextAnalyzer::Characters(const char *data, idx_t size) {
+	text.append(data, size);
+}
+
+void XMLTextAnalyzer::CData(const char *data, idx_t size, int64_t line_number, bool append) {
+	text.append(data, size);
+}
+
+// ─── XMLToJSONWriter ─────────────────────────────────────────────────────────
+
+namespace {
+
+// Append a UTF-8 string escaped for a JSON string literal (GitHub Issue #78). libxml2 hands over
+// entity-decoded text (e.g. &quot; -> ", &#10; -> newline), so characters that are illegal raw
+// inside a JSON string must be re-escaped. Only " , \ and the C0 control range (0x00-0x1F) need
+// escaping per RFC 8259; raw UTF-8 multibyte sequences and / < > & pass through untouched.
+void AppendJSONString(std::string &out, const char *data, idx_t size) {
+	static const char *hex = "0123456789abcdef";
+	idx_t run_start = 0;
+	for (idx_t i = 0; i < size; i++) {
+		auto c = static_cast<unsigned char>(data[i]);
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+		out.append(data + run_start, i - run_start);
+		run_start = i + 1;
+		switch (c) {
+		case '"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\b':
+			out += "\\b";
+			break;
+		case '\f':
+			out += "\\f";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+			// Remaining C0 control characters: \u00XX (lowercase hex)
+			out += "\\u00";
+			out += hex[(c >> 4) & 0xF];
+			out += hex[c & 0xF];
+			break;
+		}
+	}
+	out.append(data + run_start, size - run_start);
+}
+
+void AppendJSONString(std::string &out, const std::string &str) {
+	AppendJSONString(out, str.data(), str.size());
+}
+
+void AppendJSONString(std::string &out, const xmlChar *str) {
+	AppendJSONString(out, reinterpret_cast<const char *>(str), xmlStrlen(str));
+}
+
+bool IsJSONTrimmed(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+} // namespace
+
+XMLToJSONWriter::XMLToJSONWriter(const XMLToJSONOptions &options_p)
+    : options(options_p), force_list(options_p.force_list.begin(), options_p.force_list.end()) {
+	if (options.namespaces == "expand") {
+		namespace_mode = NamespaceMode::EXPAND;
+	} else if (options.namespaces == "keep") {
+		namespace_mode = NamespaceMode::KEEP;
+	} else {
+		namespace_mode = NamespaceMode::STRIP;
+	}
+}
+
+void XMLToJSONWriter::Reset() {
+	depth = 0;
+	namespaces_open = false;
+	has_root = false;
+	json.clear();
+}
+
+const std::string &XMLToJSONWriter::Finish() {
+	if (!has_root) {
+		json = "{}";
+	}
+	return json;
+}
+
+// The key of an element or attribute under the `namespaces` option. A namespace URI may need escaping
+// when it is written into the JSON; names never do.
+void XMLToJSONWriter::AppendName(std::string &out, const xmlChar *localname, const xmlChar *prefix,
+                                 const xmlChar *uri, bool escape) const {
+	if (namespace_mode == NamespaceMode::EXPAND && uri) {
+		if (escape) {
+			AppendJSONString(out, uri);
+		} else {
+			out += reinterpret_cast<const char *>(uri);
+		}
+		out += ':';
+	} else if (namespace_mode == NamespaceMode::KEEP && prefix) {
+		out += reinterpret_cast<const char *>(prefix);
+		out += ':';
+	}
+	out += reinterpret_cast<const char *>(localname);
+}
+
+void XMLToJSONWriter::StartMember(const Frame &frame) {
+	if (json.size() > frame.start + 1) {
+		json += ',';
+	}
+}
+
+void XMLToJSONWriter::WriteKey(const std::string &key) {
+	json += '"';
+	AppendJSONString(json, key);
+	json += "\":";
+}
+
+// An element's value is written where it stands: the parent has already written its key (and the
+// '[' of a list) when the element opens
+void XMLToJSONWriter::OpenElement(const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri) {
+	if (depth == frames.size()) {
+		frames.emplace_back();
+	}
+	auto &frame = frames[depth];
+	frame.key.clear();
+	AppendName(frame.key, localname, prefix, uri, false);
+	frame.group = DConstants::INVALID_INDEX;
+
+	if (depth == 0) {
+		// The root is wrapped in an object keyed by its name
+		json += '{';
+		WriteKey(frame.key);
+	} else {
+		auto &parent = frames[depth - 1];
+		auto entry = parent.group_index.find(frame.key);
+		if (entry == parent.group_index.end()) {
+			CloseLastGroup(parent);
+			StartMember(parent);
+			WriteKey(frame.key);
+			ChildGroup group;
+			group.key = frame.key;
+			group.as_list = force_list.count(frame.key) > 0;
+			group.first = DConstants::INVALID_INDEX;
+			group.last = DConstants::INVALID_INDEX;
+			if (group.as_list) {
+				json += '[';
+			}
+			frame.group = parent.groups.size();
+			parent.group_index.emplace(frame.key, frame.group);
+			parent.groups.push_back(std::move(group));
+		} else {
+			frame.group = entry->second;
+			auto &group = parent.groups[frame.group];
+			if (frame.group != parent.groups.size() - 1) {
+				// A name seen before another one: the parent's members are regrouped at its end tag
+				parent.in_place = false;
+			} else if (parent.in_place && !group.as_list) {
+				// The second of a run of same-named siblings turns the first one's value into a list
+				auto &first = parent.children[group.first];
+				json.insert(json.begin() + static_cast<std::ptrdiff_t>(first.offset), '[');
+				first.offset++;
+				group.as_list = true;
+			}
+			json += ',';
+		}
+	}
+
+	depth++;
+	frame.start = json.size();
+	frame.members_size = 0;
+	frame.in_place = true;
+	frame.text.clear();
+	frame.children.clear();
+	frame.groups.clear();
+	frame.group_index.clear();
+	json += '{';
+}
+
+void XMLToJSONWriter::AddAttribute(const xmlChar *localname, const xmlChar *prefix, const xmlChar *uri,
+                                   const char *data, idx_t size) {
+	auto &frame = frames[depth - 1];
+	StartMember(frame);
+	json += '"';
+	AppendJSONString(json, options.attr_prefix);
+	AppendName(json, localname, prefix, uri, true);
+	json += "\":\"";
+	AppendJSONString(json, data, size);
+	json += '"';
+}
+
+// Declarations on the root element, under xmlns_key, in the order they are declared
+void XMLToJSONWriter::AddNamespace(const xmlChar *prefix, const xmlChar *uri) {
+	if (depth != 1 || options.xmlns_key.empty() || !uri || !*uri) {
+		return;
+	}
+	if (!namespaces_open) {
+		StartMember(frames[0]);
+		WriteKey(options.xmlns_key);
+		json += '{';
+		namespaces_open = true;
+	} else {
+		json += ',';
+	}
+	json += '"';
+	if (prefix) {
+		AppendJSONString(json, prefix);
+	}
+	json += "\":\"";
+	AppendJSONString(json, uri);
+	json += '"';
+}
+
+void XMLToJSONWriter::EndStartTag() {
+	if (namespaces_open) {
+		json += '}';
+		namespaces_open = false;
+	}
+	auto &frame = frames[depth - 1];
+	frame.members_size = json.size() - frame.start - 1;
+}
+
+void XMLToJSONWriter::CloseLastGroup(const Frame &frame) {
+	if (frame.in_place && !frame.groups.empty() && frame.groups.back().as_list) {
+		json += ']';
+	}
+}
+
+void XMLToJSONWriter::AppendText(std::string &out, const std::string &text) {
+	out += '"';
+	AppendJSONString(out, options.text_key);
+	out += "\":\"";
+	AppendJSONString(out, text);
+	out += '"';
+}
+
+void XMLToJSONWriter::CloseElement() {
+	auto &frame = frames[depth - 1];
+
+	// Direct text, with surrounding whitespace dropped
+	idx_t text_start = 0;
+	idx_t text_end = frame.text.size();
+	while (text_start < text_end && IsJSONTrimmed(frame.text[text_start])) {
+		text_start++;
+	}
+	while (text_end > text_start && IsJSONTrimmed(frame.text[text_end - 1])) {
+		text_end--;
+	}
+	bool has_text = text_end > text_start;
+	if (has_text) {
+		frame.text.erase(text_end);
+		frame.text.erase(0, text_start);
+	}
+
+	bool has_content = frame.members_size > 0 || has_text || !frame.children.empty();
+	if (!has_content && options.empty_elements != "object") {
+		json.resize(frame.start);
+		json += options.empty_elements == "null" ? "null" : "\"\"";
+	} else if (frame.in_place && !(has_text && !frame.children.empty())) {
+		// The members are already in order: finish the last list and add the text, if any
+		CloseLastGroup(frame);
+		if (has_text) {
+			StartMember(frame);
+			AppendText(json, frame.text);
+		}
+		json += '}';
+	} else {
+		// Text that follows child elements comes before them, and a name that reappears after another
+		// one gathers all its elements into one list, so the members are rebuilt from their values
+		value.clear();
+		value += '{';
+		value.append(json, frame.start + 1, frame.members_size);
+		bool need_comma = frame.members_size > 0;
+		if (has_text) {
+			if (need_comma) {
+				value += ',';
+			}
+			AppendText(value, frame.text);
+			need_comma = true;
+		}
+		for (auto &group : frame.groups) {
+			if (need_comma) {
+				value += ',';
+			}
+			value += '"';
+			AppendJSONString(value, group.key);
+			value += "\":";
+			if (group.as_list) {
+				value += '[';
+			}
+			for (auto child_idx = group.first; child_idx != DConstants::INVALID_INDEX;) {
+				auto &child = frame.children[child_idx];
+				if (child_idx != group.first) {
+					value += ',';
+				}
+				value.append(json, child.offset, child.size);
+				child_idx = child.next;
+			}
+			if (group.as_list) {
+				value += ']';
+			}
+			need_comma = true;
+		}
+		value += '}';
+		json.resize(frame.start);
+		json += value;
+	}
+	depth--;
+
+	if (depth == 0) {
+		if (has_content || options.empty_elements == "object") {
+			json += '}';
+		} else {
+			// An empty root is a bare null or string when empty_elements asks for one
+			json.erase(0, frame.start);
+		}
+		has_root = true;
+		return;
+	}
+
+	// Record the value with the parent, which needs it if it has to regroup its members
+	auto &parent = frames[depth - 1];
+	auto child_idx = parent.children.size();
+	ChildValue child;
+	child.offset = frame.start;
+	child.size = json.size() - frame.start;
+	child.next = DConstants::INVALID_INDEX;
+	parent.children.push_back(child);
+	auto &group = parent.groups[frame.group];
+	if (group.first == DConstants::INVALID_INDEX) {
+		group.first = child_idx;
+	} else {
+		parent.children[group.last].next = child_idx;
+		group.as_list = true;
+	}
+	group.last = child_idx;
+}
+
+void XMLToJSONWriter::StartElement(const XMLSAXElement &element) {
+	OpenElement(element.localname, element.prefix, element.uri);
+	for (int i = 0; i < element.nb_attributes; i++) {
+		auto attribute = element.attributes + 5 * i;
+		auto data = reinterpret_cast<const char *>(attribute[3]);
+		idx_t size = attribute[4] - attribute[3];
+		// Without entity substitution, libxml2 hands over an '&' in an attribute value as "&#38;"
+		// (entities themselves need a DOCTYPE, which these events never come with)
+		if (memchr(data, '&', size)) {
+			scratch.clear();
+			for (idx_t pos = 0; pos < size; pos++) {
+				scratch += data[pos];
+				if (data[pos] == '&' && size - pos >= 5 && memcmp(data + pos, "&#38;", 5) == 0) {
+					pos += 4;
+				}
+			}
+			AddAttribute(attribute[0], attribute[1], attribute[2], scratch.data(), scratch.size());
+			continue;
+		}
+		AddAttribute(attribute[0], attribute[1], attribute[2], data, size);
+	}
+	for (int i = 0; i < element.nb_namespaces; i++) {
+		AddNamespace(element.namespaces[2 * i], element.namespaces[2 * i + 1]);
+	}
+	EndStartTag();
+}
+
+void XMLToJSONWriter::EndElement() {
+	CloseElement();
+}
+
+void XMLToJSONWriter::Characters(const char *data, idx_t size) {
+	if (depth > 0) {
+		frames[depth - 1].text.append(data, size);
+	}
+}
+
+void XMLToJSONWriter::CData(const char *data, idx_t size, int64_t line_number, bool append) {
+	Characters(data, size);
+}
+
+void XMLToJSONWriter::WriteDOMElement(xmlDocPtr doc, xmlNodePtr node) {
+	auto ns_prefix = [](xmlNsPtr ns) -> const xmlChar * { return ns ? ns->prefix : nullptr; };
+	auto ns_uri = [](xmlNsPtr ns) -> const xmlChar * { return ns ? ns->href : nullptr; };
+
+	OpenElement(node->name, ns_prefix(node->ns), ns_uri(node->ns));
+	for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
+		XMLCharPtr attr_value(xmlNodeListGetString(doc, attr->children, 1));
+		auto data = attr_value ? reinterpret_cast<const char *>(attr_value.get()) : "";
+		AddAttribute(attr->name, ns_prefix(attr->ns), ns_uri(attr->ns), data, strlen(data));
+	}
+	for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next) {
+		AddNamespace(ns->prefix, ns->href);
+	}
+	EndStartTag();
+
+	// Direct text includes CDATA sections (GitHub Issue #63)
+	for (xmlNodePtr child = node->children; child; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE) {
+			WriteDOMElement(doc, child);
+		} else if ((child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE) && child->content) {
+			Characters(reinterpret_cast<const char *>(child->content), xmlStrlen(child->content));
+		}
+	}
+	CloseElement();
+}
+
+void XMLToJSONWriter::WriteDocument(xmlDocPtr doc) {
+	Reset();
+	xmlNodePtr root = doc ? xmlDocGetRootElement(doc) : nullptr;
+	if (root) {
+		WriteDOMElement(doc, root);
+	}
+}
+
+} // namespace duckdb
@@ -1,23 +1,32 @@
 #include "xml_scalar_functions.hpp"
 #include "xml_utils.hpp"
 #include "xml_types.hpp"
+#include "xml_schema_inference.hpp"
+#include "xml_streaming_xpath.hpp"
+#include "xml_sax_analyzer.hpp"
+#include "xml_schema_validator.hpp"
 #include "duckdb_compat.hpp"
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
 
 #include <libxml/tree.h>
 #include <libxml/xmlmemory.h>
-#include <regex>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <set>
+#include <unordered_map>
 
 namespace duckdb {
 
 // Iterates a string input vector via UnifiedVectorFormat (handles FLAT, DICTIONARY and CONSTANT
 // vectors) and propagates NULL inputs to NULL results. The callback receives the row index and
-// the row's string value, and stores its result via result.SetValue.
+// the row's string (still in the input vector's buffer), and writes row i of the result.
 template <class PROCESS_ROW>
 static void ExecuteNullSafeString(Vector &input, Vector &result, idx_t count, PROCESS_ROW process_row) {
 	UnifiedVectorFormat input_data;
@@ -30,16 +39,452 @@ static void ExecuteNullSafeString(Vector &input, Vector &result, idx_t count, PR
 			FlatVector::SetNull(result, i, true);
 			continue;
 		}
-		process_row(i, input_strings[input_idx].GetString());
+		process_row(i, input_strings[input_idx]);
 	}
 }
 
+// Builds one row of a LIST result in place. Append adds an entry to the list's child vector (a
+// VARCHAR or other scalar vector, or a STRUCT whose fields the caller fills) and returns its index
+// there; Finish records the row's offset and length. Only one writer per list vector may be open at a time.
+class ListRowWriter {
+public:
+	ListRowWriter(Vector &list, idx_t row) : list(list), row(row), offset(ListVector::GetListSize(list)), length(0) {
+	}
+
+	idx_t Append() {
+		ListVector::Reserve(list, offset + length + 1);
+		return offset + length++;
+	}
+
+	// The child vector. Append may reallocate its data, so fetch data pointers after appending.
+	Vector &Child() {
+		return CompatListGetChild(list);
+	}
+
+	void Finish() {
+		ListVector::SetListSize(list, offset + length);
+		auto &entry = FlatVector::GetData<list_entry_t>(list)[row];
+		entry.offset = offset;
+		entry.length = length;
+	}
+
+private:
+	Vector &list;
+	idx_t row;
+	idx_t offset;
+	idx_t length;
+};
+
+static void SetFlatString(Vector &vector, idx_t idx, const char *data, idx_t size) {
+	FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddString(vector, data, size);
+}
+
+static void SetFlatString(Vector &vector, idx_t idx, const std::string &value) {
+	SetFlatString(vector, idx, value.data(), value.size());
+}
+
+static void SetFlatBigint(Vector &vector, idx_t idx, int64_t value) {
+	FlatVector::GetData<int64_t>(vector)[idx] = value;
+}
+
+// Calls `process_node` for every node `xpath` matches in `doc`; does nothing when the document did
+// not parse or the XPath does not evaluate to a node-set.
+template <class PROCESS_NODE>
+static void ForEachMatch(XMLDocRAII &doc, const std::string &xpath, xmlXPathCompExprPtr compiled,
+                         PROCESS_NODE process_node) {
+	if (!doc.IsValid() || !doc.xpath_ctx) {
+		return;
+	}
+	xmlXPathObjectPtr xpath_obj = XMLUtils::EvaluateXPath(xpath, doc.xpath_ctx, compiled);
+	if (!xpath_obj) {
+		return;
+	}
+	if (xpath_obj->nodesetval) {
+		for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
+			xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
+			if (node) {
+				process_node(node);
+			}
+		}
+	}
+	xmlXPathFreeObject(xpath_obj);
+}
+
+// xml_extract_text / html_extract_text: the text content of a match
+static void WriteTextMatch(xmlNodePtr node, ListRowWriter &writer) {
+	XMLCharPtr content(xmlNodeGetContent(node));
+	if (content) {
+		auto text = reinterpret_cast<const char *>(content.get());
+		auto idx = writer.Append();
+		SetFlatString(writer.Child(), idx, text, strlen(text));
+	}
+}
+
+static void WriteTextMatches(XMLDocRAII &doc, const std::string &xpath, xmlXPathCompExprPtr compiled,
+                             ListRowWriter &writer) {
+	ForEachMatch(doc, xpath, compiled, [&](xmlNodePtr node) { WriteTextMatch(node, writer); });
+}
+
+// xml_extract_elements: a match serialized as an XML fragment
+static void WriteElementMatch(xmlNodePtr node, XMLNodeSerializer &serializer, ListRowWriter &writer) {
+	string_t fragment;
+	if (serializer.Serialize(node, fragment)) {
+		auto idx = writer.Append();
+		SetFlatString(writer.Child(), idx, fragment.GetData(), fragment.GetSize());
+	}
+}
+
+static void WriteElementMatches(XMLDocRAII &doc, const std::string &xpath, xmlXPathCompExprPtr compiled,
+                                XMLNodeSerializer &serializer, ListRowWriter &writer) {
+	ForEachMatch(doc, xpath, compiled, [&](xmlNodePtr node) { WriteElementMatch(node, serializer, writer); });
+}
+
+static void WriteStringList(const std::vector<std::string> &values, ListRowWriter &writer) {
+	for (auto &value : values) {
+		auto idx = writer.Append();
+		SetFlatString(writer.Child(), idx, value);
+	}
+}
+
+// One xml_extract_attributes STRUCT(element_name, element_path, attribute_name, attribute_value,
+// line_number) entry
+static void AppendAttribute(ListRowWriter &writer, const char *element_name, const std::string &element_path,
+                            const char *attribute_name, const char *attribute_value, int64_t line_number) {
+	auto idx = writer.Append();
+	auto &entries = writer.Child();
+	SetFlatString(CompatStructGetField(entries, 0), idx, element_name, strlen(element_name));
+	SetFlatString(CompatStructGetField(entries, 1), idx, element_path);
+	SetFlatString(CompatStructGetField(entries, 2), idx, attribute_name, strlen(attribute_name));
+	SetFlatString(CompatStructGetField(entries, 3), idx, attribute_value, strlen(attribute_value));
+	SetFlatBigint(CompatStructGetField(entries, 4), idx, line_number);
+}
+
+// xml_extract_attributes: one entry per attribute of a matched element, ordered by attribute name
+// (a repeated local name keeps its last value). The element path and line are only computed for
+// elements that have attributes. `attributes` is scratch space reused across matches.
+static void WriteAttributeMatch(xmlNodePtr node, std::vector<std::pair<const char *, const char *>> &attributes,
+                                ListRowWriter &writer) {
+	if (node->type != XML_ELEMENT_NODE) {
+		return;
+	}
+	attributes.clear();
+	for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
+		if (!attr->name || !attr->children || !attr->children->content) {
+			continue;
+		}
+		auto name = reinterpret_cast<const char *>(attr->name);
+		auto value = reinterpret_cast<const char *>(attr->children->content);
+		auto existing = std::find_if(attributes.begin(), attributes.end(),
+		                             [&](const std::pair<const char *, const char *> &entry) {
+			                             return strcmp(entry.first, name) == 0;
+		                             });
+		if (existing != attributes.end()) {
+			existing->second = value;
+		} else {
+			attributes.emplace_back(name, value);
+		}
+	}
+	if (attributes.empty()) {
+		return;
+	}
+	std::sort(attributes.begin(), attributes.end(),
+	          [](const std::pair<const char *, const char *> &a, const std::pair<const char *, const char *> &b) {
+		          return strcmp(a.first, b.first) < 0;
+	          });
+	auto element_name = node->name ? reinterpret_cast<const char *>(node->name) : "";
+	auto element_path = XMLUtils::GetNodePath(node);
+	int64_t line_number = xmlGetLineNo(node);
+	for (auto &attribute : attributes) {
+		AppendAttribute(writer, element_name, element_path, attribute.first, attribute.second, line_number);
+	}
+}
+
+static void WriteAttributeMatches(XMLDocRAII &doc, const std::string &xpath, xmlXPathCompExprPtr compiled,
+                                  ListRowWriter &writer) {
+	std::vector<std::pair<const char *, const char *>> attributes;
+	ForEachMatch(doc, xpath, compiled, [&](xmlNodePtr node) { WriteAttributeMatch(node, attributes, writer); });
+}
+
+static void WriteAttributeList(const std::vector<XMLElement> &elements, ListRowWriter &writer) {
+	for (auto &elem : elements) {
+		for (auto &attr_pair : elem.attributes) {
+			AppendAttribute(writer, elem.name.c_str(), elem.path, attr_pair.first.c_str(), attr_pair.second.c_str(),
+			                elem.line_number);
+		}
+	}
+}
+
+// xml_extract_comments / xml_extract_cdata: STRUCT(content, line_number) entries
+static void WriteCommentList(const std::vector<XMLComment> &comments, ListRowWriter &writer) {
+	for (auto &comment : comments) {
+		auto idx = writer.Append();
+		auto &entries = writer.Child();
+		SetFlatString(CompatStructGetField(entries, 0), idx, comment.content);
+		SetFlatBigint(CompatStructGetField(entries, 1), idx, comment.line_number);
+	}
+}
+
+// Wraps a document scalar so it runs once per distinct input rather than once per row. The
+// document is the first argument; every other argument must be CONSTANT for the shortcuts to apply.
+// - All arguments CONSTANT: FUNCTION evaluates one row and the result is a CONSTANT vector.
+// - Document is a DICTIONARY (e.g. after a join against a table of documents) whose rows select
+//   fewer entries than there are rows: FUNCTION evaluates each selected entry once, and the result
+//   is a dictionary over those results. Entries no row selects are never evaluated.
+// Anything else goes straight to FUNCTION. FUNCTION runs with the query's document cache open.
+template <void (*FUNCTION)(DataChunk &, ExpressionState &, Vector &)>
+static void ExecuteDistinctInputs(DataChunk &args, ExpressionState &state, Vector &result) {
+	XMLDocumentCache::Scope cache_scope(state);
+	auto count = args.size();
+	bool other_args_constant = true;
+	for (idx_t col = 1; col < args.ColumnCount(); col++) {
+		other_args_constant =
+		    other_args_constant && args.data[col].GetVectorType() == VectorType::CONSTANT_VECTOR;
+	}
+	if (count <= 1 || !other_args_constant) {
+		FUNCTION(args, state, result);
+		return;
+	}
+
+	auto &document = args.data[0];
+	// DuckDB main cannot turn STRUCT-containing vectors constant (see PreventStructConstantFolding)
+	if (document.GetVectorType() == VectorType::CONSTANT_VECTOR && !result.GetType().Contains(LogicalTypeId::STRUCT)) {
+		DataChunk single;
+		single.InitializeEmpty(args.GetTypes());
+		single.Reference(args);
+		single.SetCardinality(1);
+		FUNCTION(single, state, result);
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		return;
+	}
+
+	if (document.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+		// The dictionary may be shared by many chunks and far larger than this one, so only the
+		// entries this chunk selects are gathered, each once, in order of first use
+		auto &selection = DictionaryVector::SelVector(document);
+		std::unordered_map<idx_t, sel_t> positions;
+		SelectionVector entries(count);
+		SelectionVector result_selection(count);
+		for (idx_t i = 0; i < count; i++) {
+			auto entry = selection.get_index(i);
+			auto inserted = positions.emplace(entry, static_cast<sel_t>(positions.size()));
+			if (inserted.second) {
+				entries.set_index(inserted.first->second, entry);
+			}
+			result_selection.set_index(i, inserted.first->second);
+		}
+		auto distinct_count = positions.size();
+		if (distinct_count < count) {
+			DataChunk distinct;
+			distinct.InitializeEmpty(args.GetTypes());
+			distinct.data[0].Slice(DictionaryVector::Child(document), entries, distinct_count);
+			for (idx_t col = 1; col < args.ColumnCount(); col++) {
+				distinct.data[col].Reference(args.data[col]);
+			}
+			distinct.SetCardinality(distinct_count);
+
+			Vector distinct_result(result.GetType(), distinct_count);
+			FUNCTION(distinct, state, distinct_result);
+			result.Dictionary(distinct_result, distinct_count, result_selection, count);
+			return;
+		}
+	}
+	FUNCTION(args, state, result);
+}
+
+// Bind data for the XPath extraction scalars. A constant XPath argument is captured at bind time
+// so every thread can compile it once up front instead of once per row, and a constant
+// `namespaces` argument is parsed once instead of per row.
+struct XPathBindData : public FunctionData {
+	bool has_constant_xpath = false;
+	std::string constant_xpath;
+	bool has_constant_namespaces = false;
+	NamespaceConfig constant_namespaces;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<XPathBindData>();
+		result->has_constant_xpath = has_constant_xpath;
+		result->constant_xpath = constant_xpath;
+		result->has_constant_namespaces = has_constant_namespaces;
+		result->constant_namespaces = constant_namespaces;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<XPathBindData>();
+		return has_constant_xpath == other.has_constant_xpath && constant_xpath == other.constant_xpath &&
+		       has_constant_namespaces == other.has_constant_namespaces &&
+		       constant_namespaces.mode == other.constant_namespaces.mode &&
+		       constant_namespaces.custom_namespaces == other.constant_namespaces.custom_namespaces;
+	}
+};
+
+// Per-thread compiled expressions: the bind-time constant, plus a small LRU for XPath arguments that
+// vary by row. libxml2 writes to a compiled expression while evaluating it, so nothing is shared.
+struct XPathLocalState : public FunctionLocalState {
+	std::string constant_xpath;
+	XMLCompiledXPathPtr constant_compiled;
+	XPathCompileCache cache;
+	const XPathBindData *bind_data = nullptr;
+	// Streaming plan for the constant XPath, worked out on first use by xml_exists / xml_extract_first
+	bool streaming_checked = false;
+	bool has_streaming_path = false;
+	StreamingXPath streaming_path;
+	// The client's xml_streaming_xpath_threshold, read when the query starts
+	idx_t streaming_threshold = StreamingXPathMatcher::DEFAULT_THRESHOLD;
+
+	xmlXPathCompExprPtr Lookup(const std::string &xpath) {
+		if (constant_compiled && xpath == constant_xpath) {
+			return constant_compiled.get();
+		}
+		return cache.Lookup(xpath);
+	}
+};
+
+// Captures the XPath argument in `bind_data` when it is a non-NULL constant
+static void BindConstantXPath(ClientContext &context, Expression &xpath_expr, XPathBindData &bind_data) {
+	if (!xpath_expr.IsFoldable()) {
+		return;
+	}
+	Value xpath_value = ExpressionExecutor::EvaluateScalar(context, xpath_expr);
+	if (!xpath_value.IsNull()) {
+		bind_data.has_constant_xpath = true;
+		bind_data.constant_xpath = xpath_value.ToString();
+	}
+}
+
+static unique_ptr<FunctionData> XPathArgumentBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	auto &bind_args = DUCKDB_SCALAR_BIND_ARGS;
+	auto &bind_ctx = DUCKDB_SCALAR_BIND_CONTEXT;
+
+	auto result = make_uniq<XPathBindData>();
+	if (bind_args.size() > 1) {
+		BindConstantXPath(bind_ctx, *bind_args[1], *result);
+	}
+	if (bind_args.size() > 2 && bind_args[2]->IsFoldable()) {
+		Value ns_value = ExpressionExecutor::EvaluateScalar(bind_ctx, *bind_args[2]);
+		result->has_constant_namespaces = true;
+		result->constant_namespaces = ParseNamespacesParam(ns_value);
+	}
+	return std::move(result);
+}
+
+// Bind for xml_extract_timestamp: the optional third argument is a strptime format rather than
+// namespaces, and a constant one is checked here so a bad format fails the query up front.
+static unique_ptr<FunctionData> XPathTimestampBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	auto &bind_args = DUCKDB_SCALAR_BIND_ARGS;
+	auto &bind_ctx = DUCKDB_SCALAR_BIND_CONTEXT;
+
+	auto result = make_uniq<XPathBindData>();
+	BindConstantXPath(bind_ctx, *bind_args[1], *result);
+	if (bind_args.size() > 2 && bind_args[2]->IsFoldable()) {
+		Value format_value = ExpressionExecutor::EvaluateScalar(bind_ctx, *bind_args[2]);
+		if (!format_value.IsNull()) {
+			XMLSchemaInference::ValidateDatetimeFormatString(format_value.ToString());
+		}
+	}
+	return std::move(result);
+}
+
+static unique_ptr<FunctionLocalState> XPathArgumentInitLocalState(ExpressionState &state,
+                                                                  const BoundFunctionExpression &expr,
+                                                                  FunctionData *bind_data) {
+	auto result = make_uniq<XPathLocalState>();
+	if (state.HasContext()) {
+		result->streaming_threshold = XMLUtils::GetMemorySetting(
+		    state.GetContext(), "xml_streaming_xpath_threshold", StreamingXPathMatcher::DEFAULT_THRESHOLD);
+	}
+	if (bind_data) {
+		auto &xpath_data = bind_data->Cast<XPathBindData>();
+		result->bind_data = &xpath_data;
+		if (xpath_data.has_constant_xpath) {
+			result->constant_xpath = xpath_data.constant_xpath;
+			result->constant_compiled = XMLUtils::CompileXPath(xpath_data.constant_xpath);
+		}
+	}
+	return std::move(result);
+}
+
+// Compiled form of `xpath` for this thread, or nullptr when the function was bound without
+// XPathArgumentInitLocalState (the XMLUtils extractors then compile per call).
+static xmlXPathCompExprPtr LookupCompiledXPath(ExpressionState &state, const std::string &xpath) {
+	auto local_state = ExecuteFunctionState::GetFunctionState(state);
+	if (!local_state) {
+		return nullptr;
+	}
+	return local_state->Cast<XPathLocalState>().Lookup(xpath);
+}
+
+// Streaming plan for `xpath`, or nullptr when it needs a DOM. The constant XPath's plan is kept in
+// the local state; a per-row XPath is planned into `row_path`.
+static const StreamingXPath *LookupStreamingXPath(ExpressionState &state, const std::string &xpath,
+                                                  StreamingXPath &row_path) {
+	auto local_state = ExecuteFunctionState::GetFunctionState(state);
+	if (local_state) {
+		auto &xpath_state = local_state->Cast<XPathLocalState>();
+		if (xpath_state.bind_data && xpath_state.bind_data->has_constant_xpath && xpath == xpath_state.constant_xpath) {
+			if (!xpath_state.streaming_checked) {
+				xpath_state.streaming_checked = true;
+				xpath_state.has_streaming_path = StreamingXPath::TryCompile(xpath, xpath_state.streaming_path);
+			}
+			return xpath_state.has_streaming_path ? &xpath_state.streaming_path : nullptr;
+		}
+	}
+	return StreamingXPath::TryCompile(xpath, row_path) ? &row_path : nullptr;
+}
+
+// The streaming plan to evaluate `xpath` on a row's document with, or nullptr when the row goes to
+// the DOM: the document is below xml_streaming_xpath_threshold bytes, the path does not qualify, or
+// this thread has already parsed the document.
+static const StreamingXPath *LookupRowStreamingXPath(ExpressionState &state, const string_t &xml_str,
+                                                     const std::string &xpath, StreamingXPath &row_path) {
+	auto local_state = ExecuteFunctionState::GetFunctionState(state);
+	auto threshold = local_state ? local_state->Cast<XPathLocalState>().streaming_threshold
+	                             : StreamingXPathMatcher::DEFAULT_THRESHOLD;
+	if (xml_str.GetSize() < threshold) {
+		return nullptr;
+	}
+	auto streaming_path = LookupStreamingXPath(state, xpath, row_path);
+	if (!streaming_path || XMLDocumentCache::Contains(xml_str, false)) {
+		return nullptr;
+	}
+	return streaming_path;
+}
+
+// Streams the matches of `xpath` in a row's document without building its DOM (see
+// LookupRowStreamingXPath). False when the caller must evaluate on the DOM instead.
+template <class PROCESS_NODE>
+static bool StreamRowMatches(ExpressionState &state, const string_t &xml_str, const std::string &xpath,
+                             PROCESS_NODE process_node) {
+	StreamingXPath row_path;
+	auto streaming_path = LookupRowStreamingXPath(state, xml_str, xpath, row_path);
+	if (!streaming_path) {
+		return false;
+	}
+	auto outcome =
+	    StreamingXPathMatcher::ForEachMatch(*streaming_path, xml_str.GetData(), xml_str.GetSize(), process_node);
+	return outcome != StreamingMatchResult::UNSUPPORTED;
+}
+
+// Namespace configuration for `row`: the one parsed at bind time when the `namespaces` argument is
+// constant, otherwise the row's own value parsed into `row_config`.
+static const NamespaceConfig &LookupNamespaceConfig(ExpressionState &state, Vector &ns_vector, idx_t row,
+                                                    NamespaceConfig &row_config) {
+	auto local_state = ExecuteFunctionState::GetFunctionState(state);
+	if (local_state) {
+		auto bind_data = local_state->Cast<XPathLocalState>().bind_data;
+		if (bind_data && bind_data->has_constant_namespaces) {
+			return bind_data->constant_namespaces;
+		}
+	}
+	row_config = ParseNamespacesParam(ns_vector.GetValue(row));
+	return row_config;
+}
+
 void XMLScalarFunctions::XMLValidFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &xml_vector = args.data[0];
 
 	UnaryExecutor::Execute<string_t, bool>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		return XMLUtils::IsValidXML(xml_string);
+		return XMLUtils::IsValidXML(xml_str);
 	});
 }
 
@@ -47,8 +492,7 @@ void XMLScalarFunctions::XMLWellFormedFunction(DataChunk &args, ExpressionState
 	auto &xml_vector = args.data[0];
 
 	UnaryExecutor::Execute<string_t, bool>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		return XMLUtils::IsWellFormedXML(xml_string);
+		return XMLUtils::IsWellFormedXML(xml_str);
 	});
 }
 
@@ -58,9 +502,8 @@ void XMLScalarFunctions::XMLExtractTextFunction(DataChunk &args, ExpressionState
 
 	BinaryExecutor::Execute<string_t, string_t, string_t>(
 	    xml_vector, xpath_vector, result, args.size(), [&](string_t xml_str, string_t xpath_str) {
-		    std::string xml_string = xml_str.GetString();
 		    std::string xpath_string = xpath_str.GetString();
-		    std::string extracted_text = XMLUtils::ExtractTextByXPath(xml_string, xpath_string);
+		    std::string extracted_text = XMLUtils::ExtractTextByXPath(xml_str, xpath_string);
 		    return StringVector::AddString(result, extracted_text);
 	    });
 }
@@ -68,14 +511,30 @@ void XMLScalarFunctions::XMLExtractTextFunction(DataChunk &args, ExpressionState
 void XMLScalarFunctions::XMLExtractAllTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &xml_vector = args.data[0];
 
+	const std::string text_xpath = "//text()";
+	auto compiled = XMLUtils::CompileXPath(text_xpath);
+
 	UnaryExecutor::Execute<string_t, string_t>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		// Extract all text content by getting all text nodes and concatenating them
-		auto elements = XMLUtils::ExtractByXPath(xml_string, "//text()");
-		std::string all_text;
-		for (const auto &elem : elements) {
-			all_text += elem.text_content;
+		// Concatenate the content of every text (and CDATA) node, in one streaming pass unless this
+		// thread already holds the parsed document
+		if (!XMLDocumentCache::Contains(xml_str, false)) {
+			XMLTextAnalyzer analyzer;
+			auto outcome = XMLSAXAnalysis::Run(xml_str, {&analyzer});
+			if (outcome == XMLSAXAnalysisResult::COMPLETE) {
+				return StringVector::AddString(result, analyzer.text);
+			}
+			if (outcome == XMLSAXAnalysisResult::MALFORMED) {
+				return StringVector::AddString(result, "");
+			}
 		}
+		XMLDocRAII uncached;
+		auto &doc = XMLDocumentCache::Get(xml_str, false, uncached);
+		std::string all_text;
+		ForEachMatch(doc, text_xpath, compiled.get(), [&](xmlNodePtr node) {
+			if (node->content) {
+				all_text += reinterpret_cast<const char *>(node->content);
+			}
+		});
 		return StringVector::AddString(result, all_text);
 	});
 }
@@ -86,11 +545,10 @@ void XMLScalarFunctions::XMLExtractElementsFunction(DataChunk &args, ExpressionS
 
 	BinaryExecutor::Execute<string_t, string_t, string_t>(
 	    xml_vector, xpath_vector, result, args.size(), [&](string_t xml_str, string_t xpath_str) {
-		    std::string xml_string = xml_str.GetString();
 		    std::string xpath_string = xpath_str.GetString();
 
 		    // Extract XML fragment using our new utility function
-		    std::string fragment_xml = XMLUtils::ExtractXMLFragment(xml_string, xpath_string);
+		    std::string fragment_xml = XMLUtils::ExtractXMLFragment(xml_str, xpath_string);
 
 		    return StringVector::AddString(result, fragment_xml);
 	    });
@@ -121,22 +579,19 @@ void XMLScalarFunctions::XMLExtractTextListFunction(DataChunk &args, ExpressionS
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
-		// Handle NULL values
-		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(LogicalType::VARCHAR, vector<Value>()));
-			continue;
-		}
-
-		std::string xml_string = xml_strings[xml_idx].GetString();
-		std::string xpath_string = xpath_strings[xpath_idx].GetString();
-
-		// Return LIST of all matches
-		auto texts = XMLUtils::ExtractAllTextByXPath(xml_string, xpath_string);
-		vector<Value> text_values;
-		for (const auto &text : texts) {
-			text_values.push_back(Value(text));
+		// NULL input or XPath yields an empty list
+		ListRowWriter writer(result, i);
+		if (xml_data.validity.RowIsValid(xml_idx) && xpath_data.validity.RowIsValid(xpath_idx)) {
+			auto &xml_str = xml_strings[xml_idx];
+			std::string xpath_string = xpath_strings[xpath_idx].GetString();
+			if (!StreamRowMatches(state, xml_str, xpath_string,
+			                      [&](xmlNodePtr node) { WriteTextMatch(node, writer); })) {
+				XMLDocRAII uncached;
+				auto &doc = XMLDocumentCache::Get(xml_str, false, uncached);
+				WriteTextMatches(doc, xpath_string, LookupCompiledXPath(state, xpath_string), writer);
+			}
 		}
-		result.SetValue(i, Value::LIST(LogicalType::VARCHAR, text_values));
+		writer.Finish();
 	}
 }
 
@@ -160,25 +615,21 @@ void XMLScalarFunctions::XMLExtractTextListWithNamespacesFunction(DataChunk &arg
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
+		ListRowWriter writer(result, i);
 		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(LogicalType::VARCHAR, vector<Value>()));
+			writer.Finish();
 			continue;
 		}
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
+		auto &xml_string = xml_strings[xml_idx];
 		std::string xpath_string = xpath_strings[xpath_idx].GetString();
 
-		// Parse namespace parameter
-		Value ns_value = ns_vector.GetValue(i);
-		NamespaceConfig ns_config = ParseNamespacesParam(ns_value);
+		NamespaceConfig row_config;
+		auto &ns_config = LookupNamespaceConfig(state, ns_vector, i, row_config);
 
 		// Return LIST of all matches using NamespaceConfig (handles AUTO mode transformation)
-		auto texts = XMLUtils::ExtractAllTextByXPath(xml_string, xpath_string, ns_config);
-		vector<Value> text_values;
-		for (const auto &text : texts) {
-			text_values.push_back(Value(text));
-		}
-		result.SetValue(i, Value::LIST(LogicalType::VARCHAR, text_values));
+		WriteStringList(XMLUtils::ExtractAllTextByXPath(xml_string, xpath_string, ns_config), writer);
+		writer.Finish();
 	}
 }
 
@@ -202,27 +653,25 @@ void XMLScalarFunctions::XMLExtractElementsListFunction(DataChunk &args, Express
 
 	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
 	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+	XMLNodeSerializer serializer;
 
 	for (idx_t i = 0; i < count; i++) {
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
-		// Handle NULL values
-		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(XMLTypes::XMLFragmentType(), vector<Value>()));
-			continue;
-		}
-
-		std::string xml_string = xml_strings[xml_idx].GetString();
-		std::string xpath_string = xpath_strings[xpath_idx].GetString();
-
-		// Return LIST of all matching elements
-		auto fragments = XMLUtils::ExtractXMLFragmentList(xml_string, xpath_string);
-		vector<Value> fragment_values;
-		for (const auto &fragment : fragments) {
-			fragment_values.push_back(Value(fragment));
+		// NULL input or XPath yields an empty list
+		ListRowWriter writer(result, i);
+		if (xml_data.validity.RowIsValid(xml_idx) && xpath_data.validity.RowIsValid(xpath_idx)) {
+			auto &xml_str = xml_strings[xml_idx];
+			std::string xpath_string = xpath_strings[xpath_idx].GetString();
+			if (!StreamRowMatches(state, xml_str, xpath_string,
+			                      [&](xmlNodePtr node) { WriteElementMatch(node, serializer, writer); })) {
+				XMLDocRAII uncached;
+				auto &doc = XMLDocumentCache::Get(xml_str, false, uncached);
+				WriteElementMatches(doc, xpath_string, LookupCompiledXPath(state, xpath_string), serializer, writer);
+			}
 		}
-		result.SetValue(i, Value::LIST(XMLTypes::XMLFragmentType(), fragment_values));
+		writer.Finish();
 	}
 }
 
@@ -246,25 +695,21 @@ void XMLScalarFunctions::XMLExtractElementsListWithNamespacesFunction(DataChunk
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
+		ListRowWriter writer(result, i);
 		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(XMLTypes::XMLFragmentType(), vector<Value>()));
+			writer.Finish();
 			continue;
 		}
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
+		auto &xml_string = xml_strings[xml_idx];
 		std::string xpath_string = xpath_strings[xpath_idx].GetString();
 
-		// Parse namespace parameter
-		Value ns_value = ns_vector.GetValue(i);
-		NamespaceConfig ns_config = ParseNamespacesParam(ns_value);
+		NamespaceConfig row_config;
+		auto &ns_config = LookupNamespaceConfig(state, ns_vector, i, row_config);
 
 		// Return LIST of all matching elements with namespace config (handles AUTO mode)
-		auto fragments = XMLUtils::ExtractXMLFragmentList(xml_string, xpath_string, ns_config);
-		vector<Value> fragment_values;
-		for (const auto &fragment : fragments) {
-			fragment_values.push_back(Value(fragment));
-		}
-		result.SetValue(i, Value::LIST(XMLTypes::XMLFragmentType(), fragment_values));
+		WriteStringList(XMLUtils::ExtractXMLFragmentList(xml_string, xpath_string, ns_config), writer);
+		writer.Finish();
 	}
 }
 
@@ -280,11 +725,11 @@ void XMLScalarFunctions::XMLExtractElementsStringFunction(DataChunk &args, Expre
 
 	BinaryExecutor::Execute<string_t, string_t, string_t>(
 	    xml_vector, xpath_vector, result, args.size(), [&](string_t xml_str, string_t xpath_str) {
-		    std::string xml_string = xml_str.GetString();
 		    std::string xpath_string = xpath_str.GetString();
 
 		    // Extract ALL XML fragments separated by newlines
-		    std::string fragment_xml = XMLUtils::ExtractXMLFragmentAll(xml_string, xpath_string);
+		    std::string fragment_xml =
+		        XMLUtils::ExtractXMLFragmentAll(xml_str, xpath_string, LookupCompiledXPath(state, xpath_string));
 
 		    return StringVector::AddString(result, fragment_xml);
 	    });
@@ -305,26 +750,27 @@ void XMLScalarFunctions::XMLExtractElementsStringWithNamespacesFunction(DataChun
 
 	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
 	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+	auto result_data = FlatVector::GetData<string_t>(result);
 
 	for (idx_t i = 0; i < count; i++) {
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
+		// NULL input or XPath yields an empty string
 		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value(""));
+			result_data[i] = string_t();
 			continue;
 		}
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
+		auto &xml_string = xml_strings[xml_idx];
 		std::string xpath_string = xpath_strings[xpath_idx].GetString();
 
-		// Parse namespace parameter
-		Value ns_value = ns_vector.GetValue(i);
-		NamespaceConfig ns_config = ParseNamespacesParam(ns_value);
+		NamespaceConfig row_config;
+		auto &ns_config = LookupNamespaceConfig(state, ns_vector, i, row_config);
 
 		// Extract with namespace config (handles AUTO mode)
 		std::string fragment_xml = XMLUtils::ExtractXMLFragmentAll(xml_string, xpath_string, ns_config);
-		result.SetValue(i, Value(fragment_xml));
+		result_data[i] = StringVector::AddString(result, fragment_xml);
 	}
 }
 
@@ -358,131 +804,772 @@ void XMLScalarFunctions::XMLExtractAttributesFunction(DataChunk &args, Expressio
 		XMLExtractAttributesWithNamespacesFunction(args, state, result);
 		return;
 	}
-	auto &xml_vector = args.data[0];
-	auto &xpath_vector = args.data[1];
-	auto count = args.size();
+	auto &xml_vector = args.data[0];
+	auto &xpath_vector = args.data[1];
+	auto count = args.size();
+
+	// Use UnifiedVectorFormat to handle different vector types (FLAT, DICTIONARY, CONSTANT, etc.)
+	UnifiedVectorFormat xml_data;
+	UnifiedVectorFormat xpath_data;
+	CompatToUnifiedFormat(xml_vector, count, xml_data);
+	CompatToUnifiedFormat(xpath_vector, count, xpath_data);
+
+	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
+	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+
+	// Extract attributes from elements matching XPath expression
+	std::vector<std::pair<const char *, const char *>> attributes;
+	for (idx_t i = 0; i < count; i++) {
+		auto xml_idx = xml_data.sel->get_index(i);
+		auto xpath_idx = xpath_data.sel->get_index(i);
+
+		// NULL input or XPath yields an empty list
+		ListRowWriter writer(result, i);
+		if (xml_data.validity.RowIsValid(xml_idx) && xpath_data.validity.RowIsValid(xpath_idx)) {
+			auto &xml_str = xml_strings[xml_idx];
+			std::string xpath_string = xpath_strings[xpath_idx].GetString();
+			if (!StreamRowMatches(state, xml_str, xpath_string,
+			                      [&](xmlNodePtr node) { WriteAttributeMatch(node, attributes, writer); })) {
+				XMLDocRAII uncached;
+				auto &doc = XMLDocumentCache::Get(xml_str, false, uncached);
+				WriteAttributeMatches(doc, xpath_string, LookupCompiledXPath(state, xpath_string), writer);
+			}
+		}
+		writer.Finish();
+	}
+}
+
+// Returns LIST<STRUCT> of attributes with custom namespace mappings
+void XMLScalarFunctions::XMLExtractAttributesWithNamespacesFunction(DataChunk &args, ExpressionState &state,
+                                                                    Vector &result) {
+	auto &xml_vector = args.data[0];
+	auto &xpath_vector = args.data[1];
+	auto &ns_vector = args.data[2];
+	auto count = args.size();
+
+	UnifiedVectorFormat xml_data;
+	UnifiedVectorFormat xpath_data;
+	CompatToUnifiedFormat(xml_vector, count, xml_data);
+	CompatToUnifiedFormat(xpath_vector, count, xpath_data);
+
+	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
+	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto xml_idx = xml_data.sel->get_index(i);
+		auto xpath_idx = xpath_data.sel->get_index(i);
+
+		ListRowWriter writer(result, i);
+		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
+			writer.Finish();
+			continue;
+		}
+
+		auto &xml_string = xml_strings[xml_idx];
+		std::string xpath_string = xpath_strings[xpath_idx].GetString();
+
+		NamespaceConfig row_config;
+		auto &ns_config = LookupNamespaceConfig(state, ns_vector, i, row_config);
+
+		// Extract elements and their attributes using XPath with namespace config (handles AUTO mode)
+		auto elements = XMLUtils::ExtractByXPath(xml_string, xpath_string, ns_config);
+
+		WriteAttributeList(elements, writer);
+		writer.Finish();
+	}
+}
+
+// Text of `node` without surrounding whitespace, as the typed extractors parse it
+static std::string TrimmedNodeText(xmlNodePtr node) {
+	XMLCharPtr content(xmlNodeGetContent(node));
+	std::string text = content ? std::string(reinterpret_cast<const char *>(content.get())) : std::string();
+	StringUtil::Trim(text);
+	return text;
+}
+
+// Converters for the typed XPath extractors. FromObject converts a whole XPath result (the first
+// match of a node-set, or a number/boolean/string result) and FromNode one matched node; both
+// return false for a value that is missing or does not convert, which becomes NULL.
+
+// xml_extract_number: XPath number() semantics; NaN (no match, non-numeric text) is NULL
+struct XPathNumberConverter {
+	using TYPE = double;
+
+	static bool Finite(double value, double &result) {
+		if (std::isnan(value)) {
+			return false;
+		}
+		result = value;
+		return true;
+	}
+	bool FromObject(xmlXPathObjectPtr xpath_obj, double &result) {
+		return Finite(xmlXPathCastToNumber(xpath_obj), result);
+	}
+	bool FromNode(xmlNodePtr node, double &result) {
+		return Finite(xmlXPathCastNodeToNumber(node), result);
+	}
+};
+
+// xml_extract_bigint: node text is cast exactly, not through an XPath (double) number
+struct XPathBigintConverter {
+	using TYPE = int64_t;
+
+	bool FromObject(xmlXPathObjectPtr xpath_obj, int64_t &result) {
+		switch (xpath_obj->type) {
+		case XPATH_NODESET:
+			return xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0 &&
+			       FromNode(xpath_obj->nodesetval->nodeTab[0], result);
+		case XPATH_NUMBER: {
+			// Exact like the text path: a fractional or NaN number is NULL rather than rounded
+			auto value = xpath_obj->floatval;
+			if (std::isnan(value) || value != std::trunc(value)) {
+				return false;
+			}
+			return TryCast::Operation(value, result, false);
+		}
+		case XPATH_BOOLEAN:
+			result = xpath_obj->boolval ? 1 : 0;
+			return true;
+		case XPATH_STRING: {
+			std::string text(reinterpret_cast<const char *>(xpath_obj->stringval));
+			StringUtil::Trim(text);
+			return TryCast::Operation(string_t(text), result, false);
+		}
+		default:
+			return false;
+		}
+	}
+	bool FromNode(xmlNodePtr node, int64_t &result) {
+		auto text = TrimmedNodeText(node);
+		return TryCast::Operation(string_t(text), result, false);
+	}
+};
+
+// xml_extract_boolean: node text uses read_xml's boolean spellings; XPath boolean and number
+// results convert with XPath boolean()
+struct XPathBooleanConverter {
+	using TYPE = bool;
+
+	bool FromObject(xmlXPathObjectPtr xpath_obj, bool &result) {
+		switch (xpath_obj->type) {
+		case XPATH_NODESET:
+			return xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0 &&
+			       FromNode(xpath_obj->nodesetval->nodeTab[0], result);
+		case XPATH_BOOLEAN:
+		case XPATH_NUMBER:
+			result = xmlXPathCastToBoolean(xpath_obj) != 0;
+			return true;
+		case XPATH_STRING: {
+			std::string text(reinterpret_cast<const char *>(xpath_obj->stringval));
+			StringUtil::Trim(text);
+			return XMLSchemaInference::TryParseBoolean(text, result);
+		}
+		default:
+			return false;
+		}
+	}
+	bool FromNode(xmlNodePtr node, bool &result) {
+		return XMLSchemaInference::TryParseBoolean(TrimmedNodeText(node), result);
+	}
+};
+
+// xml_extract_timestamp: node or string text parsed with a strptime format (the compiled form is
+// shared with read_xml's datetime_format), or as an ISO timestamp without one
+struct XPathTimestampConverter {
+	using TYPE = timestamp_t;
+
+	const StrpTimeFormat *format = nullptr;
+
+	bool FromText(const std::string &text, timestamp_t &result) {
+		if (format) {
+			return format->TryParseTimestamp(text.c_str(), text.size(), result);
+		}
+		return TryCast::Operation(string_t(text), result, false);
+	}
+	bool FromObject(xmlXPathObjectPtr xpath_obj, timestamp_t &result) {
+		switch (xpath_obj->type) {
+		case XPATH_NODESET:
+			return xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0 &&
+			       FromNode(xpath_obj->nodesetval->nodeTab[0], result);
+		case XPATH_STRING: {
+			std::string text(reinterpret_cast<const char *>(xpath_obj->stringval));
+			StringUtil::Trim(text);
+			return FromText(text, result);
+		}
+		default:
+			return false;
+		}
+	}
+	bool FromNode(xmlNodePtr node, timestamp_t &result) {
+		return FromText(TrimmedNodeText(node), result);
+	}
+};
+
+// Writes `xpath_obj` as one list row: a value per matched node, or a single value for a scalar
+// XPath result. Nodes that do not convert are NULL entries, keeping positions aligned with
+// xml_extract_text.
+template <class CONVERTER>
+static void WriteTypedMatches(xmlXPathObjectPtr xpath_obj, CONVERTER &converter, ListRowWriter &writer) {
+	using T = typename CONVERTER::TYPE;
+	if (xpath_obj->type != XPATH_NODESET) {
+		auto idx = writer.Append();
+		auto &child = writer.Child();
+		if (!converter.FromObject(xpath_obj, FlatVector::GetData<T>(child)[idx])) {
+			FlatVector::SetNull(child, idx, true);
+		}
+		return;
+	}
+	if (!xpath_obj->nodesetval) {
+		return;
+	}
+	for (int n = 0; n < xpath_obj->nodesetval->nodeNr; n++) {
+		auto idx = writer.Append();
+		auto &child = writer.Child();
+		if (!converter.FromNode(xpath_obj->nodesetval->nodeTab[n], FlatVector::GetData<T>(child)[idx])) {
+			FlatVector::SetNull(child, idx, true);
+		}
+	}
+}
+
+// Shared body of the typed XPath extractors. Scalar forms write the first match (or the scalar
+// XPath result) straight into the typed result vector, NULL when there is none; _list forms write
+// every match, with NULL input yielding an empty list as in xml_extract_text. `prepare_row` returns
+// false for a row whose extra arguments make it NULL.
+template <class CONVERTER, class PREPARE_ROW>
+static void ExecuteTypedXPath(DataChunk &args, ExpressionState &state, Vector &result, CONVERTER &converter,
+                              PREPARE_ROW prepare_row) {
+	using T = typename CONVERTER::TYPE;
+	auto count = args.size();
+	bool as_list = result.GetType().id() == LogicalTypeId::LIST;
+
+	UnifiedVectorFormat xml_data;
+	UnifiedVectorFormat xpath_data;
+	CompatToUnifiedFormat(args.data[0], count, xml_data);
+	CompatToUnifiedFormat(args.data[1], count, xpath_data);
+	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
+	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto xml_idx = xml_data.sel->get_index(i);
+		auto xpath_idx = xpath_data.sel->get_index(i);
+		bool row_valid = xml_data.validity.RowIsValid(xml_idx) && xpath_data.validity.RowIsValid(xpath_idx) &&
+		                 prepare_row(i);
+
+		xmlXPathObjectPtr xpath_obj = nullptr;
+		XMLDocRAII uncached;
+		if (row_valid) {
+			std::string xpath = xpath_strings[xpath_idx].GetString();
+			auto &doc = XMLDocumentCache::Get(xml_strings[xml_idx], false, uncached);
+			if (doc.IsValid() && doc.xpath_ctx) {
+				xpath_obj = XMLUtils::EvaluateXPath(xpath, doc.xpath_ctx, LookupCompiledXPath(state, xpath));
+			}
+		}
+
+		if (as_list) {
+			ListRowWriter writer(result, i);
+			if (xpath_obj) {
+				WriteTypedMatches(xpath_obj, converter, writer);
+			}
+			writer.Finish();
+		} else if (!xpath_obj || !converter.FromObject(xpath_obj, FlatVector::GetData<T>(result)[i])) {
+			FlatVector::SetNull(result, i, true);
+		}
+		if (xpath_obj) {
+			xmlXPathFreeObject(xpath_obj);
+		}
+	}
+}
+
+static bool AllRowsValid(idx_t) {
+	return true;
+}
+
+void XMLScalarFunctions::XMLExtractNumberFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XPathNumberConverter converter;
+	ExecuteTypedXPath(args, state, result, converter, AllRowsValid);
+}
+
+void XMLScalarFunctions::XMLExtractBigintFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XPathBigintConverter converter;
+	ExecuteTypedXPath(args, state, result, converter, AllRowsValid);
+}
+
+void XMLScalarFunctions::XMLExtractBooleanFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XPathBooleanConverter converter;
+	ExecuteTypedXPath(args, state, result, converter, AllRowsValid);
+}
+
+void XMLScalarFunctions::XMLExtractTimestampFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XPathTimestampConverter converter;
+	if (args.ColumnCount() < 3) {
+		ExecuteTypedXPath(args, state, result, converter, AllRowsValid);
+		return;
+	}
+	// The format is looked up again only when it changes from one row to the next; an empty format
+	// means ISO parsing, as for read_xml's datetime_format
+	UnifiedVectorFormat format_data;
+	CompatToUnifiedFormat(args.data[2], args.size(), format_data);
+	auto format_strings = UnifiedVectorFormat::GetData<string_t>(format_data);
+	bool has_current_format = false;
+	std::string current_format;
+	ExecuteTypedXPath(args, state, result, converter, [&](idx_t i) {
+		auto format_idx = format_data.sel->get_index(i);
+		if (!format_data.validity.RowIsValid(format_idx)) {
+			return false;
+		}
+		auto &format = format_strings[format_idx];
+		if (!has_current_format || current_format.size() != format.GetSize() ||
+		    memcmp(current_format.data(), format.GetData(), format.GetSize()) != 0) {
+			has_current_format = true;
+			current_format = format.GetString();
+			converter.format =
+			    current_format.empty() ? nullptr : &XMLSchemaInference::GetDatetimeFormat(current_format);
+		}
+		return true;
+	});
+}
+
+// Bind data for xml_extract_struct / html_extract_struct: one output field per XPath, in the order
+// the paths STRUCT lists them, with the field's target type (VARCHAR unless given in `types`).
+struct XPathStructBindData : public FunctionData {
+	vector<string> names;
+	vector<string> paths;
+	vector<LogicalType> types;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<XPathStructBindData>();
+		result->names = names;
+		result->paths = paths;
+		result->types = types;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<XPathStructBindData>();
+		return names == other.names && paths == other.paths && types == other.types;
+	}
+};
+
+// Per-thread compiled paths, one per field (nullptr where a path does not compile)
+struct XPathStructLocalState : public FunctionLocalState {
+	vector<XMLCompiledXPathPtr> compiled;
+};
+
+static unique_ptr<FunctionData> BindExtractStruct(ClientContext &context, vector<unique_ptr<Expression>> &arguments,
+                                                  ScalarFunction &bound_function, const string &function_name) {
+	if (arguments.size() < 2) {
+		throw BinderException("%s requires a document and a STRUCT of XPath expressions", function_name);
+	}
+
+	auto result = make_uniq<XPathStructBindData>();
+
+	// The paths STRUCT fixes the output shape, so it must be known at bind time
+	if (!arguments[1]->IsFoldable()) {
+		throw BinderException("%s paths must be a constant STRUCT, e.g. {'title': '//title', 'id': '//item/@id'}",
+		                      function_name);
+	}
+	Value paths_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+	if (paths_value.IsNull() || paths_value.type().id() != LogicalTypeId::STRUCT) {
+		throw BinderException("%s paths must be a constant STRUCT, e.g. {'title': '//title', 'id': '//item/@id'}",
+		                      function_name);
+	}
+	auto &paths_type = paths_value.type();
+	auto &path_values = StructValue::GetChildren(paths_value);
+	for (idx_t i = 0; i < path_values.size(); i++) {
+		auto &name = CompatIdentifierName(StructType::GetChildName(paths_type, i));
+		auto &path = path_values[i];
+		if (path.IsNull() || path.type().id() != LogicalTypeId::VARCHAR) {
+			throw BinderException("%s path for field '%s' must be a VARCHAR XPath expression", function_name, name);
+		}
+		result->names.push_back(name);
+		result->paths.push_back(StringValue::Get(path));
+		result->types.push_back(LogicalType::VARCHAR);
+	}
+	if (result->names.empty()) {
+		throw BinderException("%s paths needs at least one field", function_name);
+	}
+
+	// Optional `types`: a STRUCT of type names for some or all fields, positional or `types := {...}`
+	for (idx_t arg_idx = 2; arg_idx < arguments.size(); arg_idx++) {
+		auto &arg = arguments[arg_idx];
+		std::string param_name = CompatIdentifierName(arg->GetAlias());
+		if (arg_idx > 2 || (!param_name.empty() && param_name != "types")) {
+			throw BinderException("Unknown parameter '%s' for %s", param_name, function_name);
+		}
+		if (!arg->IsFoldable()) {
+			throw BinderException("%s types must be a constant STRUCT of type names", function_name);
+		}
+		Value types_value = ExpressionExecutor::EvaluateScalar(context, *arg);
+		if (types_value.IsNull() || types_value.type().id() != LogicalTypeId::STRUCT) {
+			throw BinderException("%s types must be a constant STRUCT of type names, e.g. {'id': 'INTEGER'}",
+			                      function_name);
+		}
+		auto &types_type = types_value.type();
+		auto &type_values = StructValue::GetChildren(types_value);
+		for (idx_t i = 0; i < type_values.size(); i++) {
+			auto &name = CompatIdentifierName(StructType::GetChildName(types_type, i));
+			auto &type_name = type_values[i];
+			if (type_name.IsNull() || type_name.type().id() != LogicalTypeId::VARCHAR) {
+				throw BinderException("%s type for field '%s' must be a VARCHAR type name", function_name, name);
+			}
+			auto field = std::find(result->names.begin(), result->names.end(), name);
+			if (field == result->names.end()) {
+				throw BinderException("%s types names field '%s', which is not in paths", function_name, name);
+			}
+			result->types[field - result->names.begin()] =
+			    TransformStringToLogicalType(StringValue::Get(type_name), context);
+		}
+	}
+
+	child_list_t<LogicalType> struct_fields;
+	for (idx_t i = 0; i < result->names.size(); i++) {
+		struct_fields.push_back(make_pair(CompatMakeIdentifier(result->names[i]), result->types[i]));
+	}
+	SetScalarFunctionReturnType(bound_function, LogicalType::STRUCT(std::move(struct_fields)));
+	return std::move(result);
+}
+
+unique_ptr<FunctionData> XMLScalarFunctions::XMLExtractStructBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	return BindExtractStruct(DUCKDB_SCALAR_BIND_CONTEXT, DUCKDB_SCALAR_BIND_ARGS, DUCKDB_SCALAR_BIND_FUNCTION,
+	                         "xml_extract_struct");
+}
+
+unique_ptr<FunctionData> XMLScalarFunctions::HTMLExtractStructBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	return BindExtractStruct(DUCKDB_SCALAR_BIND_CONTEXT, DUCKDB_SCALAR_BIND_ARGS, DUCKDB_SCALAR_BIND_FUNCTION,
+	                         "html_extract_struct");
+}
+
+static unique_ptr<FunctionLocalState> ExtractStructInitLocalState(ExpressionState &state,
+                                                                  const BoundFunctionExpression &expr,
+                                                                  FunctionData *bind_data) {
+	auto result = make_uniq<XPathStructLocalState>();
+	auto &struct_data = bind_data->Cast<XPathStructBindData>();
+	for (auto &path : struct_data.paths) {
+		result->compiled.push_back(XMLUtils::CompileXPath(path));
+	}
+	return std::move(result);
+}
+
+// String value of the first match: the text content of the first node of a node-set, or the XPath
+// string conversion of a scalar result (count(), string(), boolean()). False when nothing matched.
+static bool XPathFirstString(xmlXPathObjectPtr xpath_obj, std::string &value) {
+	if (!xpath_obj) {
+		return false;
+	}
+	xmlChar *content = nullptr;
+	if (xpath_obj->type == XPATH_NODESET) {
+		if (!xpath_obj->nodesetval || xpath_obj->nodesetval->nodeNr == 0) {
+			return false;
+		}
+		content = xmlNodeGetContent(xpath_obj->nodesetval->nodeTab[0]);
+	} else {
+		content = xmlXPathCastToString(xpath_obj);
+	}
+	if (!content) {
+		return false;
+	}
+	value = std::string((const char *)content);
+	xmlFree(content);
+	return true;
+}
+
+// Parses each document once and evaluates every field's compiled path against the same DOM.
+// Matches are gathered as VARCHAR and converted to the typed fields a vector at a time.
+static void ExecuteExtractStruct(DataChunk &args, ExpressionState &state, Vector &result, bool is_html) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+#ifdef DUCKDB_HAS_NEW_VECTOR_HEADERS
+	auto &bind_info = func_expr.BindInfo();
+#else
+	auto &bind_info = func_expr.bind_info;
+#endif
+	auto &struct_data = bind_info->Cast<XPathStructBindData>();
+	auto &local_state = ExecuteFunctionState::GetFunctionState(state)->Cast<XPathStructLocalState>();
+	auto count = args.size();
+	auto field_count = struct_data.names.size();
+
+	// VARCHAR fields are written in place; typed fields go through a VARCHAR staging vector
+	vector<unique_ptr<Vector>> staging(field_count);
+	vector<Vector *> text_vectors(field_count);
+	for (idx_t f = 0; f < field_count; f++) {
+		auto &field_vector = CompatStructGetField(result, f);
+		if (struct_data.types[f].id() == LogicalTypeId::VARCHAR) {
+			text_vectors[f] = &field_vector;
+		} else {
+			staging[f] = make_uniq<Vector>(LogicalType::VARCHAR, count);
+			text_vectors[f] = staging[f].get();
+		}
+	}
+
+	UnifiedVectorFormat input_data;
+	CompatToUnifiedFormat(args.data[0], count, input_data);
+	auto input_strings = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+	vector<idx_t> null_rows;
+	std::string value;
+	for (idx_t i = 0; i < count; i++) {
+		auto input_idx = input_data.sel->get_index(i);
+		bool row_valid = input_data.validity.RowIsValid(input_idx);
+		if (!row_valid) {
+			null_rows.push_back(i);
+		}
+
+		XMLDocRAII uncached;
+		auto &doc = row_valid ? XMLDocumentCache::Get(input_strings[input_idx], is_html, uncached) : uncached;
+		for (idx_t f = 0; f < field_count; f++) {
+			auto &text_vector = *text_vectors[f];
+			bool matched = false;
+			if (doc.IsValid() && doc.xpath_ctx) {
+				xmlXPathObjectPtr xpath_obj =
+				    XMLUtils::EvaluateXPath(struct_data.paths[f], doc.xpath_ctx, local_state.compiled[f].get());
+				matched = XPathFirstString(xpath_obj, value);
+				if (xpath_obj) {
+					xmlXPathFreeObject(xpath_obj);
+				}
+			}
+			if (matched) {
+				FlatVector::GetData<string_t>(text_vector)[i] = StringVector::AddString(text_vector, value);
+			} else {
+				FlatVector::SetNull(text_vector, i, true);
+			}
+		}
+	}
 
-	// Use UnifiedVectorFormat to handle different vector types (FLAT, DICTIONARY, CONSTANT, etc.)
-	UnifiedVectorFormat xml_data;
-	UnifiedVectorFormat xpath_data;
-	CompatToUnifiedFormat(xml_vector, count, xml_data);
-	CompatToUnifiedFormat(xpath_vector, count, xpath_data);
+	for (idx_t f = 0; f < field_count; f++) {
+		if (staging[f]) {
+			VectorOperations::Cast(state.GetContext(), *staging[f], CompatStructGetField(result, f), count);
+		}
+	}
+	for (auto row : null_rows) {
+		FlatVector::SetNull(result, row, true);
+	}
+}
 
-	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
-	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
+void XMLScalarFunctions::XMLExtractStructFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	ExecuteExtractStruct(args, state, result, false);
+}
 
-	// Define the struct type for attributes upfront
-	auto attr_struct_type = LogicalType::STRUCT(
-	    {make_pair("element_name", LogicalType::VARCHAR), make_pair("element_path", LogicalType::VARCHAR),
-	     make_pair("attribute_name", LogicalType::VARCHAR), make_pair("attribute_value", LogicalType::VARCHAR),
-	     make_pair("line_number", LogicalType::BIGINT)});
+void XMLScalarFunctions::HTMLExtractStructFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	ExecuteExtractStruct(args, state, result, true);
+}
 
-	// Extract attributes from elements matching XPath expression
-	for (idx_t i = 0; i < count; i++) {
-		auto xml_idx = xml_data.sel->get_index(i);
-		auto xpath_idx = xpath_data.sel->get_index(i);
+// Per-thread state of the fused extractor: each field's compiled XPath, plus its streaming plan when
+// every field is a list extractor whose path can be streamed
+struct XPathFusedLocalState : public XPathStructLocalState {
+	bool fields_stream = true;
+	vector<StreamingXPath> streaming_paths;
+	idx_t streaming_threshold = StreamingXPathMatcher::DEFAULT_THRESHOLD;
+};
+
+static unique_ptr<FunctionLocalState> ExtractFusedInitLocalState(ExpressionState &state,
+                                                                 const BoundFunctionExpression &expr,
+                                                                 FunctionData *bind_data) {
+	auto result = make_uniq<XPathFusedLocalState>();
+	auto &fused_data = bind_data->Cast<XPathFusedBindData>();
+	result->streaming_paths.resize(fused_data.paths.size());
+	for (idx_t f = 0; f < fused_data.paths.size(); f++) {
+		result->compiled.push_back(XMLUtils::CompileXPath(fused_data.paths[f]));
+		// xml_extract_elements_string always builds the DOM, so the row is not streamed at all
+		result->fields_stream = result->fields_stream && fused_data.kinds[f] != XPathExtractKind::ELEMENTS_STRING &&
+		                        StreamingXPath::TryCompile(fused_data.paths[f], result->streaming_paths[f]);
+	}
+	if (state.HasContext()) {
+		result->streaming_threshold = XMLUtils::GetMemorySetting(
+		    state.GetContext(), "xml_streaming_xpath_threshold", StreamingXPathMatcher::DEFAULT_THRESHOLD);
+	}
+	return std::move(result);
+}
 
-		// Handle NULL values
-		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(attr_struct_type, vector<Value>()));
-			continue;
+// Streams the matches of a field's `path` in `xml_str` into `writer` as its original scalar would;
+// false when the document cannot be streamed and the field must be evaluated on the DOM
+static bool StreamFusedField(XPathExtractKind kind, const StreamingXPath &path, const string_t &xml_str,
+                             XMLNodeSerializer &serializer, ListRowWriter &writer) {
+	std::vector<std::pair<const char *, const char *>> attributes;
+	auto outcome = StreamingXPathMatcher::ForEachMatch(path, xml_str.GetData(), xml_str.GetSize(), [&](xmlNodePtr node) {
+		switch (kind) {
+		case XPathExtractKind::TEXT_LIST:
+			WriteTextMatch(node, writer);
+			break;
+		case XPathExtractKind::ELEMENTS_LIST:
+			WriteElementMatch(node, serializer, writer);
+			break;
+		case XPathExtractKind::ATTRIBUTES:
+			WriteAttributeMatch(node, attributes, writer);
+			break;
+		default:
+			break;
 		}
+	});
+	return outcome != StreamingMatchResult::UNSUPPORTED;
+}
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
-		std::string xpath_string = xpath_strings[xpath_idx].GetString();
-
-		// Extract elements and their attributes using XPath
-		auto elements = XMLUtils::ExtractByXPath(xml_string, xpath_string);
+// Parses each document once and fills every field exactly as its original scalar would have
+// (including the empty-list / empty-string results for NULL and malformed input). Like the
+// original scalars, a document of at least xml_streaming_xpath_threshold bytes that this thread has
+// not parsed yet is streamed once per field instead when every field's path can be streamed.
+void XMLScalarFunctions::XMLExtractFusedFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XMLDocumentCache::Scope cache_scope(state);
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+#ifdef DUCKDB_HAS_NEW_VECTOR_HEADERS
+	auto &bind_info = func_expr.BindInfo();
+#else
+	auto &bind_info = func_expr.bind_info;
+#endif
+	auto &fused_data = bind_info->Cast<XPathFusedBindData>();
+	auto &local_state = ExecuteFunctionState::GetFunctionState(state)->Cast<XPathFusedLocalState>();
+	auto count = args.size();
+	auto field_count = fused_data.kinds.size();
 
-		// Create list of attribute structs
-		vector<Value> attr_values;
+	vector<Vector *> field_vectors(field_count);
+	for (idx_t f = 0; f < field_count; f++) {
+		field_vectors[f] = &CompatStructGetField(result, f);
+	}
 
-		for (const auto &elem : elements) {
-			// For each element, extract its attributes
-			for (const auto &attr_pair : elem.attributes) {
-				child_list_t<Value> attr_children;
-				attr_children.emplace_back("element_name", Value(elem.name));
-				attr_children.emplace_back("element_path", Value(elem.path));
-				attr_children.emplace_back("attribute_name", Value(attr_pair.first));
-				attr_children.emplace_back("attribute_value", Value(attr_pair.second));
-				attr_children.emplace_back("line_number", Value::BIGINT(elem.line_number));
+	UnifiedVectorFormat input_data;
+	CompatToUnifiedFormat(args.data[0], count, input_data);
+	auto input_strings = UnifiedVectorFormat::GetData<string_t>(input_data);
+	XMLNodeSerializer serializer;
 
-				attr_values.emplace_back(Value::STRUCT(attr_children));
+	for (idx_t i = 0; i < count; i++) {
+		auto input_idx = input_data.sel->get_index(i);
+		bool row_valid = input_data.validity.RowIsValid(input_idx);
+		auto &xml_str = input_strings[input_idx];
+		bool stream = row_valid && local_state.fields_stream && xml_str.GetSize() >= local_state.streaming_threshold &&
+		              !XMLDocumentCache::Contains(xml_str, false);
+
+		// The DOM is only parsed once a field needs it
+		XMLDocRAII uncached;
+		XMLDocRAII *doc = row_valid ? nullptr : &uncached;
+		auto get_doc = [&]() -> XMLDocRAII & {
+			if (!doc) {
+				doc = &XMLDocumentCache::Get(xml_str, false, uncached);
+			}
+			return *doc;
+		};
+		for (idx_t f = 0; f < field_count; f++) {
+			auto &field_vector = *field_vectors[f];
+			auto &path = fused_data.paths[f];
+			auto compiled = local_state.compiled[f].get();
+			auto kind = fused_data.kinds[f];
+			if (kind == XPathExtractKind::ELEMENTS_STRING) {
+				if (row_valid) {
+					FlatVector::GetData<string_t>(field_vector)[i] = StringVector::AddString(
+					    field_vector, XMLUtils::ExtractXMLFragmentAll(get_doc(), path, compiled));
+				} else {
+					FlatVector::SetNull(field_vector, i, true);
+				}
+				continue;
 			}
+			ListRowWriter writer(field_vector, i);
+			if (row_valid) {
+				// A document that cannot be streamed (e.g. it has a DOCTYPE) falls back to the DOM
+				// before any match is written
+				stream = stream && StreamFusedField(kind, local_state.streaming_paths[f], xml_str, serializer, writer);
+				if (!stream) {
+					switch (kind) {
+					case XPathExtractKind::TEXT_LIST:
+						WriteTextMatches(get_doc(), path, compiled, writer);
+						break;
+					case XPathExtractKind::ELEMENTS_LIST:
+						WriteElementMatches(get_doc(), path, compiled, serializer, writer);
+						break;
+					case XPathExtractKind::ATTRIBUTES:
+						WriteAttributeMatches(get_doc(), path, compiled, writer);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+			writer.Finish();
 		}
-
-		// Set result
-		result.SetValue(i, Value::LIST(attr_struct_type, attr_values));
 	}
 }
 
-// Returns LIST<STRUCT> of attributes with custom namespace mappings
-void XMLScalarFunctions::XMLExtractAttributesWithNamespacesFunction(DataChunk &args, ExpressionState &state,
-                                                                    Vector &result) {
-	auto &xml_vector = args.data[0];
-	auto &xpath_vector = args.data[1];
-	auto &ns_vector = args.data[2];
-	auto count = args.size();
+ScalarFunction XMLScalarFunctions::GetFusedExtractFunction(const LogicalType &input_type,
+                                                           const LogicalType &return_type) {
+	return ScalarFunction("xml_extract_fused", {input_type}, return_type, XMLExtractFusedFunction, nullptr, nullptr,
+	                      nullptr, ExtractFusedInitLocalState);
+}
 
+// Shared body of xml_exists and xml_extract_first. A row that would stream in the xml_extract_*
+// functions (LookupRowStreamingXPath) is answered by a SAX scan that stops reading the document at
+// the first match; anything else is evaluated on the DOM. `on_row(i, matched, value)` writes the row.
+template <class ON_ROW>
+static void ExecuteFirstMatch(DataChunk &args, ExpressionState &state, Vector &result, bool want_value,
+                              ON_ROW on_row) {
+	auto count = args.size();
 	UnifiedVectorFormat xml_data;
 	UnifiedVectorFormat xpath_data;
-	CompatToUnifiedFormat(xml_vector, count, xml_data);
-	CompatToUnifiedFormat(xpath_vector, count, xpath_data);
-
+	CompatToUnifiedFormat(args.data[0], count, xml_data);
+	CompatToUnifiedFormat(args.data[1], count, xpath_data);
 	auto xml_strings = UnifiedVectorFormat::GetData<string_t>(xml_data);
 	auto xpath_strings = UnifiedVectorFormat::GetData<string_t>(xpath_data);
 
-	// Define the struct type for attributes upfront
-	auto attr_struct_type = LogicalType::STRUCT(
-	    {make_pair("element_name", LogicalType::VARCHAR), make_pair("element_path", LogicalType::VARCHAR),
-	     make_pair("attribute_name", LogicalType::VARCHAR), make_pair("attribute_value", LogicalType::VARCHAR),
-	     make_pair("line_number", LogicalType::BIGINT)});
-
+	StreamingXPath row_path;
+	std::string value;
 	for (idx_t i = 0; i < count; i++) {
 		auto xml_idx = xml_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
-
 		if (!xml_data.validity.RowIsValid(xml_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(attr_struct_type, vector<Value>()));
+			FlatVector::SetNull(result, i, true);
 			continue;
 		}
+		auto &xml_str = xml_strings[xml_idx];
+		std::string xpath = xpath_strings[xpath_idx].GetString();
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
-		std::string xpath_string = xpath_strings[xpath_idx].GetString();
-
-		// Parse namespace parameter
-		Value ns_value = ns_vector.GetValue(i);
-		NamespaceConfig ns_config = ParseNamespacesParam(ns_value);
-
-		// Extract elements and their attributes using XPath with namespace config (handles AUTO mode)
-		auto elements = XMLUtils::ExtractByXPath(xml_string, xpath_string, ns_config);
-
-		// Create list of attribute structs
-		vector<Value> attr_values;
-
-		for (const auto &elem : elements) {
-			for (const auto &attr_pair : elem.attributes) {
-				child_list_t<Value> attr_children;
-				attr_children.emplace_back("element_name", Value(elem.name));
-				attr_children.emplace_back("element_path", Value(elem.path));
-				attr_children.emplace_back("attribute_name", Value(attr_pair.first));
-				attr_children.emplace_back("attribute_value", Value(attr_pair.second));
-				attr_children.emplace_back("line_number", Value::BIGINT(elem.line_number));
-
-				attr_values.emplace_back(Value::STRUCT(attr_children));
+		auto streaming_path = LookupRowStreamingXPath(state, xml_str, xpath, row_path);
+		if (streaming_path) {
+			auto outcome = StreamingXPathMatcher::FindFirst(*streaming_path, xml_str.GetData(), xml_str.GetSize(),
+			                                                want_value ? &value : nullptr);
+			if (outcome != StreamingMatchResult::UNSUPPORTED) {
+				on_row(i, outcome == StreamingMatchResult::MATCH, value);
+				continue;
 			}
 		}
 
-		result.SetValue(i, Value::LIST(attr_struct_type, attr_values));
+		XMLDocRAII uncached;
+		auto &doc = XMLDocumentCache::Get(xml_str, false, uncached);
+		xmlXPathObjectPtr xpath_obj = nullptr;
+		if (doc.IsValid() && doc.xpath_ctx) {
+			xpath_obj = XMLUtils::EvaluateXPath(xpath, doc.xpath_ctx, LookupCompiledXPath(state, xpath));
+		}
+		bool matched = false;
+		if (want_value) {
+			matched = XPathFirstString(xpath_obj, value);
+		} else if (xpath_obj) {
+			// A node-set exists when it is non-empty; a scalar result such as `count(//a) > 2` by its
+			// XPath boolean() value
+			matched = xpath_obj->type == XPATH_NODESET ? xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0
+			                                           : xmlXPathCastToBoolean(xpath_obj) != 0;
+		}
+		if (xpath_obj) {
+			xmlXPathFreeObject(xpath_obj);
+		}
+		on_row(i, matched, value);
 	}
 }
 
+void XMLScalarFunctions::XMLExistsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto result_data = FlatVector::GetData<bool>(result);
+	ExecuteFirstMatch(args, state, result, false,
+	                  [&](idx_t i, bool matched, const std::string &) { result_data[i] = matched; });
+}
+
+void XMLScalarFunctions::XMLExtractFirstFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	ExecuteFirstMatch(args, state, result, true, [&](idx_t i, bool matched, const std::string &value) {
+		if (matched) {
+			SetFlatString(result, i, value);
+		} else {
+			FlatVector::SetNull(result, i, true);
+		}
+	});
+}
+
 void XMLScalarFunctions::XMLPrettyPrintFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &xml_vector = args.data[0];
 
 	UnaryExecutor::Execute<string_t, string_t>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		std::string formatted = XMLUtils::PrettyPrintXML(xml_string);
+		std::string formatted = XMLUtils::PrettyPrintXML(xml_str);
 		return StringVector::AddString(result, formatted);
 	});
 }
@@ -491,21 +1578,89 @@ void XMLScalarFunctions::XMLMinifyFunction(DataChunk &args, ExpressionState &sta
 	auto &xml_vector = args.data[0];
 
 	UnaryExecutor::Execute<string_t, string_t>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		std::string minified = XMLUtils::MinifyXML(xml_string);
+		std::string minified = XMLUtils::MinifyXML(xml_str);
 		return StringVector::AddString(result, minified);
 	});
 }
 
+// Bind data for xml_validate_schema. A constant XSD argument is compiled here, once per query; the
+// compiled schema is shared by every thread, each of which validates through its own context.
+struct SchemaValidateBindData : public FunctionData {
+	bool has_constant_schema = false;
+	std::string constant_schema;
+	XMLSharedSchemaPtr compiled_schema; // null when the constant schema does not compile
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<SchemaValidateBindData>();
+		result->has_constant_schema = has_constant_schema;
+		result->constant_schema = constant_schema;
+		result->compiled_schema = compiled_schema;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SchemaValidateBindData>();
+		return has_constant_schema == other.has_constant_schema && constant_schema == other.constant_schema;
+	}
+};
+
+// Per-thread validators: one for the bind-time schema, plus a small LRU for schemas that vary by row
+struct SchemaValidateLocalState : public FunctionLocalState {
+	const SchemaValidateBindData *bind_data = nullptr;
+	unique_ptr<XMLSchemaValidator> constant_validator;
+	XMLSchemaCache cache;
+
+	XMLSchemaValidator *Lookup(const string_t &xsd) {
+		if (bind_data && bind_data->has_constant_schema && xsd.GetSize() == bind_data->constant_schema.size() &&
+		    memcmp(xsd.GetData(), bind_data->constant_schema.data(), xsd.GetSize()) == 0) {
+			if (!bind_data->compiled_schema) {
+				return nullptr;
+			}
+			if (!constant_validator) {
+				constant_validator = make_uniq<XMLSchemaValidator>(bind_data->compiled_schema);
+			}
+			return constant_validator.get();
+		}
+		return cache.Lookup(xsd);
+	}
+};
+
+static unique_ptr<FunctionData> XMLValidateSchemaBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	auto &bind_args = DUCKDB_SCALAR_BIND_ARGS;
+	auto &bind_ctx = DUCKDB_SCALAR_BIND_CONTEXT;
+
+	auto result = make_uniq<SchemaValidateBindData>();
+	if (bind_args[1]->IsFoldable()) {
+		Value schema_value = ExpressionExecutor::EvaluateScalar(bind_ctx, *bind_args[1]);
+		if (!schema_value.IsNull()) {
+			result->has_constant_schema = true;
+			result->constant_schema = schema_value.ToString();
+			result->compiled_schema =
+			    XMLSchemaValidator::Compile(result->constant_schema.data(), result->constant_schema.size());
+		}
+	}
+	return std::move(result);
+}
+
+static unique_ptr<FunctionLocalState> XMLValidateSchemaInitLocalState(ExpressionState &state,
+                                                                      const BoundFunctionExpression &expr,
+                                                                      FunctionData *bind_data) {
+	auto result = make_uniq<SchemaValidateLocalState>();
+	if (bind_data) {
+		result->bind_data = &bind_data->Cast<SchemaValidateBindData>();
+	}
+	return std::move(result);
+}
+
 void XMLScalarFunctions::XMLValidateSchemaFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &xml_vector = args.data[0];
 	auto &schema_vector = args.data[1];
+	auto &local_state = ExecuteFunctionState::GetFunctionState(state)->Cast<SchemaValidateLocalState>();
 
 	BinaryExecutor::Execute<string_t, string_t, bool>(xml_vector, schema_vector, result, args.size(),
 	                                                  [&](string_t xml_str, string_t schema_str) {
-		                                                  std::string xml_string = xml_str.GetString();
-		                                                  std::string schema_string = schema_str.GetString();
-		                                                  return XMLUtils::ValidateXMLSchema(xml_string, schema_string);
+		                                                  auto validator = local_state.Lookup(schema_str);
+		                                                  return validator && validator->Validate(xml_str);
 	                                                  });
 }
 
@@ -513,26 +1668,10 @@ void XMLScalarFunctions::XMLExtractCommentsFunction(DataChunk &args, ExpressionS
 	auto &xml_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const std::string &xml_string) {
-		auto comments = XMLUtils::ExtractComments(xml_string);
-
-		// Create list of comment structs
-		vector<Value> comment_values;
-
-		for (const auto &comment : comments) {
-			child_list_t<Value> comment_children;
-			comment_children.emplace_back("content", Value(comment.content));
-			comment_children.emplace_back("line_number", Value::BIGINT(comment.line_number));
-
-			comment_values.emplace_back(Value::STRUCT(comment_children));
-		}
-
-		// Create list value
-		auto comment_struct_type = LogicalType::STRUCT(
-		    {make_pair("content", LogicalType::VARCHAR), make_pair("line_number", LogicalType::BIGINT)});
-
-		Value list_value = Value::LIST(comment_struct_type, comment_values);
-		result.SetValue(i, list_value);
+	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const string_t &xml_string) {
+		ListRowWriter writer(result, i);
+		WriteCommentList(XMLUtils::ExtractComments(xml_string), writer);
+		writer.Finish();
 	});
 }
 
@@ -540,26 +1679,10 @@ void XMLScalarFunctions::XMLExtractCDataFunction(DataChunk &args, ExpressionStat
 	auto &xml_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const std::string &xml_string) {
-		auto cdata_sections = XMLUtils::ExtractCData(xml_string);
-
-		// Create list of CDATA structs
-		vector<Value> cdata_values;
-
-		for (const auto &cdata : cdata_sections) {
-			child_list_t<Value> cdata_children;
-			cdata_children.emplace_back("content", Value(cdata.content));
-			cdata_children.emplace_back("line_number", Value::BIGINT(cdata.line_number));
-
-			cdata_values.emplace_back(Value::STRUCT(cdata_children));
-		}
-
-		// Create list value
-		auto cdata_struct_type = LogicalType::STRUCT(
-		    {make_pair("content", LogicalType::VARCHAR), make_pair("line_number", LogicalType::BIGINT)});
-
-		Value list_value = Value::LIST(cdata_struct_type, cdata_values);
-		result.SetValue(i, list_value);
+	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const string_t &xml_string) {
+		ListRowWriter writer(result, i);
+		WriteCommentList(XMLUtils::ExtractCData(xml_string), writer);
+		writer.Finish();
 	});
 }
 
@@ -567,7 +1690,7 @@ void XMLScalarFunctions::XMLStatsFunction(DataChunk &args, ExpressionState &stat
 	auto &xml_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const std::string &xml_string) {
+	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const string_t &xml_string) {
 		auto stats = XMLUtils::GetXMLStats(xml_string);
 
 		// Create stats struct
@@ -587,7 +1710,7 @@ void XMLScalarFunctions::XMLNamespacesFunction(DataChunk &args, ExpressionState
 	auto &xml_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const std::string &xml_string) {
+	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const string_t &xml_string) {
 		auto namespaces = XMLUtils::ExtractNamespaces(xml_string);
 
 		// Create MAP(VARCHAR, VARCHAR) with prefix -> uri mappings
@@ -653,7 +1776,7 @@ std::string RunOOMSelfTest() {
 	if (xmlMemSetup(OOMNoopFree, OOMFailMalloc, OOMFailRealloc, OOMFailStrdup) != 0) {
 		return "OK (oom check skipped: custom allocator could not be installed)";
 	}
-	XMLValidity validity = XMLUtils::CheckXML("<r/>");
+	XMLValidity validity = XMLUtils::CheckXML(std::string("<r/>"));
 	// Restore the real allocators before anything else allocates through libxml2.
 	xmlMemSetup(saved_free, saved_malloc, saved_realloc, saved_strdup);
 
@@ -759,34 +1882,8 @@ void XMLScalarFunctions::XMLDetectPrefixesFunction(DataChunk &args, ExpressionSt
 	auto &xpath_vector = args.data[0];
 	auto count = args.size();
 
-	// Regex pattern to match namespace prefixes in XPath
-	// Matches: prefix:name where prefix is NCName (valid XML name without colon)
-	// NCName pattern: [A-Za-z_][A-Za-z0-9._-]*
-	// We look for prefix: followed by a valid name character
-	// But we need to exclude axis specifiers like "child::", "descendant::", etc.
-	static const std::regex prefix_pattern(
-	    R"((?:^|[/\[\(@,|])([A-Za-z_][A-Za-z0-9._-]*):(?!:)([A-Za-z_*][A-Za-z0-9._-]*))", std::regex::optimize);
-
-	// XPath axes to exclude (these use :: not single :)
-	static const std::set<std::string> xpath_axes = {
-	    "ancestor",  "ancestor-or-self",  "attribute", "child",  "descendant", "descendant-or-self",
-	    "following", "following-sibling", "namespace", "parent", "preceding",  "preceding-sibling",
-	    "self"};
-
-	ExecuteNullSafeString(xpath_vector, result, count, [&](idx_t i, const std::string &xpath) {
-		// Find all prefixes
-		std::set<std::string> prefixes;
-		std::sregex_iterator iter(xpath.begin(), xpath.end(), prefix_pattern);
-		std::sregex_iterator end;
-
-		while (iter != end) {
-			std::string prefix = (*iter)[1].str();
-			// Don't include XPath axis specifiers
-			if (xpath_axes.find(prefix) == xpath_axes.end()) {
-				prefixes.insert(prefix);
-			}
-			++iter;
-		}
+	ExecuteNullSafeString(xpath_vector, result, count, [&](idx_t i, const string_t &xpath_str) {
+		auto prefixes = DetectXPathPrefixes(xpath_str.GetString());
 
 		// Create LIST<VARCHAR> result
 		vector<Value> prefix_values;
@@ -853,7 +1950,7 @@ void XMLScalarFunctions::XMLFindUndefinedPrefixesFunction(DataChunk &args, Expre
 			continue;
 		}
 
-		std::string xml_string = xml_strings[xml_idx].GetString();
+		auto &xml_string = xml_strings[xml_idx];
 		std::string xpath = xpath_strings[xpath_idx].GetString();
 
 		// Get prefixes used in XPath
@@ -889,7 +1986,7 @@ void XMLScalarFunctions::XMLAddNamespaceDeclarationsFunction(DataChunk &args, Ex
 	auto &ns_map_vector = args.data[1];
 	auto count = args.size();
 
-	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const std::string &xml_string) {
+	ExecuteNullSafeString(xml_vector, result, count, [&](idx_t i, const string_t &xml_string) {
 		auto ns_map_value = ns_map_vector.GetValue(i);
 
 		// Parse the MAP value into case_insensitive_map
@@ -907,7 +2004,7 @@ void XMLScalarFunctions::XMLAddNamespaceDeclarationsFunction(DataChunk &args, Ex
 		}
 
 		// Inject the namespaces
-		std::string modified_xml = InjectNamespaceDeclarations(xml_string, namespaces_to_inject);
+		std::string modified_xml = InjectNamespaceDeclarations(xml_string.GetString(), namespaces_to_inject);
 		result.SetValue(i, StringVector::AddString(result, modified_xml));
 	});
 }
@@ -919,8 +2016,8 @@ void XMLScalarFunctions::XMLLookupNamespaceFunction(DataChunk &args, ExpressionS
 	auto &prefix_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(prefix_vector, result, count, [&](idx_t i, const std::string &prefix) {
-		std::string uri = GetCommonNamespaceURI(prefix);
+	ExecuteNullSafeString(prefix_vector, result, count, [&](idx_t i, const string_t &prefix) {
+		std::string uri = GetCommonNamespaceURI(prefix.GetString());
 		if (uri.empty()) {
 			FlatVector::SetNull(result, i, true);
 		} else {
@@ -932,10 +2029,10 @@ void XMLScalarFunctions::XMLLookupNamespaceFunction(DataChunk &args, ExpressionS
 void XMLScalarFunctions::XMLToJSONFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &xml_vector = args.data[0];
 
+	XMLToJSONWriter writer {XMLToJSONOptions()};
+
 	UnaryExecutor::Execute<string_t, string_t>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		std::string json_string = XMLUtils::XMLToJSON(xml_string);
-		return StringVector::AddString(result, json_string);
+		return StringVector::AddString(result, XMLUtils::XMLToJSON(xml_str, writer));
 	});
 }
 
@@ -1071,116 +2168,215 @@ void XMLScalarFunctions::XMLToJSONWithSchemaFunction(DataChunk &args, Expression
 	}
 
 	auto &xml_vector = args.data[0];
+	// One writer for the chunk: its buffers are reused from row to row
+	XMLToJSONWriter writer(options);
 
 	UnaryExecutor::Execute<string_t, string_t>(xml_vector, result, args.size(), [&](string_t xml_str) {
-		std::string xml_string = xml_str.GetString();
-		std::string json_string = XMLUtils::XMLToJSON(xml_string, options);
-		return StringVector::AddString(result, json_string);
+		return StringVector::AddString(result, XMLUtils::XMLToJSON(xml_str, writer));
 	});
 }
 
+// Bind data for xml_to_struct: the STRUCT each document's root element is written as
+struct XMLToStructBindData : public FunctionData {
+	LogicalType type;
+	XMLSchemaOptions options;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<XMLToStructBindData>();
+		result->type = type;
+		result->options = options;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<XMLToStructBindData>();
+		return type == other.type;
+	}
+};
+
+unique_ptr<FunctionData> XMLScalarFunctions::XMLToStructBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	auto &arguments = DUCKDB_SCALAR_BIND_ARGS;
+	auto &context = DUCKDB_SCALAR_BIND_CONTEXT;
+
+	// The type fixes the output shape, so it must be known at bind time
+	if (arguments.size() != 2) {
+		throw BinderException("xml_to_struct requires a document and a STRUCT type, e.g. "
+		                      "'STRUCT(id INTEGER, name VARCHAR)' or {'id': 'INTEGER', 'name': 'VARCHAR'}");
+	}
+	auto &type_arg = arguments[1];
+	if (type_arg->HasParameter()) {
+		throw ParameterNotResolvedException();
+	}
+	if (!type_arg->IsFoldable()) {
+		throw BinderException("xml_to_struct type must be a constant");
+	}
+	Value type_value = ExpressionExecutor::EvaluateScalar(context, *type_arg);
+	if (type_value.IsNull()) {
+		throw BinderException("xml_to_struct type cannot be NULL");
+	}
+
+	auto result = make_uniq<XMLToStructBindData>();
+	if (type_value.type().id() == LogicalTypeId::VARCHAR) {
+		result->type = TransformStringToLogicalType(StringValue::Get(type_value), context);
+	} else if (type_value.type().id() == LogicalTypeId::STRUCT) {
+		// A STRUCT of type names, as read_xml's `columns`
+		auto &names_type = type_value.type();
+		auto &type_names = StructValue::GetChildren(type_value);
+		child_list_t<LogicalType> fields;
+		for (idx_t i = 0; i < type_names.size(); i++) {
+			auto &name = CompatIdentifierName(StructType::GetChildName(names_type, i));
+			auto &type_name = type_names[i];
+			if (type_name.IsNull() || type_name.type().id() != LogicalTypeId::VARCHAR) {
+				throw BinderException("xml_to_struct type for field '%s' must be a VARCHAR type name", name);
+			}
+			fields.push_back(make_pair(CompatMakeIdentifier(name),
+			                           TransformStringToLogicalType(StringValue::Get(type_name), context)));
+		}
+		result->type = LogicalType::STRUCT(std::move(fields));
+	} else {
+		throw BinderException("xml_to_struct type must be a VARCHAR type name or a STRUCT of type names, got %s",
+		                      type_value.type().ToString());
+	}
+	if (result->type.id() != LogicalTypeId::STRUCT) {
+		throw BinderException("xml_to_struct type must be a STRUCT, got %s", result->type.ToString());
+	}
+
+	// A value that does not convert to its field's type is NULL rather than an error
+	result->options.ignore_errors = true;
+	SetScalarFunctionReturnType(DUCKDB_SCALAR_BIND_FUNCTION, result->type);
+	return std::move(result);
+}
+
+// Writes each document's root element into the STRUCT as read_xml writes a nested column: fields
+// from attributes, child elements and '#text', LIST and STRUCT fields straight into their child
+// vectors, with no JSON text or Value tree in between
+void XMLScalarFunctions::XMLToStructFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+#ifdef DUCKDB_HAS_NEW_VECTOR_HEADERS
+	auto &bind_info = func_expr.BindInfo();
+#else
+	auto &bind_info = func_expr.bind_info;
+#endif
+	auto &struct_data = bind_info->Cast<XMLToStructBindData>();
+	auto count = args.size();
+
+	UnifiedVectorFormat input_data;
+	CompatToUnifiedFormat(args.data[0], count, input_data);
+	auto input_strings = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto input_idx = input_data.sel->get_index(i);
+		if (!input_data.validity.RowIsValid(input_idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		XMLDocRAII uncached;
+		auto &doc = XMLDocumentCache::Get(input_strings[input_idx], false, uncached);
+		xmlNodePtr root = doc.IsValid() ? xmlDocGetRootElement(doc.doc) : nullptr;
+		if (!root) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		XMLSchemaInference::WriteNodeToVector(root, struct_data.type, struct_data.options, result, i);
+	}
+}
+
 void XMLScalarFunctions::JSONToXMLFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &json_vector = args.data[0];
 
+	// One output buffer for the whole chunk
+	std::string xml;
+	std::string error;
 	UnaryExecutor::Execute<string_t, string_t>(json_vector, result, args.size(), [&](string_t json_str) {
-		std::string json_string = json_str.GetString();
-		std::string xml_string = XMLUtils::JSONToXML(json_string);
-		return StringVector::AddString(result, xml_string);
+		if (!XMLUtils::TryJSONToXML(json_str, xml, error)) {
+			throw InvalidInputException("json_to_xml: %s", error);
+		}
+		return StringVector::AddString(result, xml);
 	});
 }
 
-void XMLScalarFunctions::ValueToXMLFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &input_vector = args.data[0];
-	auto &input_type = input_vector.GetType();
-
-	// Type debugging (can be removed in production)
-	// printf("DEBUG to_xml: input_type=%s, id=%d, has_alias=%s, alias=%s\n",
-	//	input_type.ToString().c_str(),
-	//	(int)input_type.id(),
-	//	input_type.HasAlias() ? "true" : "false",
-	//	input_type.HasAlias() ? input_type.GetAlias().c_str() : "none");
-
-	// Get node name (default "xml" if not provided)
-	std::string default_node_name = "xml";
-	if (args.ColumnCount() == 2) {
-		// Node name provided as second argument - for now, assume it's constant
-		// TODO: Handle variable node names per row
-		auto &node_name_vector = args.data[1];
-		if (node_name_vector.GetVectorType() == VectorType::CONSTANT_VECTOR) {
-			auto node_name_data = ConstantVector::GetData<string_t>(node_name_vector);
-			if (!ConstantVector::IsNull(node_name_vector)) {
-				default_node_name = node_name_data->GetString();
+// Bind data for to_xml / xml: the root element name, when it is the same for every row
+struct ValueToXMLBindData : public FunctionData {
+	bool has_constant_name = true;
+	std::string constant_name = "xml";
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto result = make_uniq<ValueToXMLBindData>();
+		result->has_constant_name = has_constant_name;
+		result->constant_name = constant_name;
+		return std::move(result);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<ValueToXMLBindData>();
+		return has_constant_name == other.has_constant_name && constant_name == other.constant_name;
+	}
+};
+
+unique_ptr<FunctionData> XMLScalarFunctions::ValueToXMLBind(DUCKDB_SCALAR_BIND_PARAMS) {
+	auto &arguments = DUCKDB_SCALAR_BIND_ARGS;
+	auto &context = DUCKDB_SCALAR_BIND_CONTEXT;
+
+	// Names become element names; reject any that would inject markup into the trusted xml-typed
+	// output (e.g. to_xml(v, 'a><evil')) before anything runs
+	if (arguments[0]->HasParameter()) {
+		throw ParameterNotResolvedException();
+	}
+	XMLValueSerializer::ValidateFieldNames(arguments[0]->return_type);
+
+	auto result = make_uniq<ValueToXMLBindData>();
+	if (arguments.size() == 2) {
+		auto &name_arg = arguments[1];
+		if (name_arg->HasParameter()) {
+			throw ParameterNotResolvedException();
+		}
+		if (name_arg->IsFoldable()) {
+			Value name_value = ExpressionExecutor::EvaluateScalar(context, *name_arg);
+			// A NULL name keeps the default. Arguments are not cast to VARCHAR until after binding.
+			if (!name_value.IsNull()) {
+				result->constant_name = StringValue::Get(name_value.DefaultCastAs(LogicalType::VARCHAR));
 			}
+			XMLUtils::ValidateXMLElementName(result->constant_name);
+		} else {
+			result->has_constant_name = false;
 		}
 	}
-	// The node name becomes an element name; reject any that would inject markup into the
-	// trusted xml-typed output (e.g. to_xml(v, 'a><evil')).
-	XMLUtils::ValidateXMLElementName(default_node_name);
+	return std::move(result);
+}
 
-	// Apply our type hierarchy
-	if (XMLTypes::IsXMLFragmentType(input_type)) {
-		// XMLFragment → Insert verbatim
-		UnaryExecutor::Execute<string_t, string_t>(input_vector, result, args.size(), [&](string_t input) {
-			return StringVector::AddString(result, input.GetString());
-		});
-	} else if (XMLTypes::IsXMLType(input_type)) {
-		// XML → Insert verbatim
-		UnaryExecutor::Execute<string_t, string_t>(input_vector, result, args.size(), [&](string_t input) {
-			return StringVector::AddString(result, input.GetString());
-		});
-	} else if (input_type.id() == LogicalTypeId::LIST) {
-		// LIST → Recursive conversion
-		XMLUtils::ConvertListToXML(input_vector, result, args.size(), default_node_name);
-	} else if (input_type.id() == LogicalTypeId::STRUCT) {
-		// STRUCT → Recursive conversion
-		XMLUtils::ConvertStructToXML(input_vector, result, args.size(), default_node_name);
-	} else {
-		// Check if this is an explicit JSON type (has JSON alias)
-		bool is_json_type = false;
+// Serializes a vector at a time: LIST and STRUCT values are read from their child vectors and the
+// markup is written into one buffer reused from row to row, with no libxml2 tree per value
+void XMLScalarFunctions::ValueToXMLFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+#ifdef DUCKDB_HAS_NEW_VECTOR_HEADERS
+	auto &bind_info = func_expr.BindInfo();
+#else
+	auto &bind_info = func_expr.bind_info;
+#endif
+	auto &name_data = bind_info->Cast<ValueToXMLBindData>();
+	auto count = args.size();
 
-		try {
-			// Only check for explicit JSON type (has JSON alias)
-			is_json_type =
-			    (input_type.id() == LogicalTypeId::VARCHAR && input_type.HasAlias() && input_type.GetAlias() == "JSON");
-		} catch (...) {
-			// Error in detection, treat as non-JSON
-			is_json_type = false;
-		}
-
-		if (is_json_type) {
-			// JSON → Structural conversion (same as JSON::XML casting)
-			UnaryExecutor::Execute<string_t, string_t>(input_vector, result, args.size(), [&](string_t json_input) {
-				std::string json_str = json_input.GetString();
-				std::string xml_result = XMLUtils::JSONToXML(json_str);
-				return StringVector::AddString(result, xml_result);
-			});
-		} else {
-			// STRING/Other → Convert to string representation, then to XML
-			for (idx_t i = 0; i < args.size(); i++) {
-				Value input_value = input_vector.GetValue(i);
-				std::string input_str;
-
-				if (input_value.IsNull()) {
-					// NULL in -> NULL out
-					result.SetValue(i, Value(result.GetType()));
-					continue;
-				} else if (input_type.id() == LogicalTypeId::VARCHAR) {
-					input_str = input_value.GetValue<string>();
-				} else {
-					// Convert any other type to string representation
-					input_str = input_value.ToString();
-				}
+	XMLValueSerializer serializer;
+	serializer.Initialize(args.data[0], count);
 
-				// Check if input is already valid XML (only for string types)
-				if (input_type.id() == LogicalTypeId::VARCHAR && XMLUtils::IsValidXML(input_str)) {
-					result.SetValue(i, Value(input_str));
-				} else {
-					// Convert scalar value to XML using libxml2
-					std::string xml_result = XMLUtils::ScalarToXML(input_str, default_node_name);
-					result.SetValue(i, Value(xml_result));
-				}
-			}
+	// Names that vary by row are validated as they change
+	UnifiedVectorFormat names;
+	if (!name_data.has_constant_name) {
+		CompatToUnifiedFormat(args.data[1], count, names);
+	}
+	XMLValueSerializer::ElementName row_name(name_data.constant_name);
+
+	auto result_data = FlatVector::GetData<string_t>(result);
+	std::string xml;
+	for (idx_t i = 0; i < count; i++) {
+		if (!serializer.RowIsValid(i)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
 		}
+		auto &name = name_data.has_constant_name ? name_data.constant_name : row_name.Read(names, i);
+		xml.clear();
+		serializer.WriteDocument(i, name, xml);
+		result_data[i] = StringVector::AddString(result, xml);
 	}
 }
 
@@ -1195,18 +2391,27 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 		SetScalarFunctionVarArgs(fn, LogicalType::ANY);
 		set.AddFunction(std::move(fn));
 	};
+	// Helper: build an XPath extraction overload whose XPath argument (the second) is compiled once
+	// per thread when it is constant, and through a per-thread LRU otherwise.
+	auto xpath_function = [](vector<LogicalType> arguments, LogicalType return_type, scalar_function_t function) {
+		return ScalarFunction(std::move(arguments), std::move(return_type), std::move(function), XPathArgumentBind,
+		                      nullptr, nullptr, XPathArgumentInitLocalState);
+	};
 
 	// Register xml function (same as to_xml for now) - using VARCHAR for now, will enhance type system later
-	auto xml_function = ScalarFunction("xml", {LogicalType::VARCHAR}, LogicalType::VARCHAR, ValueToXMLFunction);
+	auto xml_function = ScalarFunction("xml", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                                   ExecuteDistinctInputs<ValueToXMLFunction>, ValueToXMLBind);
 	loader.RegisterFunction(xml_function);
 
 	// Register to_xml function (single argument) - ANY type variant (unified path)
-	auto to_xml_any_function = ScalarFunction("to_xml", {LogicalType::ANY}, XMLTypes::XMLType(), ValueToXMLFunction);
+	auto to_xml_any_function = ScalarFunction("to_xml", {LogicalType::ANY}, XMLTypes::XMLType(),
+	                                          ExecuteDistinctInputs<ValueToXMLFunction>, ValueToXMLBind);
 	loader.RegisterFunction(to_xml_any_function);
 
 	// Register to_xml function (two arguments: value, node_name) - ANY type variant (unified path)
 	auto to_xml_any_with_name_function =
-	    ScalarFunction("to_xml", {LogicalType::ANY, LogicalType::VARCHAR}, XMLTypes::XMLType(), ValueToXMLFunction);
+	    ScalarFunction("to_xml", {LogicalType::ANY, LogicalType::VARCHAR}, XMLTypes::XMLType(),
+	                   ExecuteDistinctInputs<ValueToXMLFunction>, ValueToXMLBind);
 	loader.RegisterFunction(to_xml_any_with_name_function);
 
 	// Register xml_libxml2_version function
@@ -1223,18 +2428,22 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 
 	// Register xml_valid function - both XML and VARCHAR overloads
 	auto xml_valid_function =
-	    ScalarFunction("xml_valid", {XMLTypes::XMLType()}, LogicalType::BOOLEAN, XMLValidFunction);
+	    ScalarFunction("xml_valid", {XMLTypes::XMLType()}, LogicalType::BOOLEAN,
+	                   ExecuteDistinctInputs<XMLValidFunction>);
 	loader.RegisterFunction(xml_valid_function);
 	auto xml_valid_varchar_function =
-	    ScalarFunction("xml_valid", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, XMLValidFunction);
+	    ScalarFunction("xml_valid", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+	                   ExecuteDistinctInputs<XMLValidFunction>);
 	loader.RegisterFunction(xml_valid_varchar_function);
 
 	// Register xml_well_formed function - both XML and VARCHAR overloads
 	auto xml_well_formed_function =
-	    ScalarFunction("xml_well_formed", {XMLTypes::XMLType()}, LogicalType::BOOLEAN, XMLWellFormedFunction);
+	    ScalarFunction("xml_well_formed", {XMLTypes::XMLType()}, LogicalType::BOOLEAN,
+	                   ExecuteDistinctInputs<XMLWellFormedFunction>);
 	loader.RegisterFunction(xml_well_formed_function);
 	auto xml_well_formed_varchar_function =
-	    ScalarFunction("xml_well_formed", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, XMLWellFormedFunction);
+	    ScalarFunction("xml_well_formed", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+	                   ExecuteDistinctInputs<XMLWellFormedFunction>);
 	loader.RegisterFunction(xml_well_formed_varchar_function);
 
 	// Register xml_extract_text function - returns LIST(VARCHAR) (PostgreSQL-compatible)
@@ -1242,62 +2451,68 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 	ScalarFunctionSet xml_extract_text_functions("xml_extract_text");
 
 	// XML + VARCHAR -> LIST(VARCHAR)
-	add_ns_aware(xml_extract_text_functions, ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_text_functions, xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR},
 	                                                        LogicalType::LIST(LogicalType::VARCHAR),
-	                                                        XMLExtractTextListFunction));
+	                                                        ExecuteDistinctInputs<XMLExtractTextListFunction>));
 	// XML + STRING_LITERAL -> LIST(VARCHAR)
 	// (no varargs on STRING_LITERAL overloads: varargs + a literal parameter makes DuckDB resolve a
 	//  literal return type and trip an internal error. The named-arg case routes through the VARCHAR
 	//  overload below, with the literal xpath implicitly cast to VARCHAR.)
 	xml_extract_text_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(LogicalType::VARCHAR), XMLExtractTextListFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(LogicalType::VARCHAR), ExecuteDistinctInputs<XMLExtractTextListFunction>));
 	// XMLFragment + VARCHAR -> LIST(VARCHAR)
-	add_ns_aware(xml_extract_text_functions, ScalarFunction({XMLTypes::XMLFragmentType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_text_functions, xpath_function({XMLTypes::XMLFragmentType(), LogicalType::VARCHAR},
 	                                                        LogicalType::LIST(LogicalType::VARCHAR),
-	                                                        XMLExtractTextListFunction));
+	                                                        ExecuteDistinctInputs<XMLExtractTextListFunction>));
 	// XMLFragment + STRING_LITERAL -> LIST(VARCHAR)
 	xml_extract_text_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLFragmentType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(LogicalType::VARCHAR), XMLExtractTextListFunction));
+	    xpath_function({XMLTypes::XMLFragmentType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(LogicalType::VARCHAR), ExecuteDistinctInputs<XMLExtractTextListFunction>));
 	// VARCHAR + VARCHAR -> LIST(VARCHAR) (compatibility)
-	add_ns_aware(xml_extract_text_functions, ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_text_functions, xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR},
 	                                                        LogicalType::LIST(LogicalType::VARCHAR),
-	                                                        XMLExtractTextListFunction));
+	                                                        ExecuteDistinctInputs<XMLExtractTextListFunction>));
 	// VARCHAR + STRING_LITERAL -> LIST(VARCHAR) (compatibility)
 	xml_extract_text_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(LogicalType::VARCHAR), XMLExtractTextListFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(LogicalType::VARCHAR), ExecuteDistinctInputs<XMLExtractTextListFunction>));
 
 	// 3-argument variants with namespaces MAP
 	auto ns_map_type = LogicalType::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR);
 	// XML + VARCHAR + MAP -> LIST(VARCHAR)
-	xml_extract_text_functions.AddFunction(ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type},
-	                                                      LogicalType::LIST(LogicalType::VARCHAR),
-	                                                      XMLExtractTextListWithNamespacesFunction));
+	xml_extract_text_functions.AddFunction(
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type},
+	                   LogicalType::LIST(LogicalType::VARCHAR),
+	                   ExecuteDistinctInputs<XMLExtractTextListWithNamespacesFunction>));
 	// VARCHAR + VARCHAR + MAP -> LIST(VARCHAR)
-	xml_extract_text_functions.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type},
-	                                                      LogicalType::LIST(LogicalType::VARCHAR),
-	                                                      XMLExtractTextListWithNamespacesFunction));
+	xml_extract_text_functions.AddFunction(
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type},
+	                   LogicalType::LIST(LogicalType::VARCHAR),
+	                   ExecuteDistinctInputs<XMLExtractTextListWithNamespacesFunction>));
 
 	// 3-argument variants with namespace mode VARCHAR ('auto', 'strict', 'ignore')
 	// XML + VARCHAR + VARCHAR (mode) -> LIST(VARCHAR)
 	xml_extract_text_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(LogicalType::VARCHAR), XMLExtractTextListWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(LogicalType::VARCHAR),
+	                   ExecuteDistinctInputs<XMLExtractTextListWithNamespacesFunction>));
 	// VARCHAR + VARCHAR + VARCHAR (mode) -> LIST(VARCHAR)
 	xml_extract_text_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(LogicalType::VARCHAR), XMLExtractTextListWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(LogicalType::VARCHAR),
+	                   ExecuteDistinctInputs<XMLExtractTextListWithNamespacesFunction>));
 
 	loader.RegisterFunction(xml_extract_text_functions);
 
 	// Register xml_extract_all_text function - both XML and VARCHAR overloads
 	auto xml_extract_all_text_function =
-	    ScalarFunction("xml_extract_all_text", {XMLTypes::XMLType()}, LogicalType::VARCHAR, XMLExtractAllTextFunction);
+	    ScalarFunction("xml_extract_all_text", {XMLTypes::XMLType()}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractAllTextFunction>);
 	loader.RegisterFunction(xml_extract_all_text_function);
 	auto xml_extract_all_text_varchar_function =
-	    ScalarFunction("xml_extract_all_text", {LogicalType::VARCHAR}, LogicalType::VARCHAR, XMLExtractAllTextFunction);
+	    ScalarFunction("xml_extract_all_text", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractAllTextFunction>);
 	loader.RegisterFunction(xml_extract_all_text_varchar_function);
 
 	// Register xml_extract_elements function - returns LIST(XMLFragment) (PostgreSQL-compatible)
@@ -1305,83 +2520,104 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 	ScalarFunctionSet xml_extract_elements_functions("xml_extract_elements");
 
 	// XML + VARCHAR -> LIST(XMLFragment)
-	add_ns_aware(xml_extract_elements_functions, ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_elements_functions, xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR},
 	                                                            LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                            XMLExtractElementsListFunction));
+	                                                            ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// XML + STRING_LITERAL -> LIST(XMLFragment)
 	// (STRING_LITERAL overloads stay varargs-free; see note on xml_extract_text above.)
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// HTML + VARCHAR -> LIST(XMLFragment)
-	add_ns_aware(xml_extract_elements_functions, ScalarFunction({XMLTypes::HTMLType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_elements_functions, xpath_function({XMLTypes::HTMLType(), LogicalType::VARCHAR},
 	                                                            LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                            XMLExtractElementsListFunction));
+	                                                            ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// HTML + STRING_LITERAL -> LIST(XMLFragment)
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({XMLTypes::HTMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListFunction));
+	    xpath_function({XMLTypes::HTMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// XMLFragment + VARCHAR -> LIST(XMLFragment) (for nested extraction)
-	add_ns_aware(xml_extract_elements_functions, ScalarFunction({XMLTypes::XMLFragmentType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_elements_functions, xpath_function({XMLTypes::XMLFragmentType(), LogicalType::VARCHAR},
 	                                                            LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                            XMLExtractElementsListFunction));
+	                                                            ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// XMLFragment + STRING_LITERAL -> LIST(XMLFragment)
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLFragmentType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListFunction));
+	    xpath_function({XMLTypes::XMLFragmentType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// VARCHAR + VARCHAR -> LIST(XMLFragment) (compatibility)
-	add_ns_aware(xml_extract_elements_functions, ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_elements_functions, xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR},
 	                                                            LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                            XMLExtractElementsListFunction));
+	                                                            ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 	// VARCHAR + STRING_LITERAL -> LIST(XMLFragment) (compatibility)
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListFunction>));
 
 	// 3-argument variants with namespaces MAP
 	// XML + VARCHAR + MAP -> LIST(XMLFragment)
-	xml_extract_elements_functions.AddFunction(ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type},
-	                                                          LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                          XMLExtractElementsListWithNamespacesFunction));
+	xml_extract_elements_functions.AddFunction(
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListWithNamespacesFunction>));
 	// VARCHAR + VARCHAR + MAP -> LIST(XMLFragment)
-	xml_extract_elements_functions.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type},
-	                                                          LogicalType::LIST(XMLTypes::XMLFragmentType()),
-	                                                          XMLExtractElementsListWithNamespacesFunction));
+	xml_extract_elements_functions.AddFunction(
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListWithNamespacesFunction>));
 
 	// 3-argument variants with namespace mode VARCHAR ('auto', 'strict', 'ignore')
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListWithNamespacesFunction>));
 	xml_extract_elements_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(XMLTypes::XMLFragmentType()), XMLExtractElementsListWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(XMLTypes::XMLFragmentType()),
+	                   ExecuteDistinctInputs<XMLExtractElementsListWithNamespacesFunction>));
 
 	loader.RegisterFunction(xml_extract_elements_functions);
 
 	// Register xml_extract_elements_string function as a function set
 	ScalarFunctionSet xml_extract_elements_string_functions("xml_extract_elements_string");
 	add_ns_aware(xml_extract_elements_string_functions,
-	             ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR}, LogicalType::VARCHAR,
-	                            XMLExtractElementsStringFunction));
+	             xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                            ExecuteDistinctInputs<XMLExtractElementsStringFunction>));
 	add_ns_aware(xml_extract_elements_string_functions,
-	             ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
-	                            XMLExtractElementsStringFunction));
+	             xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                            ExecuteDistinctInputs<XMLExtractElementsStringFunction>));
 	// 3-argument variants with namespaces MAP
 	xml_extract_elements_string_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::VARCHAR,
-	                   XMLExtractElementsStringWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractElementsStringWithNamespacesFunction>));
 	xml_extract_elements_string_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type}, LogicalType::VARCHAR,
-	                   XMLExtractElementsStringWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractElementsStringWithNamespacesFunction>));
 	// 3-argument variants with namespace mode VARCHAR
 	xml_extract_elements_string_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
-	                   XMLExtractElementsStringWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractElementsStringWithNamespacesFunction>));
 	xml_extract_elements_string_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
-	                   XMLExtractElementsStringWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                   ExecuteDistinctInputs<XMLExtractElementsStringWithNamespacesFunction>));
 	loader.RegisterFunction(xml_extract_elements_string_functions);
 
+	// Register xml_extract_struct: parse once per row and evaluate a STRUCT of XPaths against the same DOM,
+	// returning one (optionally typed) field per path. varargs carries the optional `types` argument.
+	ScalarFunctionSet xml_extract_struct_functions("xml_extract_struct");
+	for (auto &input_type : vector<LogicalType> {XMLTypes::XMLType(), LogicalType::VARCHAR}) {
+		ScalarFunction xml_extract_struct({input_type, LogicalType::ANY}, LogicalType(LogicalTypeId::STRUCT),
+		                                  ExecuteDistinctInputs<XMLExtractStructFunction>, XMLExtractStructBind,
+		                                  nullptr, nullptr, ExtractStructInitLocalState);
+		SetScalarFunctionVarArgs(xml_extract_struct, LogicalType::ANY);
+		xml_extract_struct_functions.AddFunction(std::move(xml_extract_struct));
+	}
+	PreventStructConstantFolding(xml_extract_struct_functions);
+	loader.RegisterFunction(xml_extract_struct_functions);
+
 	// Register xml_wrap_fragment function (returns XML)
 	auto xml_wrap_fragment_function = ScalarFunction("xml_wrap_fragment", {LogicalType::VARCHAR, LogicalType::VARCHAR},
 	                                                 XMLTypes::XMLType(), XMLWrapFragmentFunction);
@@ -1394,38 +2630,85 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 	     make_pair("line_number", LogicalType::BIGINT)});
 	// Register xml_extract_attributes function as a function set
 	ScalarFunctionSet xml_extract_attributes_functions("xml_extract_attributes");
-	add_ns_aware(xml_extract_attributes_functions, ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR},
+	add_ns_aware(xml_extract_attributes_functions, xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR},
 	                                                              LogicalType::LIST(attr_struct_type),
-	                                                              XMLExtractAttributesFunction));
-	add_ns_aware(xml_extract_attributes_functions, ScalarFunction({XMLTypes::HTMLType(), LogicalType::VARCHAR},
+	                                                              ExecuteDistinctInputs<XMLExtractAttributesFunction>));
+	add_ns_aware(xml_extract_attributes_functions, xpath_function({XMLTypes::HTMLType(), LogicalType::VARCHAR},
 	                                                              LogicalType::LIST(attr_struct_type),
-	                                                              XMLExtractAttributesFunction));
-	add_ns_aware(xml_extract_attributes_functions, ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                                                              ExecuteDistinctInputs<XMLExtractAttributesFunction>));
+	add_ns_aware(xml_extract_attributes_functions, xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR},
 	                                                              LogicalType::LIST(attr_struct_type),
-	                                                              XMLExtractAttributesFunction));
+	                                                              ExecuteDistinctInputs<XMLExtractAttributesFunction>));
 	// Add 3-argument variants with namespace map
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
-	                   XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({XMLTypes::HTMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
-	                   XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({XMLTypes::HTMLType(), LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
-	                   XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, ns_map_type}, LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	// Add 3-argument variants with namespace mode VARCHAR
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(attr_struct_type), XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({XMLTypes::XMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({XMLTypes::HTMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(attr_struct_type), XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({XMLTypes::HTMLType(), LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	xml_extract_attributes_functions.AddFunction(
-	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                   LogicalType::LIST(attr_struct_type), XMLExtractAttributesWithNamespacesFunction));
+	    xpath_function({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                   LogicalType::LIST(attr_struct_type),
+	                   ExecuteDistinctInputs<XMLExtractAttributesWithNamespacesFunction>));
 	PreventStructConstantFolding(xml_extract_attributes_functions);
 	loader.RegisterFunction(xml_extract_attributes_functions);
 
+	// Register xml_exists / xml_extract_first: early-exit forms of len(xml_extract_text(...)) > 0
+	// and xml_extract_text(...)[1]
+	ScalarFunctionSet xml_exists_functions("xml_exists");
+	ScalarFunctionSet xml_extract_first_functions("xml_extract_first");
+	for (auto &document_type : {XMLTypes::XMLType(), LogicalType(LogicalType::VARCHAR)}) {
+		xml_exists_functions.AddFunction(xpath_function({document_type, LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+		                                                ExecuteDistinctInputs<XMLExistsFunction>));
+		xml_extract_first_functions.AddFunction(xpath_function({document_type, LogicalType::VARCHAR},
+		                                                       LogicalType::VARCHAR,
+		                                                       ExecuteDistinctInputs<XMLExtractFirstFunction>));
+	}
+	loader.RegisterFunction(xml_exists_functions);
+	loader.RegisterFunction(xml_extract_first_functions);
+
+	// Register the typed extractors: `name` returns the first match as `type`, `name_list` every
+	// match as LIST(type). With `format_argument`, each also takes an optional trailing format.
+	auto register_typed_extract = [&](const string &name, const LogicalType &type, scalar_function_t function,
+	                                  bind_scalar_function_t bind, bool format_argument) {
+		ScalarFunctionSet scalar_set(name);
+		ScalarFunctionSet list_set(name + "_list");
+		for (auto &document_type : {XMLTypes::XMLType(), LogicalType(LogicalType::VARCHAR)}) {
+			vector<LogicalType> arguments {document_type, LogicalType::VARCHAR};
+			for (idx_t variant = 0; variant < (format_argument ? 2 : 1); variant++) {
+				if (variant > 0) {
+					arguments.push_back(LogicalType::VARCHAR);
+				}
+				scalar_set.AddFunction(
+				    ScalarFunction(arguments, type, function, bind, nullptr, nullptr, XPathArgumentInitLocalState));
+				list_set.AddFunction(ScalarFunction(arguments, LogicalType::LIST(type), function, bind, nullptr,
+				                                    nullptr, XPathArgumentInitLocalState));
+			}
+		}
+		loader.RegisterFunction(scalar_set);
+		loader.RegisterFunction(list_set);
+	};
+	register_typed_extract("xml_extract_number", LogicalType::DOUBLE, ExecuteDistinctInputs<XMLExtractNumberFunction>,
+	                       XPathArgumentBind, false);
+	register_typed_extract("xml_extract_bigint", LogicalType::BIGINT, ExecuteDistinctInputs<XMLExtractBigintFunction>,
+	                       XPathArgumentBind, false);
+	register_typed_extract("xml_extract_boolean", LogicalType::BOOLEAN,
+	                       ExecuteDistinctInputs<XMLExtractBooleanFunction>, XPathArgumentBind, false);
+	register_typed_extract("xml_extract_timestamp", LogicalType::TIMESTAMP,
+	                       ExecuteDistinctInputs<XMLExtractTimestampFunction>, XPathTimestampBind, true);
+
 	// Register xml_pretty_print function
 	auto xml_pretty_print_function =
 	    ScalarFunction("xml_pretty_print", {LogicalType::VARCHAR}, LogicalType::VARCHAR, XMLPrettyPrintFunction);
@@ -1439,7 +2722,8 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 	// Register xml_validate_schema function
 	auto xml_validate_schema_function =
 	    ScalarFunction("xml_validate_schema", {LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::BOOLEAN,
-	                   XMLValidateSchemaFunction);
+	                   ExecuteDistinctInputs<XMLValidateSchemaFunction>, XMLValidateSchemaBind, nullptr, nullptr,
+	                   XMLValidateSchemaInitLocalState);
 	loader.RegisterFunction(xml_validate_schema_function);
 
 	// Register xml_extract_comments function (returns LIST<STRUCT>)
@@ -1447,13 +2731,14 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 	    {make_pair("content", LogicalType::VARCHAR), make_pair("line_number", LogicalType::BIGINT)});
 	auto xml_extract_comments_function =
 	    ScalarFunction("xml_extract_comments", {XMLTypes::XMLType()}, LogicalType::LIST(comment_struct_type),
-	                   XMLExtractCommentsFunction);
+	                   ExecuteDistinctInputs<XMLExtractCommentsFunction>);
 	PreventStructConstantFolding(xml_extract_comments_function);
 	loader.RegisterFunction(xml_extract_comments_function);
 
 	// Register xml_extract_cdata function (returns LIST<STRUCT>)
 	auto xml_extract_cdata_function = ScalarFunction("xml_extract_cdata", {XMLTypes::XMLType()},
-	                                                 LogicalType::LIST(comment_struct_type), XMLExtractCDataFunction);
+	                                                 LogicalType::LIST(comment_struct_type),
+	                                                 ExecuteDistinctInputs<XMLExtractCDataFunction>);
 	PreventStructConstantFolding(xml_extract_cdata_function);
 	loader.RegisterFunction(xml_extract_cdata_function);
 
@@ -1524,11 +2809,21 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 
 	// Register xml_to_json function with optional named parameters
 	ScalarFunction xml_to_json_function("xml_to_json", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
-	                                    XMLToJSONWithSchemaFunction, XMLToJSONWithSchemaBind);
+	                                    ExecuteDistinctInputs<XMLToJSONWithSchemaFunction>, XMLToJSONWithSchemaBind);
 	SetScalarFunctionVarArgs(xml_to_json_function, LogicalType::ANY);
 	SetScalarFunctionNullHandling(xml_to_json_function, FunctionNullHandling::SPECIAL_HANDLING);
 	loader.RegisterFunction(xml_to_json_function);
 
+	// Register xml_to_struct: the root element of each document as a STRUCT of the given type
+	ScalarFunctionSet xml_to_struct_functions("xml_to_struct");
+	for (auto &input_type : vector<LogicalType> {XMLTypes::XMLType(), LogicalType::VARCHAR}) {
+		ScalarFunction xml_to_struct({input_type, LogicalType::ANY}, LogicalType(LogicalTypeId::STRUCT),
+		                             ExecuteDistinctInputs<XMLToStructFunction>, XMLToStructBind);
+		xml_to_struct_functions.AddFunction(std::move(xml_to_struct));
+	}
+	PreventStructConstantFolding(xml_to_struct_functions);
+	loader.RegisterFunction(xml_to_struct_functions);
+
 	// Register json_to_xml function
 	auto json_to_xml_function =
 	    ScalarFunction("json_to_xml", {LogicalType::VARCHAR}, LogicalType::VARCHAR, JSONToXMLFunction);
@@ -1576,16 +2871,16 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 
 	// HTML only (no XPath) -> VARCHAR (all text concatenated, unchanged behavior)
 	html_extract_text_functions.AddFunction(
-	    ScalarFunction({XMLTypes::HTMLType()}, LogicalType::VARCHAR, HTMLExtractTextFunction));
+	    ScalarFunction({XMLTypes::HTMLType()}, LogicalType::VARCHAR, ExecuteDistinctInputs<HTMLExtractTextFunction>));
 
 	// HTML + VARCHAR XPath -> LIST(VARCHAR)
-	html_extract_text_functions.AddFunction(ScalarFunction({XMLTypes::HTMLType(), LogicalType::VARCHAR},
+	html_extract_text_functions.AddFunction(xpath_function({XMLTypes::HTMLType(), LogicalType::VARCHAR},
 	                                                       LogicalType::LIST(LogicalType::VARCHAR),
-	                                                       HTMLExtractTextListFunction));
+	                                                       ExecuteDistinctInputs<HTMLExtractTextListFunction>));
 	// HTML + STRING_LITERAL XPath -> LIST(VARCHAR)
 	html_extract_text_functions.AddFunction(
-	    ScalarFunction({XMLTypes::HTMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
-	                   LogicalType::LIST(LogicalType::VARCHAR), HTMLExtractTextListFunction));
+	    xpath_function({XMLTypes::HTMLType(), LogicalType(LogicalTypeId::STRING_LITERAL)},
+	                   LogicalType::LIST(LogicalType::VARCHAR), ExecuteDistinctInputs<HTMLExtractTextListFunction>));
 	// NOTE: Namespace parameter overloads intentionally omitted for html_extract_text.
 	// HTML5 parsing (htmlReadMemory) doesn't support XML namespace declarations -
 	// prefixed elements like "svg:circle" are treated as literal names with colons.
@@ -1593,31 +2888,42 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 
 	loader.RegisterFunction(html_extract_text_functions);
 
+	// Register html_extract_struct (HTML twin of xml_extract_struct)
+	ScalarFunctionSet html_extract_struct_functions("html_extract_struct");
+	ScalarFunction html_extract_struct({XMLTypes::HTMLType(), LogicalType::ANY}, LogicalType(LogicalTypeId::STRUCT),
+	                                   ExecuteDistinctInputs<HTMLExtractStructFunction>, HTMLExtractStructBind, nullptr,
+	                                   nullptr, ExtractStructInitLocalState);
+	SetScalarFunctionVarArgs(html_extract_struct, LogicalType::ANY);
+	html_extract_struct_functions.AddFunction(std::move(html_extract_struct));
+	PreventStructConstantFolding(html_extract_struct_functions);
+	loader.RegisterFunction(html_extract_struct_functions);
+
 	// Register html_extract_links function
 	auto html_extract_links_function =
 	    ScalarFunction("html_extract_links", {XMLTypes::HTMLType()}, LogicalType::LIST(html_link_struct_type),
-	                   HTMLExtractLinksFunction);
+	                   ExecuteDistinctInputs<HTMLExtractLinksFunction>);
 	PreventStructConstantFolding(html_extract_links_function);
 	loader.RegisterFunction(html_extract_links_function);
 
 	// Register html_extract_images function
 	auto html_extract_images_function =
 	    ScalarFunction("html_extract_images", {XMLTypes::HTMLType()}, LogicalType::LIST(html_image_struct_type),
-	                   HTMLExtractImagesFunction);
+	                   ExecuteDistinctInputs<HTMLExtractImagesFunction>);
 	PreventStructConstantFolding(html_extract_images_function);
 	loader.RegisterFunction(html_extract_images_function);
 
 	// Register html_extract_table_rows function
 	auto html_extract_table_rows_function =
 	    ScalarFunction("html_extract_table_rows", {XMLTypes::HTMLType()}, LogicalType::LIST(html_table_row_struct_type),
-	                   HTMLExtractTableRowsFunction);
+	                   ExecuteDistinctInputs<HTMLExtractTableRowsFunction>);
 	PreventStructConstantFolding(html_extract_table_rows_function);
 	loader.RegisterFunction(html_extract_table_rows_function);
 
 	// Register html_extract_tables_json function
 	auto html_extract_tables_json_function =
 	    ScalarFunction("html_extract_tables_json", {XMLTypes::HTMLType()},
-	                   LogicalType::LIST(html_table_json_struct_type), HTMLExtractTablesJSONFunction);
+	                   LogicalType::LIST(html_table_json_struct_type),
+	                   ExecuteDistinctInputs<HTMLExtractTablesJSONFunction>);
 	PreventStructConstantFolding(html_extract_tables_json_function);
 	loader.RegisterFunction(html_extract_tables_json_function);
 
@@ -1639,30 +2945,31 @@ void XMLScalarFunctions::Register(ExtensionLoader &loader) {
 
 // HTML-specific extraction function implementations
 void XMLScalarFunctions::HTMLExtractTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XMLDocumentCache::Scope cache_scope(state);
 	auto &html_vector = args.data[0];
 
 	UnaryExecutor::Execute<string_t, string_t>(html_vector, result, args.size(), [&](string_t html_str) {
-		std::string html_string = html_str.GetString();
-		std::string extracted_text = XMLUtils::ExtractHTMLText(html_string);
+		std::string extracted_text = XMLUtils::ExtractHTMLText(html_str);
 		return StringVector::AddString(result, extracted_text);
 	});
 }
 
 void XMLScalarFunctions::HTMLExtractTextWithXPathFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XMLDocumentCache::Scope cache_scope(state);
 	auto &html_vector = args.data[0];
 	auto &xpath_vector = args.data[1];
 
 	BinaryExecutor::Execute<string_t, string_t, string_t>(
 	    html_vector, xpath_vector, result, args.size(), [&](string_t html_str, string_t xpath_str) {
-		    std::string html_string = html_str.GetString();
 		    std::string xpath_string = xpath_str.GetString();
-		    std::string extracted_text = XMLUtils::ExtractHTMLTextByXPath(html_string, xpath_string);
+		    std::string extracted_text = XMLUtils::ExtractHTMLTextByXPath(html_str, xpath_string);
 		    return StringVector::AddString(result, extracted_text);
 	    });
 }
 
 // Returns LIST(VARCHAR) of all matching HTML text content (PostgreSQL-compatible)
 void XMLScalarFunctions::HTMLExtractTextListFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	XMLDocumentCache::Scope cache_scope(state);
 	auto &html_vector = args.data[0];
 	auto &xpath_vector = args.data[1];
 	auto count = args.size();
@@ -1680,22 +2987,15 @@ void XMLScalarFunctions::HTMLExtractTextListFunction(DataChunk &args, Expression
 		auto html_idx = html_data.sel->get_index(i);
 		auto xpath_idx = xpath_data.sel->get_index(i);
 
-		// Handle NULL values
-		if (!html_data.validity.RowIsValid(html_idx) || !xpath_data.validity.RowIsValid(xpath_idx)) {
-			result.SetValue(i, Value::LIST(LogicalType::VARCHAR, vector<Value>()));
-			continue;
-		}
-
-		std::string html_string = html_strings[html_idx].GetString();
-		std::string xpath_string = xpath_strings[xpath_idx].GetString();
-
-		// Return LIST of all matches
-		auto texts = XMLUtils::ExtractHTMLAllTextByXPath(html_string, xpath_string);
-		vector<Value> text_values;
-		for (const auto &text : texts) {
-			text_values.push_back(Value(text));
+		// NULL input or XPath yields an empty list
+		ListRowWriter writer(result, i);
+		if (html_data.validity.RowIsValid(html_idx) && xpath_data.validity.RowIsValid(xpath_idx)) {
+			std::string xpath_string = xpath_strings[xpath_idx].GetString();
+			XMLDocRAII uncached;
+			auto &doc = XMLDocumentCache::Get(html_strings[html_idx], true, uncached);
+			WriteTextMatches(doc, xpath_string, LookupCompiledXPath(state, xpath_string), writer);
 		}
-		result.SetValue(i, Value::LIST(LogicalType::VARCHAR, text_values));
+		writer.Finish();
 	}
 }
 
@@ -1708,26 +3008,21 @@ void XMLScalarFunctions::HTMLExtractLinksFunction(DataChunk &args, ExpressionSta
 	auto &html_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const std::string &html_string) {
-		auto links = XMLUtils::ExtractHTMLLinks(html_string);
-
-		vector<Value> link_values;
-		for (const auto &link : links) {
-			child_list_t<Value> link_children;
-			link_children.emplace_back("text", Value(link.text));
-			link_children.emplace_back("href", Value(link.url));
-			link_children.emplace_back("title", link.title.empty() ? Value() : Value(link.title));
-			link_children.emplace_back("line_number", Value::BIGINT(link.line_number));
-
-			link_values.emplace_back(Value::STRUCT(link_children));
+	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const string_t &html_string) {
+		ListRowWriter writer(result, i);
+		for (const auto &link : XMLUtils::ExtractHTMLLinks(html_string)) {
+			auto idx = writer.Append();
+			auto &entries = writer.Child();
+			SetFlatString(CompatStructGetField(entries, 0), idx, link.text);
+			SetFlatString(CompatStructGetField(entries, 1), idx, link.url);
+			if (link.title.empty()) {
+				FlatVector::SetNull(CompatStructGetField(entries, 2), idx, true);
+			} else {
+				SetFlatString(CompatStructGetField(entries, 2), idx, link.title);
+			}
+			SetFlatBigint(CompatStructGetField(entries, 3), idx, link.line_number);
 		}
-
-		auto link_struct_type = LogicalType::STRUCT(
-		    {make_pair("text", LogicalType::VARCHAR), make_pair("href", LogicalType::VARCHAR),
-		     make_pair("title", LogicalType::VARCHAR), make_pair("line_number", LogicalType::BIGINT)});
-
-		Value list_value = Value::LIST(link_struct_type, link_values);
-		result.SetValue(i, list_value);
+		writer.Finish();
 	});
 }
 
@@ -1735,29 +3030,23 @@ void XMLScalarFunctions::HTMLExtractImagesFunction(DataChunk &args, ExpressionSt
 	auto &html_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const std::string &html_string) {
-		auto images = XMLUtils::ExtractHTMLImages(html_string);
-
-		vector<Value> image_values;
-		for (const auto &image : images) {
-			child_list_t<Value> image_children;
-			image_children.emplace_back("alt", Value(image.alt_text));
-			image_children.emplace_back("src", Value(image.src));
-			image_children.emplace_back("title", image.title.empty() ? Value() : Value(image.title));
-			image_children.emplace_back("width", Value::BIGINT(image.width));
-			image_children.emplace_back("height", Value::BIGINT(image.height));
-			image_children.emplace_back("line_number", Value::BIGINT(image.line_number));
-
-			image_values.emplace_back(Value::STRUCT(image_children));
+	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const string_t &html_string) {
+		ListRowWriter writer(result, i);
+		for (const auto &image : XMLUtils::ExtractHTMLImages(html_string)) {
+			auto idx = writer.Append();
+			auto &entries = writer.Child();
+			SetFlatString(CompatStructGetField(entries, 0), idx, image.alt_text);
+			SetFlatString(CompatStructGetField(entries, 1), idx, image.src);
+			if (image.title.empty()) {
+				FlatVector::SetNull(CompatStructGetField(entries, 2), idx, true);
+			} else {
+				SetFlatString(CompatStructGetField(entries, 2), idx, image.title);
+			}
+			SetFlatBigint(CompatStructGetField(entries, 3), idx, image.width);
+			SetFlatBigint(CompatStructGetField(entries, 4), idx, image.height);
+			SetFlatBigint(CompatStructGetField(entries, 5), idx, image.line_number);
 		}
-
-		auto image_struct_type = LogicalType::STRUCT(
-		    {make_pair("alt", LogicalType::VARCHAR), make_pair("src", LogicalType::VARCHAR),
-		     make_pair("title", LogicalType::VARCHAR), make_pair("width", LogicalType::BIGINT),
-		     make_pair("height", LogicalType::BIGINT), make_pair("line_number", LogicalType::BIGINT)});
-
-		Value list_value = Value::LIST(image_struct_type, image_values);
-		result.SetValue(i, list_value);
+		writer.Finish();
 	});
 }
 
@@ -1765,55 +3054,38 @@ void XMLScalarFunctions::HTMLExtractTableRowsFunction(DataChunk &args, Expressio
 	auto &html_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const std::string &html_string) {
+	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const string_t &html_string) {
 		auto tables = XMLUtils::ExtractHTMLTables(html_string);
 
-		vector<Value> row_values;
-
-		// Process each table
-		for (size_t table_idx = 0; table_idx < tables.size(); table_idx++) {
+		// One entry per cell: header cells have row_index 0, data rows count from 1
+		ListRowWriter writer(result, i);
+		auto append_cell = [&](idx_t table_idx, const char *row_type, idx_t row_idx, idx_t col_idx,
+		                       const std::string &cell_value) {
 			const auto &table = tables[table_idx];
-
-			// Output header cells
-			for (size_t col_idx = 0; col_idx < table.headers.size(); col_idx++) {
-				child_list_t<Value> row_children;
-				row_children.emplace_back("table_index", Value::BIGINT(static_cast<int64_t>(table_idx)));
-				row_children.emplace_back("row_type", Value("header"));
-				row_children.emplace_back("row_index", Value::BIGINT(0));
-				row_children.emplace_back("column_index", Value::BIGINT(static_cast<int64_t>(col_idx)));
-				row_children.emplace_back("cell_value", Value(table.headers[col_idx]));
-				row_children.emplace_back("line_number", Value::BIGINT(table.line_number));
-				row_children.emplace_back("num_columns", Value::BIGINT(table.num_columns));
-				row_children.emplace_back("num_rows", Value::BIGINT(table.num_rows));
-				row_values.emplace_back(Value::STRUCT(row_children));
+			auto idx = writer.Append();
+			auto &entries = writer.Child();
+			SetFlatBigint(CompatStructGetField(entries, 0), idx, static_cast<int64_t>(table_idx));
+			SetFlatString(CompatStructGetField(entries, 1), idx, row_type, strlen(row_type));
+			SetFlatBigint(CompatStructGetField(entries, 2), idx, static_cast<int64_t>(row_idx));
+			SetFlatBigint(CompatStructGetField(entries, 3), idx, static_cast<int64_t>(col_idx));
+			SetFlatString(CompatStructGetField(entries, 4), idx, cell_value);
+			SetFlatBigint(CompatStructGetField(entries, 5), idx, table.line_number);
+			SetFlatBigint(CompatStructGetField(entries, 6), idx, table.num_columns);
+			SetFlatBigint(CompatStructGetField(entries, 7), idx, table.num_rows);
+		};
+		for (idx_t table_idx = 0; table_idx < tables.size(); table_idx++) {
+			const auto &table = tables[table_idx];
+			for (idx_t col_idx = 0; col_idx < table.headers.size(); col_idx++) {
+				append_cell(table_idx, "header", 0, col_idx, table.headers[col_idx]);
 			}
-
-			// Output data rows
-			for (size_t row_idx = 0; row_idx < table.rows.size(); row_idx++) {
+			for (idx_t row_idx = 0; row_idx < table.rows.size(); row_idx++) {
 				const auto &row = table.rows[row_idx];
-				for (size_t col_idx = 0; col_idx < row.size(); col_idx++) {
-					child_list_t<Value> row_children;
-					row_children.emplace_back("table_index", Value::BIGINT(static_cast<int64_t>(table_idx)));
-					row_children.emplace_back("row_type", Value("data"));
-					row_children.emplace_back("row_index", Value::BIGINT(static_cast<int64_t>(row_idx + 1)));
-					row_children.emplace_back("column_index", Value::BIGINT(static_cast<int64_t>(col_idx)));
-					row_children.emplace_back("cell_value", Value(row[col_idx]));
-					row_children.emplace_back("line_number", Value::BIGINT(table.line_number));
-					row_children.emplace_back("num_columns", Value::BIGINT(table.num_columns));
-					row_children.emplace_back("num_rows", Value::BIGINT(table.num_rows));
-					row_values.emplace_back(Value::STRUCT(row_children));
+				for (idx_t col_idx = 0; col_idx < row.size(); col_idx++) {
+					append_cell(table_idx, "data", row_idx + 1, col_idx, row[col_idx]);
 				}
 			}
 		}
-
-		auto table_row_struct_type = LogicalType::STRUCT(
-		    {make_pair("table_index", LogicalType::BIGINT), make_pair("row_type", LogicalType::VARCHAR),
-		     make_pair("row_index", LogicalType::BIGINT), make_pair("column_index", LogicalType::BIGINT),
-		     make_pair("cell_value", LogicalType::VARCHAR), make_pair("line_number", LogicalType::BIGINT),
-		     make_pair("num_columns", LogicalType::BIGINT), make_pair("num_rows", LogicalType::BIGINT)});
-
-		Value list_value = Value::LIST(table_row_struct_type, row_values);
-		result.SetValue(i, list_value);
+		writer.Finish();
 	});
 }
 
@@ -1821,7 +3093,7 @@ void XMLScalarFunctions::HTMLExtractTablesJSONFunction(DataChunk &args, Expressi
 	auto &html_vector = args.data[0];
 	auto count = args.size();
 
-	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const std::string &html_string) {
+	ExecuteNullSafeString(html_vector, result, count, [&](idx_t i, const string_t &html_string) {
 		auto tables = XMLUtils::ExtractHTMLTables(html_string);
 
 		vector<Value> table_values;
@@ -2060,16 +3332,14 @@ void XMLScalarFunctions::ReadHTMLFunction(DataChunk &args, ExpressionState &stat
 
 	UnaryExecutor::Execute<string_t, string_t>(
 	    html_content_vector, result, args.size(), [&](string_t html_content_str) {
-		    std::string html_content = html_content_str.GetString();
-
 		    // Handle empty HTML content gracefully
-		    if (html_content.empty()) {
+		    if (html_content_str.GetSize() == 0) {
 			    return string_t("<html></html>");
 		    }
 
 		    try {
 			    // Parse the HTML using the HTML parser to normalize it
-			    XMLDocRAII html_doc(html_content, true); // Use HTML parser
+			    XMLDocRAII html_doc(html_content_str, true); // Use HTML parser
 			    if (html_doc.IsValid()) {
 				    std::string minified_html;
 				    if (SerializeMinifiedHTML(html_doc.doc, minified_html)) {
@@ -2078,11 +3348,11 @@ void XMLScalarFunctions::ReadHTMLFunction(DataChunk &args, ExpressionState &stat
 			    }
 
 			    // Fallback to original content if parsing fails
-			    return StringVector::AddString(result, html_content);
+			    return StringVector::AddString(result, html_content_str);
 
 		    } catch (const std::exception &e) {
 			    // Return original content if there's an error parsing
-			    return StringVector::AddString(result, html_content);
+			    return StringVector::AddString(result, html_content_str);
 		    }
 	    });
 }
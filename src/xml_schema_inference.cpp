@@ -188,7 +188,7 @@ std::vector<xmlNodePtr> XMLSchemaInference::IdentifyRecordElements(XMLDocRAII &d
 			}
 		}
 
-		xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath_expr.c_str(), doc.xpath_ctx);
+		xmlXPathObjectPtr xpath_obj = XMLUtils::EvaluateXPath(xpath_expr, doc.xpath_ctx, nullptr);
 
 		if (xpath_obj && xpath_obj->nodesetval) {
 			for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
@@ -201,7 +201,7 @@ std::vector<xmlNodePtr> XMLSchemaInference::IdentifyRecordElements(XMLDocRAII &d
 	// If a specific root element is specified, find it
 	else if (!options.root_element.empty()) {
 		std::string xpath = "//" + options.root_element;
-		xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), doc.xpath_ctx);
+		xmlXPathObjectPtr xpath_obj = XMLUtils::EvaluateXPath(xpath, doc.xpath_ctx, nullptr);
 
 		if (xpath_obj && xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0) {
 			root = xpath_obj->nodesetval->nodeTab[0];
@@ -716,7 +716,7 @@ std::vector<ElementPattern> XMLSchemaInference::AnalyzeDocumentStructure(const s
 			}
 		}
 
-		xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath_expr.c_str(), xml_doc.xpath_ctx);
+		xmlXPathObjectPtr xpath_obj = XMLUtils::EvaluateXPath(xpath_expr, xml_doc.xpath_ctx, nullptr);
 
 		if (xpath_obj && xpath_obj->nodesetval) {
 			for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
@@ -732,7 +732,7 @@ std::vector<ElementPattern> XMLSchemaInference::AnalyzeDocumentStructure(const s
 		// Use XPath to find the specified root element
 		std::string xpath = "//" + options.root_element;
 
-		xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+		xmlXPathObjectPtr xpath_obj = XMLUtils::EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
 
 		if (xpath_obj && xpath_obj->nodesetval && xpath_obj->nodesetval->nodeNr > 0) {
 			root = xpath_obj->nodesetval->nodeTab[0];
@@ -1185,6 +1185,19 @@ bool XMLSchemaInference::IsBoolean(const std::string &value) {
 	       lower == "on" || lower == "off";
 }
 
+bool XMLSchemaInference::TryParseBoolean(const std::string &value, bool &result) {
+	std::string lower = StringUtil::Lower(value);
+	if (lower == "true" || lower == "yes" || lower == "1" || lower == "on") {
+		result = true;
+		return true;
+	}
+	if (lower == "false" || lower == "no" || lower == "0" || lower == "off") {
+		result = false;
+		return true;
+	}
+	return false;
+}
+
 bool XMLSchemaInference::IsInteger(const std::string &value) {
 	if (value.empty())
 		return false;
@@ -1464,7 +1477,8 @@ std::string XMLSchemaInference::CleanTextContent(const std::string &text, bool p
 }
 
 std::vector<Value> XMLSchemaInference::ExtractSingleRecord(xmlNodePtr record, const std::vector<XMLColumnInfo> &schema,
-                                                           int remaining_depth, const XMLSchemaOptions &options) {
+                                                           int remaining_depth, const XMLSchemaOptions &options,
+                                                           const std::vector<bool> *skip_columns) {
 	std::vector<Value> row;
 
 	// If remaining_depth < 0, serialize the record as XML
@@ -1486,7 +1500,12 @@ std::vector<Value> XMLSchemaInference::ExtractSingleRecord(xmlNodePtr record, co
 		return row;
 	}
 
-	for (const auto &column : schema) {
+	for (size_t col_idx = 0; col_idx < schema.size(); col_idx++) {
+		const auto &column = schema[col_idx];
+		if (skip_columns && (*skip_columns)[col_idx]) {
+			row.push_back(Value(column.type));
+			continue;
+		}
 		Value value;
 
 		if (column.is_attribute) {
@@ -1504,7 +1523,6 @@ std::vector<Value> XMLSchemaInference::ExtractSingleRecord(xmlNodePtr record, co
 		} else {
 			// Extract element text content
 			xmlNodePtr child = record->children;
-			std::string element_text;
 
 			// Special handling for LIST columns - collect ALL matching children
 			if (column.type.id() == LogicalTypeId::LIST) {
@@ -1529,85 +1547,74 @@ std::vector<Value> XMLSchemaInference::ExtractSingleRecord(xmlNodePtr record, co
 				continue;
 			}
 
-			while (child) {
-				if (child->type == XML_ELEMENT_NODE &&
-				    xmlStrcmp(child->name, (const xmlChar *)column.name.c_str()) == 0) {
-					// Check if this element has child elements (container) or just text
-					bool has_element_children = false;
-					for (xmlNodePtr grandchild = child->children; grandchild; grandchild = grandchild->next) {
-						if (grandchild->type == XML_ELEMENT_NODE) {
-							has_element_children = true;
-							break;
-						}
-					}
+			while (child && (child->type != XML_ELEMENT_NODE ||
+			                 xmlStrcmp(child->name, (const xmlChar *)column.name.c_str()) != 0)) {
+				child = child->next;
+			}
+			value = ExtractElementColumnValue(child, column.type, column.winning_datetime_format, options);
+		}
 
-					if (has_element_children) {
-						// Container element - check for structured types first
-						if (column.type.id() == LogicalTypeId::STRUCT) {
-							value = ExtractValueFromNode(child, column.type, options);
-							element_text = "";
-							break;
-						}
+		row.push_back(value);
+	}
 
-						// Check for XML[] type
-						if (XMLTypes::IsXMLArrayType(column.type)) {
-							value = ExtractXMLArrayFromNode(child);
-							element_text = "";
-							break;
-						}
+	return row;
+}
 
-						// Fall back to XML/XMLFragment format for unstructured types
-						bool use_fragment = (column.type.HasAlias() && column.type.GetAlias() == "xmlfragment");
-
-						if (use_fragment) {
-							xmlBufferPtr buffer = xmlBufferCreate();
-							if (buffer) {
-								for (xmlNodePtr grandchild = child->children; grandchild;
-								     grandchild = grandchild->next) {
-									if (grandchild->type == XML_ELEMENT_NODE) {
-										xmlNodeDump(buffer, grandchild->doc, grandchild, 0, 1);
-									}
-								}
-								const xmlChar *content = xmlBufferContent(buffer);
-								if (content) {
-									element_text = std::string((const char *)content);
-								}
-								xmlBufferFree(buffer);
-							}
-						} else {
-							xmlBufferPtr buffer = xmlBufferCreate();
-							if (buffer) {
-								xmlNodeDump(buffer, child->doc, child, 0, 1);
-								const xmlChar *content = xmlBufferContent(buffer);
-								if (content) {
-									element_text = std::string((const char *)content);
-								}
-								xmlBufferFree(buffer);
-							}
-						}
-					} else {
-						// Leaf element - return text content
-						xmlChar *text_content = xmlNodeGetContent(child);
-						if (text_content) {
-							element_text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
-							xmlFree(text_content);
+Value XMLSchemaInference::ExtractElementColumnValue(xmlNodePtr child, const LogicalType &type,
+                                                    const std::string &datetime_format,
+                                                    const XMLSchemaOptions &options) {
+	std::string element_text;
+	if (child) {
+		// Check if this element has child elements (container) or just text
+		bool has_element_children = false;
+		for (xmlNodePtr grandchild = child->children; grandchild; grandchild = grandchild->next) {
+			if (grandchild->type == XML_ELEMENT_NODE) {
+				has_element_children = true;
+				break;
+			}
+		}
+
+		if (has_element_children) {
+			// Container element - check for structured types first
+			if (type.id() == LogicalTypeId::STRUCT) {
+				return ExtractValueFromNode(child, type, options);
+			}
+
+			// Check for XML[] type
+			if (XMLTypes::IsXMLArrayType(type)) {
+				return ExtractXMLArrayFromNode(child);
+			}
+
+			// Fall back to XML/XMLFragment format for unstructured types
+			bool use_fragment = (type.HasAlias() && type.GetAlias() == "xmlfragment");
+
+			xmlBufferPtr buffer = xmlBufferCreate();
+			if (buffer) {
+				if (use_fragment) {
+					for (xmlNodePtr grandchild = child->children; grandchild; grandchild = grandchild->next) {
+						if (grandchild->type == XML_ELEMENT_NODE) {
+							xmlNodeDump(buffer, grandchild->doc, grandchild, 0, 1);
 						}
 					}
-					break;
+				} else {
+					xmlNodeDump(buffer, child->doc, child, 0, 1);
 				}
-				child = child->next;
+				const xmlChar *content = xmlBufferContent(buffer);
+				if (content) {
+					element_text = std::string((const char *)content);
+				}
+				xmlBufferFree(buffer);
 			}
-
-			// Only convert text value if we haven't already extracted a structured value
-			if (value.IsNull()) {
-				value = ConvertToValue(element_text, column.type, options, column.winning_datetime_format);
+		} else {
+			// Leaf element - return text content
+			xmlChar *text_content = xmlNodeGetContent(child);
+			if (text_content) {
+				element_text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
+				xmlFree(text_content);
 			}
 		}
-
-		row.push_back(value);
 	}
-
-	return row;
+	return ConvertToValue(element_text, type, options, datetime_format);
 }
 
 std::vector<std::vector<Value>> XMLSchemaInference::ExtractData(const std::string &xml_content,
@@ -1651,86 +1658,299 @@ std::vector<std::vector<Value>> XMLSchemaInference::ExtractData(const std::strin
 	return rows;
 }
 
+// Where an explicit-schema column's value is in a record. The attribute the column names wins;
+// otherwise the first child element with the column's name, else the record itself when it has it.
+namespace {
+struct SchemaColumnSource {
+	bool has_attribute = false;
+	std::string attribute_value;
+	xmlNodePtr element = nullptr;
+};
+} // namespace
+
+static SchemaColumnSource LocateSchemaColumn(xmlNodePtr record, const std::string &column_name,
+                                             const XMLSchemaOptions &options) {
+	SchemaColumnSource source;
+	std::string attr_name = XMLSchemaInference::AttributeNameFromColumn(column_name, options);
+	xmlChar *attr_value = xmlGetProp(record, (const xmlChar *)attr_name.c_str());
+	if (attr_value) {
+		source.has_attribute = true;
+		source.attribute_value = (const char *)attr_value;
+		xmlFree(attr_value);
+		return source;
+	}
+	for (xmlNodePtr child = record->children; child; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE && xmlStrcmp(child->name, (const xmlChar *)column_name.c_str()) == 0) {
+			source.element = child;
+			return source;
+		}
+	}
+	if (xmlStrcmp(record->name, (const xmlChar *)column_name.c_str()) == 0) {
+		source.element = record;
+	}
+	return source;
+}
+
 std::vector<Value> XMLSchemaInference::ExtractSingleRecordWithSchema(
     xmlNodePtr record, const std::vector<std::string> &column_names, const std::vector<LogicalType> &column_types,
-    const XMLSchemaOptions &options, const std::vector<std::string> &column_datetime_formats) {
+    const XMLSchemaOptions &options, const std::vector<std::string> &column_datetime_formats,
+    const std::vector<bool> *skip_columns) {
 	std::vector<Value> row;
 
 	for (size_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
 		const auto &column_name = column_names[col_idx];
 		const auto &column_type = column_types[col_idx];
+		if (skip_columns && (*skip_columns)[col_idx]) {
+			row.push_back(Value(column_type));
+			continue;
+		}
 		const std::string &col_fmt = (col_idx < column_datetime_formats.size()) ? column_datetime_formats[col_idx] : "";
 
 		Value value;
 
-		// First check if it's an attribute (strip attr_prefix in 'prefixed' mode)
-		std::string attr_name = AttributeNameFromColumn(column_name, options);
-		xmlChar *attr_value = xmlGetProp(record, (const xmlChar *)attr_name.c_str());
-		if (attr_value) {
-			std::string str_value = (const char *)attr_value;
-			value = ConvertToValue(str_value, column_type, options, col_fmt);
-			xmlFree(attr_value);
-		} else {
-			// Special handling for LIST columns - collect ALL matching children
-			if (column_type.id() == LogicalTypeId::LIST) {
-				vector<Value> list_values;
-				auto element_type = ListType::GetChildType(column_type);
-
-				for (xmlNodePtr child_iter = record->children; child_iter; child_iter = child_iter->next) {
+		// An attribute wins (attr_prefix is stripped in 'prefixed' mode)
+		auto source = LocateSchemaColumn(record, column_name, options);
+		if (source.has_attribute) {
+			value = ConvertToValue(source.attribute_value, column_type, options, col_fmt);
+		} else if (column_type.id() == LogicalTypeId::LIST) {
+			// LIST columns collect ALL matching children, starting from the first; the record itself
+			// does not count
+			vector<Value> list_values;
+			auto element_type = ListType::GetChildType(column_type);
+			if (source.element != record) {
+				for (xmlNodePtr child_iter = source.element; child_iter; child_iter = child_iter->next) {
 					if (child_iter->type == XML_ELEMENT_NODE &&
 					    xmlStrcmp(child_iter->name, (const xmlChar *)column_name.c_str()) == 0) {
-						Value element_value = ExtractValueFromNode(child_iter, element_type, options);
-						list_values.push_back(element_value);
+						list_values.push_back(ExtractValueFromNode(child_iter, element_type, options));
 					}
 				}
+			}
+			// Empty list becomes NULL
+			value = list_values.empty() ? Value() : Value::LIST(element_type, list_values);
+		} else if (!source.element) {
+			value = Value(column_type); // NULL for truly missing columns
+		} else if (!col_fmt.empty() && source.element != record) {
+			// Has a datetime format: extract raw text and convert with format
+			xmlChar *text_content = xmlNodeGetContent(source.element);
+			if (text_content) {
+				std::string text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
+				xmlFree(text_content);
+				value = ConvertToValue(text, column_type, options, col_fmt);
+			}
+		} else {
+			// No format: use standard recursive extraction
+			value = ExtractValueFromNode(source.element, column_type, options);
+		}
 
-				if (!list_values.empty()) {
-					value = Value::LIST(element_type, list_values);
-				} else {
-					value = Value(); // Empty list becomes NULL
-				}
-				row.push_back(value);
+		row.push_back(value);
+	}
+
+	return row;
+}
+
+// Scalar columns are the ones the shaped loops produce themselves; LIST/STRUCT columns qualify only
+// when they are vector-written (and therefore skipped by the Value extraction).
+static bool IsShapedColumn(const LogicalType &type, const std::string &datetime_format) {
+	if (type.id() == LogicalTypeId::LIST || type.id() == LogicalTypeId::STRUCT) {
+		return XMLSchemaInference::IsVectorWriteColumn(type, datetime_format);
+	}
+	return true;
+}
+
+XMLRecordPlan XMLSchemaInference::PlanRecordShape(const std::vector<XMLColumnInfo> &schema,
+                                                  const XMLSchemaOptions &options) {
+	XMLRecordPlan plan;
+	bool has_element_columns = false;
+	for (idx_t col_idx = 0; col_idx < schema.size(); col_idx++) {
+		const auto &column = schema[col_idx];
+		if (!IsShapedColumn(column.type, column.winning_datetime_format)) {
+			return XMLRecordPlan();
+		}
+		plan.columns.push_back({column.name, column.type, column.winning_datetime_format, column.is_attribute});
+		if (column.type.id() == LogicalTypeId::LIST || column.type.id() == LogicalTypeId::STRUCT) {
+			continue; // Vector-written
+		}
+		bool inserted;
+		if (column.is_attribute) {
+			inserted = plan.attribute_columns.emplace(AttributeNameFromColumn(column.name, options), col_idx).second;
+		} else {
+			inserted = plan.element_columns.emplace(column.name, col_idx).second;
+			has_element_columns = true;
+		}
+		if (!inserted) {
+			return XMLRecordPlan();
+		}
+	}
+	plan.shape = has_element_columns ? XMLRecordShape::FLAT : XMLRecordShape::ATTRIBUTES_ONLY;
+	return plan;
+}
+
+XMLRecordPlan XMLSchemaInference::PlanRecordShape(const std::vector<std::string> &column_names,
+                                                  const std::vector<LogicalType> &column_types,
+                                                  const std::vector<std::string> &column_datetime_formats,
+                                                  const XMLSchemaOptions &options) {
+	XMLRecordPlan plan;
+	plan.explicit_schema = true;
+	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
+		const std::string &fmt = col_idx < column_datetime_formats.size() ? column_datetime_formats[col_idx] : "";
+		if (!IsShapedColumn(column_types[col_idx], fmt)) {
+			return XMLRecordPlan();
+		}
+		plan.columns.push_back({column_names[col_idx], column_types[col_idx], fmt, false});
+		if (column_types[col_idx].id() == LogicalTypeId::LIST || column_types[col_idx].id() == LogicalTypeId::STRUCT) {
+			continue;
+		}
+		// An explicit column may come from an attribute (checked first) or a child element
+		if (!plan.attribute_columns.emplace(AttributeNameFromColumn(column_names[col_idx], options), col_idx).second ||
+		    !plan.element_columns.emplace(column_names[col_idx], col_idx).second) {
+			return XMLRecordPlan();
+		}
+	}
+	plan.shape = XMLRecordShape::FLAT;
+	return plan;
+}
+
+bool XMLSchemaInference::SupportsShapedExtraction(xmlDocPtr doc) {
+	return doc && (!doc->intSubset || !doc->intSubset->attributes) &&
+	       (!doc->extSubset || !doc->extSubset->attributes);
+}
+
+std::vector<Value> XMLSchemaInference::ExtractShapedRecord(xmlNodePtr record, const XMLRecordPlan &plan,
+                                                           const XMLSchemaOptions &options,
+                                                           const std::vector<bool> *skip_columns) {
+	switch (plan.shape) {
+	case XMLRecordShape::ATTRIBUTES_ONLY:
+		return ExtractShapedRecordInternal<XMLRecordShape::ATTRIBUTES_ONLY>(record, plan, options, skip_columns);
+	case XMLRecordShape::FLAT:
+		return ExtractShapedRecordInternal<XMLRecordShape::FLAT>(record, plan, options, skip_columns);
+	default:
+		throw InternalException("read_xml: no specialized extraction loop for a GENERIC record shape");
+	}
+}
+
+// One pass over the record's attributes (and, for FLAT, its children) records the first match per
+// column -- the node xmlGetProp / the generic child scan would find -- then each column is converted
+// exactly as the generic extractor converts it.
+template <XMLRecordShape SHAPE>
+std::vector<Value> XMLSchemaInference::ExtractShapedRecordInternal(xmlNodePtr record, const XMLRecordPlan &plan,
+                                                                   const XMLSchemaOptions &options,
+                                                                   const std::vector<bool> *skip_columns) {
+	const idx_t column_count = plan.columns.size();
+	std::vector<xmlNodePtr> matches(column_count, nullptr);
+
+	std::string name;
+	if (!plan.attribute_columns.empty()) {
+		for (xmlAttrPtr attr = record->properties; attr; attr = attr->next) {
+			name.assign((const char *)attr->name);
+			auto entry = plan.attribute_columns.find(name);
+			if (entry != plan.attribute_columns.end() && !matches[entry->second]) {
+				matches[entry->second] = (xmlNodePtr)attr;
+			}
+		}
+	}
+	if (SHAPE == XMLRecordShape::FLAT) {
+		for (xmlNodePtr child = record->children; child; child = child->next) {
+			if (child->type != XML_ELEMENT_NODE) {
 				continue;
 			}
+			name.assign((const char *)child->name);
+			auto entry = plan.element_columns.find(name);
+			if (entry != plan.element_columns.end() && !matches[entry->second]) {
+				matches[entry->second] = child;
+			}
+		}
+	}
 
-			// Look for child element with matching name (non-LIST types)
-			xmlNodePtr child = record->children;
-			while (child) {
-				if (child->type == XML_ELEMENT_NODE &&
-				    xmlStrcmp(child->name, (const xmlChar *)column_name.c_str()) == 0) {
-					if (!col_fmt.empty()) {
-						// Has a datetime format: extract raw text and convert with format
-						xmlChar *text_content = xmlNodeGetContent(child);
-						if (text_content) {
-							std::string text =
-							    CleanTextContent((const char *)text_content, options.preserve_whitespace);
-							xmlFree(text_content);
-							value = ConvertToValue(text, column_type, options, col_fmt);
-						}
-					} else {
-						// No format: use standard recursive extraction
-						value = ExtractValueFromNode(child, column_type, options);
-					}
-					break;
+	std::vector<Value> row;
+	row.reserve(column_count);
+	for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+		const auto &column = plan.columns[col_idx];
+		if ((skip_columns && (*skip_columns)[col_idx]) || column.type.id() == LogicalTypeId::LIST ||
+		    column.type.id() == LogicalTypeId::STRUCT) {
+			row.push_back(Value(column.type));
+			continue;
+		}
+		xmlNodePtr match = matches[col_idx];
+		if (match && match->type == XML_ATTRIBUTE_NODE) {
+			// Same value xmlGetProp returns: a lone text child directly, entities expanded otherwise
+			xmlNodePtr value_node = match->children;
+			if (value_node && !value_node->next &&
+			    (value_node->type == XML_TEXT_NODE || value_node->type == XML_CDATA_SECTION_NODE)) {
+				row.push_back(ConvertToValue(value_node->content ? (const char *)value_node->content : "",
+				                             column.type, options, column.datetime_format));
+			} else {
+				xmlChar *attr_value = xmlNodeListGetString(record->doc, value_node, 1);
+				std::string str_value = attr_value ? (const char *)attr_value : "";
+				if (attr_value) {
+					xmlFree(attr_value);
 				}
-				child = child->next;
+				row.push_back(ConvertToValue(str_value, column.type, options, column.datetime_format));
 			}
-
-			// If no matching child found, check if column name matches the record element itself
-			if (child == nullptr) {
-				std::string record_name = (const char *)record->name;
-				if (record_name == column_name) {
-					value = ExtractValueFromNode(record, column_type, options);
-				} else {
-					value = Value(column_type); // NULL for truly missing columns
+			continue;
+		}
+		if (!plan.explicit_schema) {
+			// An unmatched attribute column is NULL; an element column converts its (possibly absent) child
+			row.push_back(column.is_attribute
+			                  ? Value()
+			                  : ExtractElementColumnValue(match, column.type, column.datetime_format, options));
+			continue;
+		}
+		// Explicit schema: matched child, else the record element itself, else NULL
+		if (match) {
+			if (column.datetime_format.empty()) {
+				row.push_back(ExtractValueFromNode(match, column.type, options));
+			} else {
+				Value value;
+				xmlChar *text_content = xmlNodeGetContent(match);
+				if (text_content) {
+					std::string text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
+					xmlFree(text_content);
+					value = ConvertToValue(text, column.type, options, column.datetime_format);
 				}
+				row.push_back(value);
 			}
+		} else if (SHAPE == XMLRecordShape::FLAT && xmlStrcmp(record->name, (const xmlChar *)column.name.c_str()) == 0) {
+			row.push_back(ExtractValueFromNode(record, column.type, options));
+		} else {
+			row.push_back(Value(column.type));
 		}
+	}
+	return row;
+}
 
-		row.push_back(value);
+bool XMLSchemaInference::IsBatchCastColumn(const LogicalType &type, const std::string &datetime_format) {
+	if (!datetime_format.empty()) {
+		return false;
+	}
+	switch (type.id()) {
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::DATE:
+		return true;
+	default:
+		return false;
 	}
+}
 
-	return row;
+bool XMLSchemaInference::ExtractRawColumnText(xmlNodePtr record, const std::string &column_name,
+                                              const XMLSchemaOptions &options, std::string &text) {
+	auto source = LocateSchemaColumn(record, column_name, options);
+	if (source.has_attribute) {
+		// Attribute values reach ConvertToValue uncleaned; keep that.
+		text = std::move(source.attribute_value);
+	} else {
+		if (!source.element) {
+			return false;
+		}
+		xmlChar *text_content = xmlNodeGetContent(source.element);
+		if (!text_content) {
+			return false;
+		}
+		text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
+		xmlFree(text_content);
+	}
+	return !text.empty() && !IsNullString(text, options);
 }
 
 std::vector<std::vector<Value>>
@@ -1771,9 +1991,24 @@ XMLSchemaInference::ExtractDataWithSchema(const std::string &xml_content, const
 	return rows;
 }
 
-// TODO(#38): ParseFormatSpecifier is called per-row when datetime_format is non-empty.
-// The XML parsing bottleneck is much larger than format compilation, so this is acceptable
-// for now. If profiling shows this matters, consider a format-string-to-StrpTimeFormat cache.
+// Compiled datetime formats of this thread. Formats come from a handful of columns or function
+// arguments; the bound only guards against a per-row format argument with many distinct values.
+static constexpr idx_t MAX_CACHED_DATETIME_FORMATS = 64;
+thread_local std::unordered_map<std::string, StrpTimeFormat> thread_datetime_formats;
+
+const StrpTimeFormat &XMLSchemaInference::GetDatetimeFormat(const std::string &format) {
+	auto entry = thread_datetime_formats.find(format);
+	if (entry != thread_datetime_formats.end()) {
+		return entry->second;
+	}
+	if (thread_datetime_formats.size() >= MAX_CACHED_DATETIME_FORMATS) {
+		thread_datetime_formats.clear();
+	}
+	auto &compiled = thread_datetime_formats[format];
+	StrTimeFormat::ParseFormatSpecifier(format, compiled);
+	return compiled;
+}
+
 Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalType &target_type,
                                          const XMLSchemaOptions &options, const std::string &datetime_format) {
 	if (text.empty()) {
@@ -1787,12 +2022,9 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 	try {
 		switch (target_type.id()) {
 		case LogicalTypeId::BOOLEAN: {
-			std::string lower = text;
-			std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-			if (lower == "true" || lower == "yes" || lower == "1" || lower == "on") {
-				return Value::BOOLEAN(true);
-			} else if (lower == "false" || lower == "no" || lower == "0" || lower == "off") {
-				return Value::BOOLEAN(false);
+			bool bool_result;
+			if (TryParseBoolean(text, bool_result)) {
+				return Value::BOOLEAN(bool_result);
 			}
 			return Value(); // NULL for unrecognized boolean
 		}
@@ -1819,8 +2051,7 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 		}
 		case LogicalTypeId::DATE: {
 			if (!datetime_format.empty()) {
-				StrpTimeFormat strp_format;
-				StrTimeFormat::ParseFormatSpecifier(datetime_format, strp_format);
+				auto &strp_format = GetDatetimeFormat(datetime_format);
 				date_t result;
 				if (strp_format.TryParseDate(text.c_str(), text.size(), result)) {
 					return Value::DATE(result);
@@ -1831,8 +2062,7 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 		}
 		case LogicalTypeId::TIMESTAMP: {
 			if (!datetime_format.empty()) {
-				StrpTimeFormat strp_format;
-				StrTimeFormat::ParseFormatSpecifier(datetime_format, strp_format);
+				auto &strp_format = GetDatetimeFormat(datetime_format);
 				timestamp_t result;
 				if (strp_format.TryParseTimestamp(text.c_str(), text.size(), result)) {
 					return Value::TIMESTAMP(result);
@@ -1843,8 +2073,7 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 		}
 		case LogicalTypeId::TIMESTAMP_TZ: {
 			if (!datetime_format.empty()) {
-				StrpTimeFormat strp_format;
-				StrTimeFormat::ParseFormatSpecifier(datetime_format, strp_format);
+				auto &strp_format = GetDatetimeFormat(datetime_format);
 				timestamp_t result;
 				if (strp_format.TryParseTimestamp(text.c_str(), text.size(), result)) {
 					return Value::TIMESTAMPTZ(timestamp_tz_t(result));
@@ -1856,8 +2085,7 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 		}
 		case LogicalTypeId::TIME: {
 			if (!datetime_format.empty()) {
-				StrpTimeFormat strp_format;
-				StrTimeFormat::ParseFormatSpecifier(datetime_format, strp_format);
+				auto &strp_format = GetDatetimeFormat(datetime_format);
 				StrpTimeFormat::ParseResult parse_result;
 				if (strp_format.Parse(text.c_str(), text.size(), parse_result)) {
 					dtime_t time_result;
@@ -1878,8 +2106,7 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 		}
 		case LogicalTypeId::TIME_TZ: {
 			if (!datetime_format.empty()) {
-				StrpTimeFormat strp_format;
-				StrTimeFormat::ParseFormatSpecifier(datetime_format, strp_format);
+				auto &strp_format = GetDatetimeFormat(datetime_format);
 				StrpTimeFormat::ParseResult parse_result;
 				if (strp_format.Parse(text.c_str(), text.size(), parse_result)) {
 					dtime_t time_result;
@@ -1923,6 +2150,202 @@ Value XMLSchemaInference::ConvertToValue(const std::string &text, const LogicalT
 	}
 }
 
+bool XMLSchemaInference::IsVectorWriteColumn(const LogicalType &type, const std::string &datetime_format) {
+	if (!datetime_format.empty()) {
+		return false;
+	}
+	return type.id() == LogicalTypeId::LIST || type.id() == LogicalTypeId::STRUCT;
+}
+
+void XMLSchemaInference::WriteColumnWithSchema(xmlNodePtr record, const std::string &column_name,
+                                               const LogicalType &column_type, const XMLSchemaOptions &options,
+                                               Vector &result, idx_t row) {
+	std::string attr_name = AttributeNameFromColumn(column_name, options);
+	xmlChar *attr_value = xmlGetProp(record, (const xmlChar *)attr_name.c_str());
+	if (attr_value) {
+		std::string str_value = (const char *)attr_value;
+		xmlFree(attr_value);
+		result.SetValue(row, ConvertToValue(str_value, column_type, options));
+		return;
+	}
+
+	if (column_type.id() == LogicalTypeId::LIST) {
+		// All matching children; no match is NULL rather than an empty list
+		if (AppendChildElementsToList(record, &column_name, false, ListType::GetChildType(column_type), options,
+		                              result, row) == 0) {
+			FlatVector::SetNull(result, row, true);
+		}
+		return;
+	}
+
+	for (xmlNodePtr child = record->children; child; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE && xmlStrcmp(child->name, (const xmlChar *)column_name.c_str()) == 0) {
+			WriteNodeToVector(child, column_type, options, result, row);
+			return;
+		}
+	}
+	if (xmlStrcmp(record->name, (const xmlChar *)column_name.c_str()) == 0) {
+		WriteNodeToVector(record, column_type, options, result, row);
+	} else {
+		FlatVector::SetNull(result, row, true);
+	}
+}
+
+void XMLSchemaInference::WriteInferredColumn(xmlNodePtr record, const XMLColumnInfo &column,
+                                             const XMLSchemaOptions &options, Vector &result, idx_t row) {
+	if (column.is_attribute) {
+		std::string attr_name = AttributeNameFromColumn(column.name, options);
+		xmlChar *attr_value = xmlGetProp(record, (const xmlChar *)attr_name.c_str());
+		if (!attr_value) {
+			FlatVector::SetNull(result, row, true);
+			return;
+		}
+		std::string str_value = (const char *)attr_value;
+		xmlFree(attr_value);
+		result.SetValue(row, ConvertToValue(str_value, column.type, options, column.winning_datetime_format));
+		return;
+	}
+
+	if (column.type.id() == LogicalTypeId::LIST) {
+		if (AppendChildElementsToList(record, &column.name, false, ListType::GetChildType(column.type), options,
+		                              result, row) == 0) {
+			FlatVector::SetNull(result, row, true);
+		}
+		return;
+	}
+
+	// STRUCT: a container child is extracted field by field; a leaf child (or none) goes through
+	// ConvertToValue on its text, as in ExtractSingleRecord.
+	std::string element_text;
+	for (xmlNodePtr child = record->children; child; child = child->next) {
+		if (child->type != XML_ELEMENT_NODE || xmlStrcmp(child->name, (const xmlChar *)column.name.c_str()) != 0) {
+			continue;
+		}
+		for (xmlNodePtr grandchild = child->children; grandchild; grandchild = grandchild->next) {
+			if (grandchild->type == XML_ELEMENT_NODE) {
+				WriteStructToVector(child, column.type, options, result, row);
+				return;
+			}
+		}
+		xmlChar *text_content = xmlNodeGetContent(child);
+		if (text_content) {
+			element_text = CleanTextContent((const char *)text_content, options.preserve_whitespace);
+			xmlFree(text_content);
+		}
+		break;
+	}
+	result.SetValue(row, ConvertToValue(element_text, column.type, options, column.winning_datetime_format));
+}
+
+void XMLSchemaInference::WriteNodeToVector(xmlNodePtr node, const LogicalType &target_type,
+                                           const XMLSchemaOptions &options, Vector &result, idx_t row) {
+	if (!node) {
+		FlatVector::SetNull(result, row, true);
+		return;
+	}
+	switch (target_type.id()) {
+	case LogicalTypeId::LIST:
+		AppendChildElementsToList(node, nullptr, false, ListType::GetChildType(target_type), options, result, row);
+		return;
+	case LogicalTypeId::STRUCT:
+		WriteStructToVector(node, target_type, options, result, row);
+		return;
+	default:
+		// Primitives are a single Value either way
+		result.SetValue(row, ExtractValueFromNode(node, target_type, options));
+		return;
+	}
+}
+
+void XMLSchemaInference::WriteStructToVector(xmlNodePtr node, const LogicalType &struct_type,
+                                             const XMLSchemaOptions &options, Vector &result, idx_t row) {
+	auto &struct_children = StructType::GetChildTypes(struct_type);
+	auto &entries = StructVector::GetEntries(result);
+	FlatVector::Validity(result).SetValid(row);
+
+	for (idx_t field_idx = 0; field_idx < struct_children.size(); field_idx++) {
+		const auto &field_name = struct_children[field_idx].first;
+		const auto &field_type = struct_children[field_idx].second;
+		auto &field_vector = *entries[field_idx];
+		bool found = false;
+
+		if (field_name == "#text") {
+			xmlChar *content = xmlNodeGetContent(node);
+			if (content) {
+				std::string text = CleanTextContent((const char *)content, options.preserve_whitespace);
+				xmlFree(content);
+				if (!text.empty()) {
+					field_vector.SetValue(row, ConvertToValue(text, field_type, options));
+					found = true;
+				}
+			}
+		} else if (xmlChar *attr_value = xmlGetProp(node, (const xmlChar *)field_name.c_str())) {
+			std::string str_value = (const char *)attr_value;
+			xmlFree(attr_value);
+			field_vector.SetValue(row, ConvertToValue(str_value, field_type, options));
+			found = true;
+		} else if (field_type.id() == LogicalTypeId::LIST) {
+			// Case-insensitive, as in ExtractStructFromNode
+			found = AppendChildElementsToList(node, &field_name, true, ListType::GetChildType(field_type), options,
+			                                  field_vector, row) > 0;
+		} else {
+			for (xmlNodePtr child = node->children; child; child = child->next) {
+				if (child->type == XML_ELEMENT_NODE &&
+				    xmlStrcasecmp(child->name, (const xmlChar *)field_name.c_str()) == 0) {
+					WriteNodeToVector(child, field_type, options, field_vector, row);
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if (!found) {
+			FlatVector::SetNull(field_vector, row, true);
+		}
+	}
+}
+
+idx_t XMLSchemaInference::AppendChildElementsToList(xmlNodePtr parent, const std::string *child_name,
+                                                    bool case_insensitive, const LogicalType &element_type,
+                                                    const XMLSchemaOptions &options, Vector &list_vector,
+                                                    idx_t row) {
+	auto matches = [&](xmlNodePtr child) {
+		if (child->type != XML_ELEMENT_NODE) {
+			return false;
+		}
+		if (!child_name) {
+			return true;
+		}
+		auto name = (const xmlChar *)child_name->c_str();
+		return (case_insensitive ? xmlStrcasecmp(child->name, name) : xmlStrcmp(child->name, name)) == 0;
+	};
+
+	idx_t match_count = 0;
+	for (xmlNodePtr child = parent->children; child; child = child->next) {
+		if (matches(child)) {
+			match_count++;
+		}
+	}
+
+	// Reserve once, then write the elements in place; nested lists grow their own child vectors
+	idx_t offset = ListVector::GetListSize(list_vector);
+	ListVector::Reserve(list_vector, offset + match_count);
+	auto &child_vector = ListVector::GetEntry(list_vector);
+	idx_t child_row = offset;
+	for (xmlNodePtr child = parent->children; child; child = child->next) {
+		if (matches(child)) {
+			WriteNodeToVector(child, element_type, options, child_vector, child_row++);
+		}
+	}
+	ListVector::SetListSize(list_vector, offset + match_count);
+
+	auto &entry = FlatVector::GetData<list_entry_t>(list_vector)[row];
+	entry.offset = offset;
+	entry.length = match_count;
+	FlatVector::Validity(list_vector).SetValid(row);
+	return match_count;
+}
+
 Value XMLSchemaInference::ConvertToValuePublic(const std::string &text, const LogicalType &target_type,
                                                const XMLSchemaOptions &options, const std::string &datetime_format) {
 	return ConvertToValue(text, target_type, options, datetime_format);
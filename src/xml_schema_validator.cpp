@@ -0,0 +1,228 @@
+#include "xml_schema_validator.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+void XMLSilentSchemaErrorHandler(void *ctx, const char *msg, ...);
+
+namespace {
+
+struct SchemaStreamState {
+	xmlParserCtxtPtr parser = nullptr;
+	XMLSchemaValidator *validator = nullptr;
+	bool has_doctype = false;
+};
+
+// A DOCTYPE can declare entities, which only a DOM parse records, so the stream stops and leaves the
+// document to xmlSchemaValidateDoc
+void SchemaStreamInternalSubset(void *ctx, const xmlChar *name, const xmlChar *external_id,
+                                const xmlChar *system_id) {
+	auto &state = *static_cast<SchemaStreamState *>(ctx);
+	state.has_doctype = true;
+	xmlStopParser(state.parser);
+}
+
+// The plug hands each element event to these before validating it; once an earlier event has failed
+// validation the answer is known and the rest of the document need not be read
+void SchemaStreamStopIfInvalid(SchemaStreamState &state) {
+	if (!state.validator->IsValidSoFar()) {
+		xmlStopParser(state.parser);
+	}
+}
+
+void SchemaStreamStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                              int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+                              const xmlChar **attributes) {
+	SchemaStreamStopIfInvalid(*static_cast<SchemaStreamState *>(ctx));
+}
+
+void SchemaStreamEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
+	SchemaStreamStopIfInvalid(*static_cast<SchemaStreamState *>(ctx));
+}
+
+} // namespace
+
+XMLSchemaValidator::XMLSchemaValidator(XMLSharedSchemaPtr schema_p) : schema(std::move(schema_p)) {
+	if (schema) {
+		valid_ctx.reset(xmlSchemaNewValidCtxt(schema.get()));
+	}
+	if (valid_ctx) {
+		xmlSchemaSetValidErrors(valid_ctx.get(), XMLSilentSchemaErrorHandler, XMLSilentSchemaErrorHandler, nullptr);
+	}
+}
+
+XMLSchemaValidator::~XMLSchemaValidator() {
+	Unplug();
+}
+
+XMLSharedSchemaPtr XMLSchemaValidator::Compile(const char *data, idx_t size) {
+	// Fail-closed entity loader must be installed before parsing the caller-supplied XSD:
+	// an <xs:import>/<xs:include schemaLocation="file://..."> (or external DTD) would otherwise
+	// make libxml2 open arbitrary local files (GHSA-vf8w-rr6w-h445). The schema parser takes no
+	// XML_PARSE_* options, so the external entity loader is the only interception point.
+	XMLUtils::EnsureSecureParsing();
+	if (size > static_cast<idx_t>(NumericLimits<int>::Maximum())) {
+		return nullptr;
+	}
+	XMLSchemaParserPtr parser_ctx(xmlSchemaNewMemParserCtxt(data, static_cast<int>(size)));
+	if (!parser_ctx) {
+		return nullptr;
+	}
+	xmlSchemaSetParserErrors(parser_ctx.get(), XMLSilentSchemaErrorHandler, XMLSilentSchemaErrorHandler, nullptr);
+	xmlSchemaPtr compiled = xmlSchemaParse(parser_ctx.get());
+	if (!compiled) {
+		return nullptr;
+	}
+	return XMLSharedSchemaPtr(compiled, XMLSchemaDeleter());
+}
+
+xmlSAXHandlerPtr XMLSchemaValidator::Plug(xmlSAXHandlerPtr sax, void *user_data) {
+	if (!valid_ctx || plug) {
+		return nullptr;
+	}
+	plugged_sax = sax;
+	plugged_user_data = user_data;
+	plug = xmlSchemaSAXPlug(valid_ctx.get(), &plugged_sax, &plugged_user_data);
+	if (!plug) {
+		plugged_sax = nullptr;
+		plugged_user_data = nullptr;
+		return nullptr;
+	}
+	return plugged_sax;
+}
+
+bool XMLSchemaValidator::IsValidSoFar() const {
+	return valid_ctx && xmlSchemaIsValid(valid_ctx.get()) == 1;
+}
+
+void XMLSchemaValidator::Unplug() {
+	if (plug) {
+		xmlSchemaSAXUnplug(plug);
+		plug = nullptr;
+	}
+	plugged_sax = nullptr;
+	plugged_user_data = nullptr;
+}
+
+bool XMLSchemaValidator::ValidateChunks(const std::function<bool(const char *&data, idx_t &size)> &next_chunk,
+                                        bool stop_at_doctype, bool &has_doctype) {
+	has_doctype = false;
+	if (!valid_ctx) {
+		return false;
+	}
+	XMLUtils::EnsureSecureParsing();
+
+	xmlSAXHandler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.initialized = XML_SAX2_MAGIC;
+	if (stop_at_doctype) {
+		handler.internalSubset = SchemaStreamInternalSubset;
+	}
+	handler.startElementNs = SchemaStreamStartElement;
+	handler.endElementNs = SchemaStreamEndElement;
+
+	SchemaStreamState state;
+	state.validator = this;
+	auto plugged = Plug(&handler, &state);
+	if (!plugged) {
+		return false;
+	}
+	bool valid = false;
+	state.parser = xmlCreatePushParserCtxt(plugged, plugged_user_data, nullptr, 0, nullptr);
+	if (state.parser) {
+		xmlCtxtUseOptions(state.parser, XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
+		const char *data = nullptr;
+		idx_t size = 0;
+		bool parsed = true;
+		bool any_input = false;
+		while (parsed && next_chunk(data, size)) {
+			any_input = true;
+			if (xmlParseChunk(state.parser, data, static_cast<int>(size), 0) != 0) {
+				parsed = false;
+			}
+		}
+		if (parsed && xmlParseChunk(state.parser, nullptr, 0, 1) != 0) {
+			parsed = false;
+		}
+		valid = any_input && parsed && state.parser->wellFormed && IsValidSoFar();
+	}
+	// Unplugging finishes the validation run and resets the context for the next document
+	Unplug();
+	if (state.parser) {
+		xmlFreeParserCtxt(state.parser);
+	}
+	has_doctype = state.has_doctype;
+	return valid;
+}
+
+bool XMLSchemaValidator::Validate(const string_t &xml_str) {
+	// Hand the document over in chunks so the parser's input buffer stays small however large it is
+	auto data = xml_str.GetData();
+	idx_t size = xml_str.GetSize();
+	idx_t offset = 0;
+	bool has_doctype;
+	bool valid = ValidateChunks(
+	    [&](const char *&chunk, idx_t &chunk_size) {
+		    if (offset >= size) {
+			    return false;
+		    }
+		    chunk = data + offset;
+		    chunk_size = MinValue<idx_t>(CHUNK_SIZE, size - offset);
+		    offset += chunk_size;
+		    return true;
+	    },
+	    true, has_doctype);
+	if (!has_doctype) {
+		return valid;
+	}
+
+	XMLDocRAII xml_doc(xml_str);
+	return xml_doc.IsValid() && ValidateDocument(xml_doc.doc);
+}
+
+bool XMLSchemaValidator::ValidateStream(FileHandle &handle) {
+	char buffer[CHUNK_SIZE];
+	bool has_doctype;
+	return ValidateChunks(
+	    [&](const char *&chunk, idx_t &chunk_size) {
+		    auto bytes_read = handle.Read(buffer, CHUNK_SIZE);
+		    if (bytes_read <= 0) {
+			    return false;
+		    }
+		    chunk = buffer;
+		    chunk_size = static_cast<idx_t>(bytes_read);
+		    return true;
+	    },
+	    false, has_doctype);
+}
+
+bool XMLSchemaValidator::ValidateDocument(xmlDocPtr doc) {
+	return valid_ctx && !plug && doc && xmlSchemaValidateDoc(valid_ctx.get(), doc) == 0;
+}
+
+XMLSchemaValidator *XMLSchemaCache::Lookup(const string_t &xsd) {
+	auto data = xsd.GetData();
+	auto size = xsd.GetSize();
+	auto hash = Hash(data, size);
+	for (auto it = entries.begin(); it != entries.end(); ++it) {
+		if (it->hash == hash && it->xsd.size() == size && memcmp(it->xsd.data(), data, size) == 0) {
+			entries.splice(entries.begin(), entries, it);
+			return entries.front().validator.get();
+		}
+	}
+	Entry entry;
+	entry.hash = hash;
+	entry.xsd = std::string(data, size);
+	auto compiled = XMLSchemaValidator::Compile(data, size);
+	if (compiled) {
+		entry.validator = make_uniq<XMLSchemaValidator>(std::move(compiled));
+	}
+	entries.push_front(std::move(entry));
+	if (entries.size() > CAPACITY) {
+		entries.pop_back();
+	}
+	return entries.front().validator.get();
+}
+
+} // namespace duckdb
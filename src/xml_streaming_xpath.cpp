@@ -0,0 +1,612 @@
+#include "xml_streaming_xpath.hpp"
+#include "xml_utils.hpp"
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+#include <cstring>
+
+namespace duckdb {
+
+// ─── StreamingXPath ─────────────────────────────────────────────────────────
+
+static bool IsNameStartByte(unsigned char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+}
+
+static bool IsNameByte(unsigned char c) {
+	return IsNameStartByte(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+// Reads an NCName (or "*" when `allow_star`) at `pos`, advancing past it. Non-ASCII bytes are
+// accepted as name characters; libxml2 has already checked the document's names.
+static bool ReadStepName(const std::string &xpath, idx_t &pos, bool allow_star, std::string &name) {
+	if (pos >= xpath.size()) {
+		return false;
+	}
+	if (allow_star && xpath[pos] == '*') {
+		name = "*";
+		pos++;
+		return true;
+	}
+	if (!IsNameStartByte(static_cast<unsigned char>(xpath[pos]))) {
+		return false;
+	}
+	idx_t start = pos;
+	while (pos < xpath.size() && IsNameByte(static_cast<unsigned char>(xpath[pos]))) {
+		pos++;
+	}
+	name = xpath.substr(start, pos - start);
+	return true;
+}
+
+// Reads `[@name]` or `[@name='value']` (either quote) at `pos`, advancing past it
+static bool ReadAttributePredicate(const std::string &xpath, idx_t &pos, StreamingAttributePredicate &predicate) {
+	if (xpath.compare(pos, 2, "[@") != 0) {
+		return false;
+	}
+	pos += 2;
+	if (!ReadStepName(xpath, pos, false, predicate.name) || pos >= xpath.size()) {
+		return false;
+	}
+	if (xpath[pos] == '=') {
+		pos++;
+		if (pos >= xpath.size() || (xpath[pos] != '\'' && xpath[pos] != '"')) {
+			return false;
+		}
+		auto close = xpath.find(xpath[pos], pos + 1);
+		if (close == std::string::npos) {
+			return false;
+		}
+		predicate.has_value = true;
+		predicate.value = xpath.substr(pos + 1, close - pos - 1);
+		pos = close + 1;
+	}
+	if (pos >= xpath.size() || xpath[pos] != ']') {
+		return false;
+	}
+	pos++;
+	return true;
+}
+
+bool StreamingXPath::TryCompile(const std::string &xpath, StreamingXPath &result) {
+	result.steps.clear();
+	result.target = StreamingXPathTarget::ELEMENT;
+	result.attribute_name.clear();
+
+	idx_t pos = 0;
+	while (pos < xpath.size()) {
+		if (xpath[pos] != '/') {
+			return false;
+		}
+		bool descendant = pos + 1 < xpath.size() && xpath[pos + 1] == '/';
+		pos += descendant ? 2 : 1;
+		if (pos >= xpath.size()) {
+			return false;
+		}
+
+		bool is_attribute = xpath[pos] == '@';
+		bool is_text = xpath.compare(pos, 6, "text()") == 0;
+		if (is_attribute || is_text) {
+			// `//@a` and `//text()` select from any element; from the document node there is nothing
+			if (result.steps.empty()) {
+				if (!descendant) {
+					return false;
+				}
+				StreamingXPathStep any_element;
+				any_element.descendant = true;
+				any_element.name = "*";
+				result.steps.push_back(std::move(any_element));
+			} else if (descendant) {
+				// `/a//@b` would need descendant-or-self semantics on the last step
+				return false;
+			}
+			if (is_attribute) {
+				pos++;
+				if (!ReadStepName(xpath, pos, true, result.attribute_name)) {
+					return false;
+				}
+				result.target = StreamingXPathTarget::ATTRIBUTE;
+			} else {
+				pos += 6;
+				result.target = StreamingXPathTarget::TEXT;
+			}
+			// Nothing may follow an attribute or text() step
+			return pos == xpath.size() && result.steps.size() <= MAX_STEPS;
+		}
+
+		StreamingXPathStep step;
+		step.descendant = descendant;
+		if (!ReadStepName(xpath, pos, true, step.name)) {
+			return false;
+		}
+		while (pos < xpath.size() && xpath[pos] == '[') {
+			StreamingAttributePredicate predicate;
+			if (!ReadAttributePredicate(xpath, pos, predicate)) {
+				return false;
+			}
+			step.predicates.push_back(std::move(predicate));
+		}
+		result.steps.push_back(std::move(step));
+	}
+	return !result.steps.empty() && result.steps.size() <= MAX_STEPS;
+}
+
+
+// ─── StreamingXPathMatcher ──────────────────────────────────────────────────
+
+namespace {
+
+bool NameEquals(const std::string &name, const xmlChar *value) {
+	return strcmp(name.c_str(), reinterpret_cast<const char *>(value)) == 0;
+}
+
+// Whether an element with these SAX2 attributes, given as (localname, prefix, URI, value, end)
+// quintuples, passes the step's name test and predicates
+bool StepMatches(const StreamingXPathStep &step, const xmlChar *localname, const xmlChar *URI, int nb_attributes,
+                 const xmlChar **attributes) {
+	if (step.name != "*" && (URI || !NameEquals(step.name, localname))) {
+		return false;
+	}
+	for (auto &predicate : step.predicates) {
+		bool satisfied = false;
+		for (int i = 0; i < nb_attributes && !satisfied; i++) {
+			auto attribute = attributes + i * 5;
+			if (attribute[2] || !NameEquals(predicate.name, attribute[0])) {
+				continue;
+			}
+			auto length = static_cast<size_t>(attribute[4] - attribute[3]);
+			satisfied = !predicate.has_value ||
+			            (predicate.value.size() == length && memcmp(predicate.value.data(), attribute[3], length) == 0);
+		}
+		if (!satisfied) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// States of an element opened below an element in `parent` states. Bit s means step s is the next
+// to match among the element's children; bit steps.size() means the element itself matches.
+uint64_t ChildStates(const StreamingXPath &path, uint64_t parent, const xmlChar *localname, const xmlChar *URI,
+                     int nb_attributes, const xmlChar **attributes) {
+	uint64_t states = 0;
+	for (idx_t s = 0; parent != 0 && s < path.steps.size(); s++) {
+		uint64_t bit = uint64_t(1) << s;
+		if (!(parent & bit)) {
+			continue;
+		}
+		if (StepMatches(path.steps[s], localname, URI, nb_attributes, attributes)) {
+			states |= bit << 1;
+		}
+		if (path.steps[s].descendant) {
+			states |= bit;
+		}
+	}
+	return states;
+}
+
+// A push parser with the DOM parse's options (callbacks receive `user_data`, or the parser itself
+// when it is null), plus entity substitution so attribute values arrive
+// decoded. Without a DTD (which falls back to the DOM) only the predefined and character entities
+// exist.
+xmlParserCtxtPtr CreateStreamingParser(xmlSAXHandler &handler, void *user_data) {
+	XMLUtils::EnsureSecureParsing();
+	xmlParserCtxtPtr parser = xmlCreatePushParserCtxt(&handler, user_data, nullptr, 0, nullptr);
+	if (parser) {
+		xmlCtxtUseOptions(parser, XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET | XML_PARSE_NOENT);
+	}
+	return parser;
+}
+
+// Feeds `data` in chunks so the parser's input buffer stays small, and so the rest is never copied
+// once `done()` reports the answer is known. True when the whole document parsed without error.
+template <class DONE>
+bool FeedStreamingParser(xmlParserCtxtPtr parser, const char *data, idx_t size, idx_t chunk_size, DONE done) {
+	idx_t offset = 0;
+	while (!done() && offset < size) {
+		auto chunk = MinValue<idx_t>(chunk_size, size - offset);
+		bool last = offset + chunk == size;
+		if (xmlParseChunk(parser, data + offset, static_cast<int>(chunk), last ? 1 : 0) != 0) {
+			return false;
+		}
+		offset += chunk;
+	}
+	return offset == size && size > 0 && parser->wellFormed;
+}
+
+// ─── FindFirst: SAX callbacks that stop at the first match ──────────────────
+
+// What is being read into the value after a match
+enum class StreamingCapture {
+	NONE,
+	ELEMENT_CONTENT, // all text below the matched element, until it closes
+	TEXT_NODE,       // a text() match: consecutive character data...
+	CDATA_NODE       // ...or consecutive CDATA blocks, which libxml2 may deliver in pieces
+};
+
+struct StreamingFirstState {
+	const StreamingXPath *path = nullptr;
+	xmlParserCtxtPtr parser = nullptr;
+	std::string *value = nullptr;
+
+	// States of each open element, with the document node at the bottom
+	std::vector<uint64_t> open_states;
+	uint64_t matched_bit = 0;
+
+	StreamingCapture capture = StreamingCapture::NONE;
+	idx_t capture_depth = 0;
+	bool found = false;
+	bool unsupported = false;
+
+	// The answer is known, so the rest of the document is never read
+	void Found() {
+		found = true;
+		capture = StreamingCapture::NONE;
+		xmlStopParser(parser);
+	}
+
+	bool Done() const {
+		return found || unsupported;
+	}
+};
+
+void FirstStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                       int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+                       const xmlChar **attributes) {
+	auto &state = *static_cast<StreamingFirstState *>(ctx);
+	if (state.Done()) {
+		return;
+	}
+	if (state.capture == StreamingCapture::ELEMENT_CONTENT) {
+		state.open_states.push_back(0);
+		return;
+	}
+	if (state.capture != StreamingCapture::NONE) {
+		// An element ends the text node being read
+		state.Found();
+		return;
+	}
+
+	auto states = ChildStates(*state.path, state.open_states.back(), localname, URI, nb_attributes, attributes);
+	state.open_states.push_back(states);
+	if (!(states & state.matched_bit)) {
+		return;
+	}
+	switch (state.path->target) {
+	case StreamingXPathTarget::ELEMENT:
+		if (state.value) {
+			state.capture = StreamingCapture::ELEMENT_CONTENT;
+			state.capture_depth = state.open_states.size();
+		} else {
+			state.Found();
+		}
+		break;
+	case StreamingXPathTarget::ATTRIBUTE: {
+		auto &name = state.path->attribute_name;
+		for (int i = 0; i < nb_attributes; i++) {
+			auto attribute = attributes + i * 5;
+			// `@*` takes attributes in any namespace; `@name` only those in none
+			if (name != "*" && (attribute[2] || !NameEquals(name, attribute[0]))) {
+				continue;
+			}
+			if (state.value) {
+				state.value->assign(reinterpret_cast<const char *>(attribute[3]), attribute[4] - attribute[3]);
+			}
+			state.Found();
+			return;
+		}
+		break;
+	}
+	case StreamingXPathTarget::TEXT:
+		// Matches come from the element's character data
+		break;
+	}
+}
+
+void FirstEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
+	auto &state = *static_cast<StreamingFirstState *>(ctx);
+	if (state.Done()) {
+		return;
+	}
+	if (state.capture == StreamingCapture::TEXT_NODE || state.capture == StreamingCapture::CDATA_NODE ||
+	    (state.capture == StreamingCapture::ELEMENT_CONTENT && state.open_states.size() == state.capture_depth)) {
+		state.Found();
+		return;
+	}
+	state.open_states.pop_back();
+}
+
+void FirstCharacterData(StreamingFirstState &state, const xmlChar *ch, int len, StreamingCapture kind) {
+	if (state.Done()) {
+		return;
+	}
+	if (state.capture == StreamingCapture::ELEMENT_CONTENT || state.capture == kind) {
+		state.value->append(reinterpret_cast<const char *>(ch), len);
+		return;
+	}
+	if (state.capture != StreamingCapture::NONE) {
+		// Text after CDATA (or the reverse) is the next node; the one being read is complete
+		state.Found();
+		return;
+	}
+	if (state.path->target != StreamingXPathTarget::TEXT || !(state.open_states.back() & state.matched_bit)) {
+		return;
+	}
+	if (state.value) {
+		state.capture = kind;
+		state.value->append(reinterpret_cast<const char *>(ch), len);
+	} else {
+		state.Found();
+	}
+}
+
+void FirstCharacters(void *ctx, const xmlChar *ch, int len) {
+	FirstCharacterData(*static_cast<StreamingFirstState *>(ctx), ch, len, StreamingCapture::TEXT_NODE);
+}
+
+void FirstCdataBlock(void *ctx, const xmlChar *ch, int len) {
+	FirstCharacterData(*static_cast<StreamingFirstState *>(ctx), ch, len, StreamingCapture::CDATA_NODE);
+}
+
+// Comments and processing instructions separate text nodes
+void FirstNodeBoundary(StreamingFirstState &state) {
+	if (state.Done()) {
+		return;
+	}
+	if (state.capture == StreamingCapture::TEXT_NODE || state.capture == StreamingCapture::CDATA_NODE) {
+		state.Found();
+	}
+}
+
+void FirstComment(void *ctx, const xmlChar *value) {
+	FirstNodeBoundary(*static_cast<StreamingFirstState *>(ctx));
+}
+
+void FirstProcessingInstruction(void *ctx, const xmlChar *target, const xmlChar *data) {
+	FirstNodeBoundary(*static_cast<StreamingFirstState *>(ctx));
+}
+
+void FirstInternalSubset(void *ctx, const xmlChar *name, const xmlChar *external_id, const xmlChar *system_id) {
+	auto &state = *static_cast<StreamingFirstState *>(ctx);
+	state.unsupported = true;
+	xmlStopParser(state.parser);
+}
+
+// ─── ForEachMatch: SAX callbacks that build only the matched subtrees ───────
+
+struct StreamingOpenElement {
+	uint64_t states;
+	bool built; // a node was created for the element
+	bool keep;  // the node is, holds or is inside a match, so it stays in the tree when it closes
+};
+
+// Elements are handed to libxml2's own SAX2 tree builder when they are built, so the matched
+// subtrees are exactly what the DOM parse would produce (text merging, CDATA, line numbers). The
+// builder expects the parser as its callback context, so this state travels in the parser's
+// _private field.
+struct StreamingCollectState {
+	const StreamingXPath *path = nullptr;
+	xmlParserCtxtPtr parser = nullptr;
+	uint64_t matched_bit = 0;
+
+	// The document node at the bottom, then each open element
+	std::vector<StreamingOpenElement> open_elements;
+	// Depth of the outermost open element matched by an ELEMENT or TEXT target, whose whole subtree
+	// is built (0 = none)
+	idx_t capture_depth = 0;
+	std::vector<xmlNodePtr> matches;
+	bool unsupported = false;
+
+	static StreamingCollectState &Get(void *ctx) {
+		return *static_cast<StreamingCollectState *>(static_cast<xmlParserCtxtPtr>(ctx)->_private);
+	}
+};
+
+void CollectStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                         int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+                         const xmlChar **attributes) {
+	auto &state = StreamingCollectState::Get(ctx);
+	auto &parent = state.open_elements.back();
+	bool capturing = state.capture_depth > 0;
+
+	StreamingOpenElement element;
+	element.states = ChildStates(*state.path, parent.states, localname, URI, nb_attributes, attributes);
+	// An element no step is waiting in cannot lead to a match, and neither can anything below it
+	element.built = parent.built && (capturing || element.states != 0);
+	element.keep = capturing;
+	state.open_elements.push_back(element);
+	if (!element.built) {
+		return;
+	}
+
+	// Ancestors of a match only need their namespace declarations
+	bool matched = element.states & state.matched_bit;
+	bool with_attributes = capturing || matched;
+	xmlSAX2StartElementNs(state.parser, localname, prefix, URI, nb_namespaces, namespaces,
+	                      with_attributes ? nb_attributes : 0, with_attributes ? nb_defaulted : 0, attributes);
+	xmlNodePtr node = state.parser->node;
+	if (!matched || !node) {
+		return;
+	}
+	auto &opened = state.open_elements.back();
+	switch (state.path->target) {
+	case StreamingXPathTarget::ELEMENT:
+	case StreamingXPathTarget::TEXT:
+		// text() matches are recorded as the element's character data is built
+		if (state.path->target == StreamingXPathTarget::ELEMENT) {
+			state.matches.push_back(node);
+		}
+		opened.keep = true;
+		if (!capturing) {
+			state.capture_depth = state.open_elements.size();
+		}
+		break;
+	case StreamingXPathTarget::ATTRIBUTE: {
+		auto &name = state.path->attribute_name;
+		for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
+			// `@*` takes attributes in any namespace (xml:lang, xlink:href, ...); `@name` only those in none
+			if (name == "*" || (!attr->ns && NameEquals(name, attr->name))) {
+				state.matches.push_back(reinterpret_cast<xmlNodePtr>(attr));
+				opened.keep = true;
+			}
+		}
+		break;
+	}
+	}
+}
+
+void CollectEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
+	auto &state = StreamingCollectState::Get(ctx);
+	auto element = state.open_elements.back();
+	state.open_elements.pop_back();
+	if (state.capture_depth > state.open_elements.size()) {
+		state.capture_depth = 0;
+	}
+	if (!element.built) {
+		return;
+	}
+	xmlNodePtr node = state.parser->node;
+	xmlSAX2EndElementNs(state.parser, localname, prefix, URI);
+	if (element.keep) {
+		state.open_elements.back().keep = true;
+	} else if (node) {
+		xmlUnlinkNode(node);
+		xmlFreeNode(node);
+	}
+}
+
+void CollectCharacterData(StreamingCollectState &state, const xmlChar *ch, int len, bool is_cdata) {
+	if (state.capture_depth == 0) {
+		return;
+	}
+	if (is_cdata) {
+		xmlSAX2CDataBlock(state.parser, ch, len);
+	} else {
+		xmlSAX2Characters(state.parser, ch, len);
+	}
+	if (state.path->target != StreamingXPathTarget::TEXT || !(state.open_elements.back().states & state.matched_bit)) {
+		return;
+	}
+	// The data either started a text node or was merged into the previous one, as in the DOM
+	xmlNodePtr last = state.parser->node ? state.parser->node->last : nullptr;
+	if (last && (last->type == XML_TEXT_NODE || last->type == XML_CDATA_SECTION_NODE) &&
+	    (state.matches.empty() || state.matches.back() != last)) {
+		state.matches.push_back(last);
+	}
+}
+
+void CollectCharacters(void *ctx, const xmlChar *ch, int len) {
+	CollectCharacterData(StreamingCollectState::Get(ctx), ch, len, false);
+}
+
+void CollectCdataBlock(void *ctx, const xmlChar *ch, int len) {
+	CollectCharacterData(StreamingCollectState::Get(ctx), ch, len, true);
+}
+
+void CollectComment(void *ctx, const xmlChar *value) {
+	auto &state = StreamingCollectState::Get(ctx);
+	if (state.capture_depth > 0) {
+		xmlSAX2Comment(state.parser, value);
+	}
+}
+
+void CollectProcessingInstruction(void *ctx, const xmlChar *target, const xmlChar *data) {
+	auto &state = StreamingCollectState::Get(ctx);
+	if (state.capture_depth > 0) {
+		xmlSAX2ProcessingInstruction(state.parser, target, data);
+	}
+}
+
+void CollectInternalSubset(void *ctx, const xmlChar *name, const xmlChar *external_id, const xmlChar *system_id) {
+	auto &state = StreamingCollectState::Get(ctx);
+	state.unsupported = true;
+	xmlStopParser(state.parser);
+}
+
+} // namespace
+
+StreamingMatchResult StreamingXPathMatcher::FindFirst(const StreamingXPath &path, const char *data, idx_t size,
+                                                      std::string *value) {
+	StreamingFirstState state;
+	state.path = &path;
+	state.value = value;
+	state.open_states.push_back(1);
+	state.matched_bit = uint64_t(1) << path.steps.size();
+	if (value) {
+		value->clear();
+	}
+
+	xmlSAXHandler handler {};
+	handler.initialized = XML_SAX2_MAGIC;
+	handler.startElementNs = FirstStartElement;
+	handler.endElementNs = FirstEndElement;
+	handler.characters = FirstCharacters;
+	handler.ignorableWhitespace = FirstCharacters;
+	handler.cdataBlock = FirstCdataBlock;
+	handler.comment = FirstComment;
+	handler.processingInstruction = FirstProcessingInstruction;
+	handler.internalSubset = FirstInternalSubset;
+
+	state.parser = CreateStreamingParser(handler, &state);
+	if (!state.parser) {
+		return StreamingMatchResult::UNSUPPORTED;
+	}
+	FeedStreamingParser(state.parser, data, size, CHUNK_SIZE, [&]() { return state.Done(); });
+	xmlFreeParserCtxt(state.parser);
+
+	if (state.unsupported) {
+		return StreamingMatchResult::UNSUPPORTED;
+	}
+	if (!state.found) {
+		// A well-formedness error stops the callbacks, so a value cut short by one is not reported
+		if (value) {
+			value->clear();
+		}
+		return StreamingMatchResult::NO_MATCH;
+	}
+	return StreamingMatchResult::MATCH;
+}
+
+StreamingMatchResult StreamingXPathMatcher::ForEachMatch(const StreamingXPath &path, const char *data, idx_t size,
+                                                         const std::function<void(xmlNodePtr)> &process_node) {
+	StreamingCollectState state;
+	state.path = &path;
+	state.open_elements.push_back(StreamingOpenElement {1, true, false});
+	state.matched_bit = uint64_t(1) << path.steps.size();
+
+	// libxml2's SAX2 defaults create the document; the element and character callbacks decide what
+	// is passed on to the tree builder
+	xmlSAXHandler handler;
+	xmlSAXVersion(&handler, 2);
+	handler.startElementNs = CollectStartElement;
+	handler.endElementNs = CollectEndElement;
+	handler.characters = CollectCharacters;
+	handler.ignorableWhitespace = CollectCharacters;
+	handler.cdataBlock = CollectCdataBlock;
+	handler.comment = CollectComment;
+	handler.processingInstruction = CollectProcessingInstruction;
+	handler.internalSubset = CollectInternalSubset;
+
+	state.parser = CreateStreamingParser(handler, nullptr);
+	if (!state.parser) {
+		return StreamingMatchResult::UNSUPPORTED;
+	}
+	state.parser->_private = &state;
+	bool well_formed =
+	    FeedStreamingParser(state.parser, data, size, CHUNK_SIZE, [&]() { return state.unsupported; });
+	XMLDocPtr doc(state.parser->myDoc);
+	state.parser->myDoc = nullptr;
+	xmlFreeParserCtxt(state.parser);
+
+	if (state.unsupported) {
+		return StreamingMatchResult::UNSUPPORTED;
+	}
+	if (!well_formed || state.matches.empty()) {
+		return StreamingMatchResult::NO_MATCH;
+	}
+	for (auto node : state.matches) {
+		process_node(node);
+	}
+	return StreamingMatchResult::MATCH;
+}
+
+} // namespace duckdb
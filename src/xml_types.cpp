@@ -1,10 +1,13 @@
 #include "xml_types.hpp"
 #include "xml_utils.hpp"
+#include "xml_sax_analyzer.hpp"
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/catalog/catalog_entry/type_catalog_entry.hpp"
 #include "duckdb/parser/parsed_data/create_type_info.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
 #include "duckdb/common/types.hpp"
+#include "duckdb/main/client_context.hpp"
 #include "duckdb/main/config.hpp"
 #include "duckdb/main/connection.hpp"
 #include "duckdb/main/database.hpp"
@@ -63,27 +66,84 @@ bool XMLTypes::XMLToVarcharCast(Vector &source, Vector &result, idx_t count, Cas
 	return true;
 }
 
+// Whether the client running the cast has xml_validate_casts set, read once per query
+struct VarcharToXMLCastLocalState : public FunctionLocalState {
+	explicit VarcharToXMLCastLocalState(bool validate_p) : validate(validate_p) {
+	}
+	bool validate;
+};
+
+unique_ptr<FunctionLocalState> XMLTypes::InitVarcharToXMLCastLocalState(CastLocalStateParameters &parameters) {
+	Value value;
+	bool validate = parameters.context && parameters.context->TryGetCurrentSetting("xml_validate_casts", value) &&
+	                !value.IsNull() && value.GetValue<bool>();
+	return make_uniq<VarcharToXMLCastLocalState>(validate);
+}
+
 bool XMLTypes::VarcharToXMLCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	// VARCHAR to XML: validate the XML if strict casting is enabled
-	// For now, just copy the data - validation will be done by xml_valid() function
+	// VARCHAR to XML: a plain copy, unless xml_validate_casts asks for every value to be checked
+	// (without building its tree). A value that is not well-formed is an error, or NULL under TRY_CAST.
+	// A cast run without a client (no local state) does not check.
+	if (!parameters.local_state || !parameters.local_state->Cast<VarcharToXMLCastLocalState>().validate) {
+		VectorOperations::Copy(source, result, count, 0, 0);
+		return true;
+	}
+	bool success = true;
+	UnaryExecutor::ExecuteWithNulls<string_t, string_t>(
+	    source, result, count, [&](string_t input, ValidityMask &mask, idx_t idx) {
+		    auto validity = XMLUtils::CheckXML(input);
+		    if (validity == XMLValidity::ResourceError) {
+			    throw OutOfMemoryException("Failed to cast to XML: libxml2 could not allocate memory (the system may "
+			                               "be under memory pressure)");
+		    }
+		    if (validity != XMLValidity::Valid) {
+			    mask.SetInvalid(idx);
+			    if (success) {
+				    HandleCastError::AssignError("Could not convert string to XML: not a well-formed XML document",
+				                                 parameters);
+				    success = false;
+			    }
+		    }
+		    return input;
+	    });
+	StringVector::AddHeapReference(result, source);
+	return success;
+}
+
+bool XMLTypes::VarcharToXMLFragmentCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	// A fragment need not be a single-rooted document, so there is nothing to check
 	VectorOperations::Copy(source, result, count, 0, 0);
 	return true;
 }
 
 bool XMLTypes::XMLToJSONCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	// This will be implemented in Phase 4 - XML to JSON conversion
-	// For now, throw an error
-	throw NotImplementedException("XML to JSON conversion not yet implemented");
+	// The conversion xml_to_json performs with its default options
+	XMLToJSONWriter writer {XMLToJSONOptions()};
+	UnaryExecutor::Execute<string_t, string_t>(source, result, count, [&](string_t xml_input) {
+		return StringVector::AddString(result, XMLUtils::XMLToJSON(xml_input, writer));
+	});
+	return true;
 }
 
 bool XMLTypes::JSONToXMLCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	// Convert JSON to XML using our existing JSONToXML utility
-	UnaryExecutor::Execute<string_t, string_t>(source, result, count, [&](string_t json_input) {
-		std::string json_str = json_input.GetString();
-		std::string xml_result = XMLUtils::JSONToXML(json_str);
-		return StringVector::AddString(result, xml_result);
-	});
-	return true;
+	// The conversion json_to_xml performs. A value that cannot be converted is an error, or NULL under
+	// TRY_CAST.
+	bool success = true;
+	std::string xml;
+	std::string error;
+	UnaryExecutor::ExecuteWithNulls<string_t, string_t>(
+	    source, result, count, [&](string_t json_input, ValidityMask &mask, idx_t idx) {
+		    if (!XMLUtils::TryJSONToXML(json_input, xml, error)) {
+			    mask.SetInvalid(idx);
+			    if (success) {
+				    HandleCastError::AssignError("Could not convert JSON to XML: " + error, parameters);
+				    success = false;
+			    }
+			    return string_t();
+		    }
+		    return StringVector::AddString(result, xml);
+	    });
+	return success;
 }
 
 bool XMLTypes::HTMLToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
@@ -133,13 +193,15 @@ void XMLTypes::Register(ExtensionLoader &loader) {
 	// Register cast functions for XML type conversion
 	// XML/HTML -> VARCHAR: implicit with cost 1 (allows string functions, but prefers XML overloads)
 	// VARCHAR -> XML/HTML: explicit only (-1) to avoid overload ambiguity
-	loader.RegisterCastFunction(LogicalType::VARCHAR, xml_type, VarcharToXMLCast);
+	loader.RegisterCastFunction(LogicalType::VARCHAR, xml_type,
+	                            BoundCastInfo(VarcharToXMLCast, nullptr, InitVarcharToXMLCastLocalState));
 	loader.RegisterCastFunction(xml_type, LogicalType::VARCHAR, XMLToVarcharCast, 1);
 
 	// Register cast functions for XMLFragment type conversion
-	loader.RegisterCastFunction(LogicalType::VARCHAR, xml_fragment_type, VarcharToXMLCast);
+	loader.RegisterCastFunction(LogicalType::VARCHAR, xml_fragment_type, VarcharToXMLFragmentCast);
 	loader.RegisterCastFunction(xml_fragment_type, LogicalType::VARCHAR, XMLToVarcharCast, 1);
-	loader.RegisterCastFunction(xml_fragment_type, xml_type, VarcharToXMLCast, 1);
+	loader.RegisterCastFunction(xml_fragment_type, xml_type,
+	                            BoundCastInfo(VarcharToXMLCast, nullptr, InitVarcharToXMLCastLocalState), 1);
 
 	// Register cast functions for HTML type conversion
 	loader.RegisterCastFunction(LogicalType::VARCHAR, html_type, VarcharToHTMLCast);
@@ -147,10 +209,11 @@ void XMLTypes::Register(ExtensionLoader &loader) {
 	loader.RegisterCastFunction(xml_type, html_type, XMLToHTMLCast, 1);
 	loader.RegisterCastFunction(html_type, xml_type, HTMLToXMLCast, 1);
 
-	// Register JSON to XML cast (JSON extension is loaded during XML extension initialization)
+	// Register JSON <-> XML casts (JSON extension is loaded during XML extension initialization)
 	try {
 		auto json_type = LogicalType::JSON();
 		loader.RegisterCastFunction(json_type, xml_type, JSONToXMLCast);
+		loader.RegisterCastFunction(xml_type, json_type, XMLToJSONCast);
 	} catch (...) {
 		// JSON type might not be available, but this shouldn't prevent XML extension from loading
 	}
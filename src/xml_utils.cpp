@@ -1,8 +1,17 @@
 #include "xml_utils.hpp"
 #include "xml_types.hpp"
 #include "xml_in_memory_reader.hpp"
+#include "xml_sax_analyzer.hpp"
+#include "xml_schema_validator.hpp"
 #include "duckdb_compat.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/config.hpp"
+#include "yyjson.hpp"
 #include <libxml/xmlerror.h>
 #include <libxml/xmlschemas.h>
 #include <libxml/HTMLparser.h>
@@ -10,14 +19,15 @@
 #include <libxml/xpathInternals.h>
 #include <libxml/valid.h>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstring>
 #include <iostream>
 #include <functional>
-#include <map>
 #include <mutex>
-#include <regex>
 #include <set>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace duckdb {
@@ -60,53 +70,6 @@ xmlParserInputPtr SecureNoExternalEntityLoader(const char *URL, const char *ID,
 }
 
 } // namespace
-// Escape a UTF-8 string for safe embedding inside a JSON string literal (GitHub Issue #78).
-// libxml2 returns entity-decoded text (e.g. &quot; -> ", &#10; -> newline), so characters that
-// are illegal raw inside a JSON string must be re-escaped here at emit time. Only " , \ and the
-// C0 control range (0x00-0x1F) require escaping per RFC 8259; raw UTF-8 multibyte sequences and
-// characters such as / < > & are valid unescaped and are passed through untouched.
-static std::string EscapeJSONString(const std::string &input) {
-	std::string out;
-	out.reserve(input.size() + 8);
-	for (unsigned char c : input) {
-		switch (c) {
-		case '"':
-			out += "\\\"";
-			break;
-		case '\\':
-			out += "\\\\";
-			break;
-		case '\b':
-			out += "\\b";
-			break;
-		case '\f':
-			out += "\\f";
-			break;
-		case '\n':
-			out += "\\n";
-			break;
-		case '\r':
-			out += "\\r";
-			break;
-		case '\t':
-			out += "\\t";
-			break;
-		default:
-			if (c < 0x20) {
-				// Remaining C0 control characters: emit as \u00XX (lowercase hex).
-				static const char *hex = "0123456789abcdef";
-				out += "\\u00";
-				out += hex[(c >> 4) & 0xF];
-				out += hex[c & 0xF];
-			} else {
-				out += static_cast<char>(c);
-			}
-			break;
-		}
-	}
-	return out;
-}
-
 // Silent error handler for schema validation (with varargs to match xmlSchemaValidityErrorFunc)
 void XMLSilentSchemaErrorHandler(void *ctx, const char *msg, ...) {
 	// Silently ignore schema validation errors without printing to stderr.
@@ -116,9 +79,8 @@ void XMLSilentSchemaErrorHandler(void *ctx, const char *msg, ...) {
 // Forward declarations for namespace handling helpers (defined later in file)
 // These are public functions declared in xml_utils.hpp
 std::string GetCommonNamespaceURI(const std::string &prefix);
-std::set<std::string> DetectDocumentPrefixes(const std::string &xml_str);
-std::string InjectNamespaceDeclarations(const std::string &xml_str,
-                                        const case_insensitive_map_t<string> &namespaces_to_inject);
+std::string TransformXPathForUndeclaredPrefixes(const std::string &xpath,
+                                                const case_insensitive_map_t<string> &undeclared_prefixes);
 
 // Silent structured error handler for XPath errors (thread-safe, per-context)
 // This handler is set on individual XPath contexts to suppress errors like "Undefined namespace prefix"
@@ -127,84 +89,19 @@ void XMLSilentXPathErrorHandler(void *ctx, const xmlError *error) {
 	// This is thread-safe because it's set per-context, not globally
 }
 
-// Helper function to register all namespace declarations from the document into the XPath context.
-// This enables XPath expressions like "//gml:posList" to work when xmlns:gml="..." is declared.
-// Without this, libxml2's XPath engine requires manual registration of each namespace prefix.
-// See: https://grantm.github.io/perl-libxml-by-example/namespaces.html
-static void RegisterDocumentNamespaces(xmlDocPtr doc, xmlXPathContextPtr xpath_ctx) {
-	if (!doc || !xpath_ctx) {
-		return;
-	}
-
-	xmlNodePtr root = xmlDocGetRootElement(doc);
-	if (!root) {
-		return;
-	}
-
-	// Get all in-scope namespaces for the root element
-	xmlNsPtr *nsList = xmlGetNsList(doc, root);
-	if (!nsList) {
-		return;
-	}
-
-	// Register each namespace with a prefix
-	for (int i = 0; nsList[i] != NULL; i++) {
-		xmlNsPtr ns = nsList[i];
-		// Only register namespaces that have a prefix (skip default namespace)
-		// Default namespace (prefix=NULL) cannot be used in XPath 1.0 expressions directly
-		if (ns->prefix && ns->href) {
-			xmlXPathRegisterNs(xpath_ctx, ns->prefix, ns->href);
-		}
-	}
-
-	// Free the array (but not the namespace structures themselves, they belong to the document)
-	xmlFree(nsList);
+XMLDocRAII::XMLDocRAII(const std::string &xml_str) {
+	Parse(xml_str.data(), xml_str.size(), false);
 }
 
-XMLDocRAII::XMLDocRAII(const std::string &xml_str) {
-	// Parse the XML with options to suppress error messages (thread-safe, per-operation config)
-	// XML_PARSE_NOERROR: suppress error reports to stderr
-	// XML_PARSE_NOWARNING: suppress warning reports to stderr
-	// XML_PARSE_NONET: forbid network access. We deliberately do NOT set XML_PARSE_NOENT,
-	//   XML_PARSE_DTDLOAD or XML_PARSE_DTDVALID, so external entities are never substituted or
-	//   fetched. The fail-closed entity loader (EnsureSecureParsing) is the primary XXE defense;
-	//   NONET is belt-and-suspenders for the network case.
-	// Note: We intentionally DO NOT use XML_PARSE_RECOVER to maintain strict parsing behavior
-	XMLUtils::EnsureSecureParsing();
-	xmlParserCtxtPtr parser_ctx = xmlNewParserCtxt();
-	if (parser_ctx) {
-		XMLInMemoryReader reader {xml_str.data(), xml_str.size(), 0};
-		doc = xmlCtxtReadIO(parser_ctx, XMLInMemoryReaderRead, XMLInMemoryReaderClose, &reader, nullptr, nullptr,
-		                    XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
-
-		// Check if parsing failed (NULL doc means fatal error)
-		if (!doc) {
-			// Capture whether the failure was an allocation failure rather than malformed
-			// input. The error object belongs to the parser context, so read it before free.
-			const xmlError *last_error = xmlCtxtGetLastError(parser_ctx);
-			if (last_error && last_error->code == XML_ERR_NO_MEMORY) {
-				resource_error = true;
-			}
-		}
-		xmlFreeParserCtxt(parser_ctx);
-	} else {
-		// The parser context itself could not be allocated, which only happens when
-		// libxml2 is out of memory. Treat it as a resource failure, not malformed input.
-		resource_error = true;
-	}
+XMLDocRAII::XMLDocRAII(const std::string &content, bool is_html) {
+	Parse(content.data(), content.size(), is_html);
+}
 
-	if (doc) {
-		xpath_ctx = xmlXPathNewContext(doc);
-		// Set silent error handler on XPath context (thread-safe, per-context)
-		if (xpath_ctx) {
-			xmlXPathSetErrorHandler(xpath_ctx, XMLSilentXPathErrorHandler, nullptr);
-			// Register all namespace declarations from the document so XPath with prefixes works
-			RegisterDocumentNamespaces(doc, xpath_ctx);
-		}
-	}
+XMLDocRAII::XMLDocRAII(const string_t &content, bool is_html) {
+	Parse(content.GetData(), content.GetSize(), is_html);
 }
 
-XMLDocRAII::XMLDocRAII(const std::string &content, bool is_html) {
+void XMLDocRAII::Parse(const char *data, idx_t size, bool is_html) {
 	XMLUtils::EnsureSecureParsing();
 
 	if (is_html) {
@@ -214,15 +111,21 @@ XMLDocRAII::XMLDocRAII(const std::string &content, bool is_html) {
 		// which would cause UTF-8 multi-byte characters to be misinterpreted (Issue #53)
 		// TODO: Future enhancement - consider making encoding configurable via parameter
 		// (with UTF-8 as default) or deriving it from database collation settings
-		XMLInMemoryReader reader {content.data(), content.size(), 0};
+		XMLInMemoryReader reader {data, size, 0};
 		doc = htmlReadIO(XMLInMemoryReaderRead, XMLInMemoryReaderClose, &reader, nullptr, "UTF-8",
 		                 HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING | HTML_PARSE_NONET);
 	} else {
-		// Parse as XML with error message suppression (thread-safe, per-operation config)
-		// Do NOT use RECOVER flag to maintain strict XML parsing behavior
+		// Parse the XML with options to suppress error messages (thread-safe, per-operation config)
+		// XML_PARSE_NOERROR: suppress error reports to stderr
+		// XML_PARSE_NOWARNING: suppress warning reports to stderr
+		// XML_PARSE_NONET: forbid network access. We deliberately do NOT set XML_PARSE_NOENT,
+		//   XML_PARSE_DTDLOAD or XML_PARSE_DTDVALID, so external entities are never substituted or
+		//   fetched. The fail-closed entity loader (EnsureSecureParsing) is the primary XXE defense;
+		//   NONET is belt-and-suspenders for the network case.
+		// Note: We intentionally DO NOT use XML_PARSE_RECOVER to maintain strict parsing behavior
 		xmlParserCtxtPtr parser_ctx = xmlNewParserCtxt();
 		if (parser_ctx) {
-			XMLInMemoryReader reader {content.data(), content.size(), 0};
+			XMLInMemoryReader reader {data, size, 0};
 			doc = xmlCtxtReadIO(parser_ctx, XMLInMemoryReaderRead, XMLInMemoryReaderClose, &reader, nullptr, nullptr,
 			                    XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
 			if (!doc) {
@@ -246,8 +149,8 @@ XMLDocRAII::XMLDocRAII(const std::string &content, bool is_html) {
 		// Set silent error handler on XPath context (thread-safe, per-context)
 		if (xpath_ctx) {
 			xmlXPathSetErrorHandler(xpath_ctx, XMLSilentXPathErrorHandler, nullptr);
-			// Register all namespace declarations from the document so XPath with prefixes works
-			RegisterDocumentNamespaces(doc, xpath_ctx);
+			// Namespace prefixes are registered on demand by XMLUtils::EvaluateXPath, for the
+			// prefixes an expression actually uses
 		}
 	}
 }
@@ -334,6 +237,18 @@ void XMLUtils::EnsureSecureParsing() {
 	});
 }
 
+// A string_t over `str`'s buffer, so the std::string overloads can delegate to the string_t ones
+// without copying. A string_t holds at most 4 GiB (as does any SQL value), so a larger document
+// is rejected here with its size rather than by a failed length cast.
+static string_t StringRef(const std::string &str) {
+	if (str.size() > NumericLimits<uint32_t>::Maximum()) {
+		throw InvalidInputException("Document of %llu bytes is too large: at most %llu bytes can be processed at once",
+		                            static_cast<idx_t>(str.size()),
+		                            static_cast<idx_t>(NumericLimits<uint32_t>::Maximum()));
+	}
+	return string_t(str.data(), static_cast<uint32_t>(str.size()));
+}
+
 void XMLUtils::InitializeLibXML() {
 	xmlInitParser();
 	LIBXML_TEST_VERSION;
@@ -347,20 +262,73 @@ void XMLUtils::CleanupLibXML() {
 	xmlCleanupParser();
 }
 
+// internalSubset callback of the well-formedness check. A DOCTYPE can declare entities, which only a
+// DOM parse records, so the check stops and leaves such documents to one.
+static void WellFormedInternalSubset(void *ctx, const xmlChar *name, const xmlChar *external_id,
+                                     const xmlChar *system_id) {
+	auto parser_ctx = static_cast<xmlParserCtxtPtr>(ctx);
+	parser_ctx->_private = parser_ctx;
+	xmlStopParser(parser_ctx);
+}
+
+// Checks well-formedness with the same pull parser and options as XMLDocRAII, but with every SAX
+// callback left empty, so no tree is built and the input is only scanned. False when the document
+// has a DOCTYPE and must be checked on a DOM instead.
+static bool TryCheckWellFormed(const char *data, idx_t size, XMLValidity &validity) {
+	XMLUtils::EnsureSecureParsing();
+	xmlParserCtxtPtr parser_ctx = xmlNewParserCtxt();
+	if (!parser_ctx) {
+		validity = XMLValidity::ResourceError;
+		return true;
+	}
+	xmlSAXHandlerPtr sax = parser_ctx->sax;
+	memset(sax, 0, sizeof(*sax));
+	sax->initialized = XML_SAX2_MAGIC;
+	sax->internalSubset = WellFormedInternalSubset;
+
+	XMLInMemoryReader reader {data, size, 0};
+	xmlDocPtr doc = xmlCtxtReadIO(parser_ctx, XMLInMemoryReaderRead, XMLInMemoryReaderClose, &reader, nullptr, nullptr,
+	                              XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
+	if (doc) {
+		xmlFreeDoc(doc);
+	}
+	bool has_doctype = parser_ctx->_private != nullptr;
+	if (parser_ctx->wellFormed) {
+		validity = XMLValidity::Valid;
+	} else {
+		const xmlError *last_error = xmlCtxtGetLastError(parser_ctx);
+		bool out_of_memory = last_error && last_error->code == XML_ERR_NO_MEMORY;
+		validity = out_of_memory ? XMLValidity::ResourceError : XMLValidity::Malformed;
+	}
+	xmlFreeParserCtxt(parser_ctx);
+	return !has_doctype;
+}
+
 bool XMLUtils::IsValidXML(const std::string &xml_str) {
-	// Validity is determined solely by this thread's own parse result (doc != nullptr).
+	// Validity is determined solely by this thread's own parse result.
 	// A shared process-global flag must never gate the result: another thread's failed
 	// parse could otherwise poison this check and mislabel a valid document as invalid
 	// under concurrent execution.
-	XMLDocRAII xml_doc(xml_str);
-	return xml_doc.IsValid();
+	return CheckXML(xml_str) == XMLValidity::Valid;
+}
+
+bool XMLUtils::IsValidXML(const string_t &xml_str) {
+	return CheckXML(xml_str) == XMLValidity::Valid;
 }
 
 bool XMLUtils::IsWellFormedXML(const std::string &xml_str) {
 	return IsValidXML(xml_str);
 }
 
+bool XMLUtils::IsWellFormedXML(const string_t &xml_str) {
+	return IsValidXML(xml_str);
+}
+
 XMLValidity XMLUtils::CheckXML(const std::string &xml_str) {
+	XMLValidity validity;
+	if (TryCheckWellFormed(xml_str.data(), xml_str.size(), validity)) {
+		return validity;
+	}
 	XMLDocRAII xml_doc(xml_str);
 	if (xml_doc.IsValid()) {
 		return XMLValidity::Valid;
@@ -370,6 +338,76 @@ XMLValidity XMLUtils::CheckXML(const std::string &xml_str) {
 	return xml_doc.HadResourceError() ? XMLValidity::ResourceError : XMLValidity::Malformed;
 }
 
+XMLValidity XMLUtils::CheckXML(const string_t &xml_str) {
+	XMLValidity validity;
+	if (TryCheckWellFormed(xml_str.GetData(), xml_str.GetSize(), validity)) {
+		return validity;
+	}
+	XMLDocRAII xml_doc(xml_str);
+	if (xml_doc.IsValid()) {
+		return XMLValidity::Valid;
+	}
+	return xml_doc.HadResourceError() ? XMLValidity::ResourceError : XMLValidity::Malformed;
+}
+
+XMLValidity XMLUtils::CheckXML(const std::string &xml_str, idx_t &dom_footprint) {
+	dom_footprint = 0;
+	XMLDocRAII xml_doc(xml_str);
+	if (xml_doc.IsValid()) {
+		dom_footprint = EstimateDOMFootprint(xml_doc.doc);
+		return XMLValidity::Valid;
+	}
+	return xml_doc.HadResourceError() ? XMLValidity::ResourceError : XMLValidity::Malformed;
+}
+
+idx_t XMLUtils::GetMemorySetting(ClientContext &context, const char *name, idx_t default_bytes) {
+	Value value;
+	if (!context.TryGetCurrentSetting(name, value) || value.IsNull()) {
+		return default_bytes;
+	}
+	return DBConfig::ParseMemoryLimit(value.ToString());
+}
+
+idx_t XMLUtils::EstimateDOMFootprint(xmlDocPtr doc) {
+	if (!doc) {
+		return 0;
+	}
+	idx_t bytes = sizeof(xmlDoc);
+	// Iterative pre-order walk: documents near the depth limit would overflow a recursive one.
+	xmlNodePtr node = doc->children;
+	while (node) {
+		bytes += sizeof(xmlNode);
+		if (node->content) {
+			bytes += xmlStrlen(node->content) + 1;
+		}
+		if (node->type == XML_ELEMENT_NODE) {
+			for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
+				bytes += sizeof(xmlAttr);
+				for (xmlNodePtr value = attr->children; value; value = value->next) {
+					bytes += sizeof(xmlNode) + (value->content ? xmlStrlen(value->content) + 1 : 0);
+				}
+			}
+			for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next) {
+				bytes += sizeof(xmlNs) + (ns->href ? xmlStrlen(ns->href) + 1 : 0);
+			}
+		}
+		if (node->children && node->type != XML_ENTITY_REF_NODE) {
+			node = node->children;
+			continue;
+		}
+		while (node && !node->next) {
+			node = node->parent;
+			if (node == reinterpret_cast<xmlNodePtr>(doc)) {
+				node = nullptr;
+			}
+		}
+		if (node) {
+			node = node->next;
+		}
+	}
+	return bytes;
+}
+
 std::string XMLUtils::GetNodePath(xmlNodePtr node) {
 	if (!node)
 		return "";
@@ -451,16 +489,382 @@ XMLElement XMLUtils::ProcessXMLNode(xmlNodePtr node) {
 	return element;
 }
 
-std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, const std::string &xpath) {
+XMLCompiledXPathPtr XMLUtils::CompileXPath(const std::string &xpath) {
+	// Compile against a document-less context so the silent error handler applies; prefixes and
+	// functions are resolved against the evaluation context later, not here.
+	xmlXPathContextPtr compile_ctx = xmlXPathNewContext(nullptr);
+	if (!compile_ctx) {
+		return nullptr;
+	}
+	xmlXPathSetErrorHandler(compile_ctx, XMLSilentXPathErrorHandler, nullptr);
+	XMLCompiledXPathPtr compiled(xmlXPathCtxtCompile(compile_ctx, BAD_CAST xpath.c_str()));
+	xmlXPathFreeContext(compile_ctx);
+	return compiled;
+}
+
+// A prefixed name in an XPath expression, as offsets into the expression: the prefix spans
+// [start, colon) and the local part (a name or `*`) spans (colon, end). Prefixed function calls
+// are flagged, since only name tests can be rewritten.
+struct XPathQName {
+	idx_t start;
+	idx_t colon;
+	idx_t end;
+	bool is_function;
+};
+
+static bool IsXPathNameStartChar(unsigned char c) {
+	return std::isalpha(c) || c == '_' || c >= 0x80;
+}
+
+static bool IsXPathNameChar(unsigned char c) {
+	return IsXPathNameStartChar(c) || std::isdigit(c) || c == '.' || c == '-';
+}
+
+// Call `callback` with each prefixed name in `xpath`. String literals, variable references and
+// axis names (`child::`) are skipped.
+template <class CALLBACK>
+static void ForEachXPathQName(const std::string &xpath, CALLBACK &&callback) {
+	idx_t size = xpath.size();
+	idx_t pos = 0;
+	while (pos < size) {
+		unsigned char c = xpath[pos];
+		if (c == '"' || c == '\'') {
+			auto close = xpath.find(static_cast<char>(c), pos + 1);
+			pos = close == std::string::npos ? size : close + 1;
+			continue;
+		}
+		bool is_variable = c == '$';
+		if (!is_variable && !IsXPathNameStartChar(c)) {
+			pos++;
+			continue;
+		}
+		idx_t start = is_variable ? pos + 1 : pos;
+		pos = start;
+		while (pos < size && IsXPathNameChar(xpath[pos])) {
+			pos++;
+		}
+		if (pos == start || pos + 1 >= size || xpath[pos] != ':' || xpath[pos + 1] == ':') {
+			continue;
+		}
+		idx_t colon = pos++;
+		if (xpath[pos] == '*') {
+			pos++;
+		} else if (IsXPathNameStartChar(xpath[pos])) {
+			while (pos < size && IsXPathNameChar(xpath[pos])) {
+				pos++;
+			}
+		} else {
+			continue;
+		}
+		if (is_variable) {
+			continue;
+		}
+		idx_t next = pos;
+		while (next < size && std::isspace(static_cast<unsigned char>(xpath[next]))) {
+			next++;
+		}
+		callback(XPathQName {start, colon, pos, next < size && xpath[next] == '('});
+	}
+}
+
+// Register the namespaces `xpath` refers to by prefix that are in scope on the document root and
+// not yet known to the context. Registration is idempotent for a given document, so contexts of
+// cached documents can accumulate prefixes across calls.
+static void RegisterReferencedNamespaces(const std::string &xpath, xmlXPathContextPtr xpath_ctx) {
+	if (!xpath_ctx || !xpath_ctx->doc || xpath.find(':') == std::string::npos) {
+		return;
+	}
+	xmlNodePtr root = xmlDocGetRootElement(xpath_ctx->doc);
+	if (!root) {
+		return;
+	}
+	ForEachXPathQName(xpath, [&](const XPathQName &qname) {
+		std::string prefix = xpath.substr(qname.start, qname.colon - qname.start);
+		if (xmlXPathNsLookup(xpath_ctx, BAD_CAST prefix.c_str())) {
+			return;
+		}
+		xmlNsPtr ns = xmlSearchNs(xpath_ctx->doc, root, BAD_CAST prefix.c_str());
+		if (ns && ns->href) {
+			xmlXPathRegisterNs(xpath_ctx, ns->prefix, ns->href);
+		}
+	});
+}
+
+xmlXPathObjectPtr XMLUtils::EvaluateXPath(const std::string &xpath, xmlXPathContextPtr xpath_ctx,
+                                          xmlXPathCompExprPtr compiled) {
+	RegisterReferencedNamespaces(xpath, xpath_ctx);
+	if (compiled) {
+		return xmlXPathCompiledEval(compiled, xpath_ctx);
+	}
+	return xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xpath_ctx);
+}
+
+xmlXPathCompExprPtr XPathCompileCache::Lookup(const std::string &xpath) {
+	for (auto it = entries.begin(); it != entries.end(); ++it) {
+		if (it->first == xpath) {
+			entries.splice(entries.begin(), entries, it);
+			return entries.front().second.get();
+		}
+	}
+	auto compiled = XMLUtils::CompileXPath(xpath);
+	if (!compiled) {
+		// Not cached: the caller's fallback evaluation fails the same way
+		return nullptr;
+	}
+	entries.emplace_front(xpath, std::move(compiled));
+	if (entries.size() > CAPACITY) {
+		entries.pop_back();
+	}
+	return entries.front().second.get();
+}
+
+namespace {
+
+std::atomic<idx_t> document_cache_hits {0};
+std::atomic<idx_t> document_cache_misses {0};
+std::atomic<idx_t> document_cache_evictions {0};
+
+struct CachedDocument {
+	hash_t hash;
+	bool is_html;
+	std::string content;
+	XMLDocRAII doc;
+	idx_t bytes;
+};
+
+struct ThreadDocumentCache {
+	std::list<CachedDocument> entries; // most recently used first
+	std::unordered_multimap<hash_t, std::list<CachedDocument>::iterator> index;
+	idx_t bytes = 0;
+
+	void EvictUntil(idx_t capacity) {
+		while (bytes > capacity && !entries.empty()) {
+			auto &victim = entries.back();
+			auto range = index.equal_range(victim.hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				if (&*it->second == &victim) {
+					index.erase(it);
+					break;
+				}
+			}
+			bytes -= victim.bytes;
+			entries.pop_back();
+			document_cache_evictions.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+// The document caches of one client's queries: one per thread that evaluates XML functions for the
+// running query. They are dropped when the query ends, once no thread is using them any more, so
+// parsed documents never outlive the query that parsed them.
+class DocumentCacheClientState : public ClientContextState {
+public:
+	explicit DocumentCacheClientState(ClientContext &context) : capacity(XMLDocumentCache::GetCapacity(context)) {
+	}
+
+	void QueryBegin(ClientContext &context) override {
+		capacity = XMLDocumentCache::GetCapacity(context);
+	}
+
+	void QueryEnd(ClientContext &context) override {
+		std::lock_guard<std::mutex> guard(lock);
+		caches.clear();
+	}
+
+	ThreadDocumentCache &ForThisThread() {
+		std::lock_guard<std::mutex> guard(lock);
+		auto &cache = caches[std::this_thread::get_id()];
+		if (!cache) {
+			cache = make_uniq<ThreadDocumentCache>();
+		}
+		return *cache;
+	}
+
+	// Settings cannot change while a query runs, so the budget is read once per query
+	idx_t capacity;
+
+private:
+	std::mutex lock;
+	std::unordered_map<std::thread::id, unique_ptr<ThreadDocumentCache>> caches;
+};
+
+// The cache the innermost XMLDocumentCache::Scope on this thread opened; none outside any scope
+thread_local ThreadDocumentCache *active_document_cache = nullptr;
+thread_local idx_t active_document_cache_capacity = 0;
+
+XMLDocRAII &GetCachedDocument(const char *data, idx_t size, bool is_html, XMLDocRAII &uncached) {
+	auto capacity = active_document_cache_capacity;
+	if (!active_document_cache || capacity == 0) {
+		uncached = XMLDocRAII();
+		uncached.Parse(data, size, is_html);
+		return uncached;
+	}
+	auto &cache = *active_document_cache;
+
+	auto hash = Hash(data, size);
+	auto range = cache.index.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		auto entry = it->second;
+		if (entry->is_html == is_html && entry->content.size() == size &&
+		    memcmp(entry->content.data(), data, size) == 0) {
+			document_cache_hits.fetch_add(1, std::memory_order_relaxed);
+			cache.entries.splice(cache.entries.begin(), cache.entries, entry);
+			// Evaluation may leave the context positioned on another node; start from the document again
+			auto xpath_ctx = entry->doc.xpath_ctx;
+			if (xpath_ctx) {
+				xpath_ctx->node = nullptr;
+				xpath_ctx->contextSize = -1;
+				xpath_ctx->proximityPosition = -1;
+			}
+			return entry->doc;
+		}
+	}
+
+	document_cache_misses.fetch_add(1, std::memory_order_relaxed);
+	XMLDocRAII parsed;
+	parsed.Parse(data, size, is_html);
+	// Malformed input is not cached: rejecting it again is cheap
+	auto bytes = size + XMLUtils::EstimateDOMFootprint(parsed.doc);
+	if (!parsed.IsValid() || bytes > capacity) {
+		uncached = std::move(parsed);
+		return uncached;
+	}
+	cache.EvictUntil(capacity - bytes);
+	// Only a cached document keeps a copy of its text, to verify later hits
+	cache.entries.push_front(CachedDocument {hash, is_html, std::string(data, size), std::move(parsed), bytes});
+	cache.index.emplace(hash, cache.entries.begin());
+	cache.bytes += bytes;
+	return cache.entries.front().doc;
+}
+
+bool ContainsCachedDocument(const char *data, idx_t size, bool is_html) {
+	if (!active_document_cache) {
+		return false;
+	}
+	auto &cache = *active_document_cache;
+	// A document larger than the whole budget is never cached, so skip hashing it
+	if (cache.entries.empty() || size > active_document_cache_capacity) {
+		return false;
+	}
+	auto range = cache.index.equal_range(Hash(data, size));
+	for (auto it = range.first; it != range.second; ++it) {
+		auto &entry = *it->second;
+		if (entry.is_html == is_html && entry.content.size() == size && memcmp(entry.content.data(), data, size) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+XMLDocRAII &XMLDocumentCache::Get(const string_t &content, bool is_html, XMLDocRAII &uncached) {
+	return GetCachedDocument(content.GetData(), content.GetSize(), is_html, uncached);
+}
+
+XMLDocRAII &XMLDocumentCache::Get(const std::string &content, bool is_html, XMLDocRAII &uncached) {
+	return GetCachedDocument(content.data(), content.size(), is_html, uncached);
+}
+
+bool XMLDocumentCache::Contains(const string_t &content, bool is_html) {
+	return ContainsCachedDocument(content.GetData(), content.GetSize(), is_html);
+}
+
+XMLDocumentCache::Scope::Scope(ExpressionState &state)
+    : previous_cache(active_document_cache), previous_capacity(active_document_cache_capacity) {
+	active_document_cache = nullptr;
+	active_document_cache_capacity = 0;
+	if (!state.HasContext()) {
+		return;
+	}
+	auto &context = state.GetContext();
+	auto client_state = context.registered_state->GetOrCreate<DocumentCacheClientState>("webbed_document_cache",
+	                                                                                     context);
+	if (client_state->capacity == 0) {
+		return;
+	}
+	active_document_cache = &client_state->ForThisThread();
+	active_document_cache_capacity = client_state->capacity;
+}
+
+XMLDocumentCache::Scope::~Scope() {
+	active_document_cache = static_cast<ThreadDocumentCache *>(previous_cache);
+	active_document_cache_capacity = previous_capacity;
+}
+
+idx_t XMLDocumentCache::GetCapacity(ClientContext &context) {
+	return XMLUtils::GetMemorySetting(context, "xml_document_cache_size", DEFAULT_CAPACITY);
+}
+
+XMLDocumentCacheStats XMLDocumentCache::GetStats() {
+	XMLDocumentCacheStats stats;
+	stats.hits = document_cache_hits.load(std::memory_order_relaxed);
+	stats.misses = document_cache_misses.load(std::memory_order_relaxed);
+	stats.evictions = document_cache_evictions.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void XMLDocumentCache::ResetStats() {
+	document_cache_hits.store(0, std::memory_order_relaxed);
+	document_cache_misses.store(0, std::memory_order_relaxed);
+	document_cache_evictions.store(0, std::memory_order_relaxed);
+}
+
+// Prepare a parsed document for evaluating `xpath` under a namespace configuration, returning the
+// expression to evaluate. Custom namespaces are registered ahead of the document's own, so they
+// take precedence. A prefix the document root does not declare is resolved without touching the
+// document: with a custom URI, or in AUTO mode its common URI (else a urn:mock: placeholder), its
+// name tests are rewritten to match either that URI or the literal undeclared `prefix:name`.
+static std::string PrepareNamespaceXPath(XMLDocRAII &xml_doc, const std::string &xpath,
+                                         const NamespaceConfig &ns_config) {
+	xml_doc.RegisterCustomNamespaces(ns_config.custom_namespaces);
+	if (ns_config.mode != NamespaceMode::AUTO && !ns_config.HasCustomNamespaces()) {
+		return xpath;
+	}
+	xmlNodePtr root = xmlDocGetRootElement(xml_doc.doc);
+	case_insensitive_map_t<string> undeclared;
+	ForEachXPathQName(xpath, [&](const XPathQName &qname) {
+		std::string prefix = xpath.substr(qname.start, qname.colon - qname.start);
+		if (undeclared.find(prefix) != undeclared.end() ||
+		    (root && xmlSearchNs(xml_doc.doc, root, BAD_CAST prefix.c_str()))) {
+			return;
+		}
+		auto custom = ns_config.custom_namespaces.find(prefix);
+		if (custom != ns_config.custom_namespaces.end()) {
+			undeclared[prefix] = custom->second;
+		} else if (ns_config.mode == NamespaceMode::AUTO) {
+			std::string uri = GetCommonNamespaceURI(prefix);
+			undeclared[prefix] = uri.empty() ? "urn:mock:" + prefix : uri;
+		}
+	});
+	if (undeclared.empty()) {
+		return xpath;
+	}
+	return TransformXPathForUndeclaredPrefixes(xpath, undeclared);
+}
+
+std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, const std::string &xpath,
+                                                 xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractByXPath(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
+
+std::vector<XMLElement> XMLUtils::ExtractByXPath(const string_t &xml_str, const std::string &xpath,
+                                                 xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractByXPath(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
+
+std::vector<XMLElement> XMLUtils::ExtractByXPath(XMLDocRAII &xml_doc, const std::string &xpath,
+                                                 xmlXPathCompExprPtr compiled) {
 	std::vector<XMLElement> results;
 
-	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return results;
 	}
 
 	// XPath evaluation (errors already suppressed during document parsing)
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, compiled);
 
 	if (xpath_obj && xpath_obj->nodesetval) {
 		for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
@@ -490,7 +894,7 @@ std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, con
 	// Register custom namespaces
 	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
 
 	if (xpath_obj && xpath_obj->nodesetval) {
 		for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
@@ -510,55 +914,20 @@ std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, con
 
 std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, const std::string &xpath,
                                                  const NamespaceConfig &ns_config) {
-	std::vector<XMLElement> results;
-
-	// Determine the effective XML to parse
-	std::string effective_xml = xml_str;
-	case_insensitive_map_t<string> namespaces_to_inject;
-
-	// Handle AUTO mode: inject namespace declarations for undeclared prefixes
-	if (ns_config.mode == NamespaceMode::AUTO) {
-		auto doc_prefixes = DetectDocumentPrefixes(xml_str);
-		auto xpath_prefixes = DetectXPathPrefixes(xpath);
-
-		std::set<std::string> all_prefixes;
-		all_prefixes.insert(doc_prefixes.begin(), doc_prefixes.end());
-		all_prefixes.insert(xpath_prefixes.begin(), xpath_prefixes.end());
-
-		for (const auto &prefix : all_prefixes) {
-			std::string decl_pattern = "xmlns:" + prefix + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				std::string uri = GetCommonNamespaceURI(prefix);
-				if (uri.empty()) {
-					uri = "urn:mock:" + prefix;
-				}
-				namespaces_to_inject[prefix] = uri;
-			}
-		}
-	}
-
-	// When explicit custom namespaces are provided, also inject them for undeclared prefixes
-	if (ns_config.HasCustomNamespaces()) {
-		for (const auto &ns : ns_config.custom_namespaces) {
-			std::string decl_pattern = "xmlns:" + ns.first + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				namespaces_to_inject[ns.first] = ns.second;
-			}
-		}
-	}
+	return ExtractByXPath(StringRef(xml_str), xpath, ns_config);
+}
 
-	if (!namespaces_to_inject.empty()) {
-		effective_xml = InjectNamespaceDeclarations(xml_str, namespaces_to_inject);
-	}
+std::vector<XMLElement> XMLUtils::ExtractByXPath(const string_t &xml_str, const std::string &xpath,
+                                                 const NamespaceConfig &ns_config) {
+	std::vector<XMLElement> results;
 
-	XMLDocRAII xml_doc(effective_xml);
+	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return results;
 	}
 
-	xml_doc.RegisterCustomNamespaces(ns_config.custom_namespaces);
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	auto ns_xpath = PrepareNamespaceXPath(xml_doc, xpath, ns_config);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(ns_xpath, xml_doc.xpath_ctx, nullptr);
 
 	if (xpath_obj && xpath_obj->nodesetval) {
 		for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
@@ -577,13 +946,18 @@ std::vector<XMLElement> XMLUtils::ExtractByXPath(const std::string &xml_str, con
 }
 
 std::string XMLUtils::ExtractTextByXPath(const std::string &xml_str, const std::string &xpath) {
-	XMLDocRAII xml_doc(xml_str);
+	return ExtractTextByXPath(StringRef(xml_str), xpath);
+}
+
+std::string XMLUtils::ExtractTextByXPath(const string_t &xml_str, const std::string &xpath) {
+	XMLDocRAII uncached;
+	auto &xml_doc = XMLDocumentCache::Get(xml_str, false, uncached);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return "";
 	}
 
 	// XPath evaluation (errors already suppressed during document parsing)
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
 
 	std::string result;
 	if (xpath_obj) {
@@ -612,7 +986,7 @@ std::string XMLUtils::ExtractTextByXPath(const std::string &xml_str, const std::
 
 	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
 
 	std::string result;
 	if (xpath_obj) {
@@ -632,15 +1006,27 @@ std::string XMLUtils::ExtractTextByXPath(const std::string &xml_str, const std::
 	return result;
 }
 
-std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath) {
+std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath,
+                                                         xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractAllTextByXPath(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
+
+std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const string_t &xml_str, const std::string &xpath,
+                                                         xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractAllTextByXPath(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
+
+std::vector<std::string> XMLUtils::ExtractAllTextByXPath(XMLDocRAII &xml_doc, const std::string &xpath,
+                                                         xmlXPathCompExprPtr compiled) {
 	std::vector<std::string> results;
 
-	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return results;
 	}
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, compiled);
 
 	if (xpath_obj) {
 		if (xpath_obj->nodesetval) {
@@ -672,7 +1058,7 @@ std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_
 
 	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
 
 	if (xpath_obj) {
 		if (xpath_obj->nodesetval) {
@@ -695,69 +1081,20 @@ std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_
 
 std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_str, const std::string &xpath,
                                                          const NamespaceConfig &ns_config) {
-	std::vector<std::string> results;
-
-	// Determine the effective XML to parse
-	std::string effective_xml = xml_str;
-	case_insensitive_map_t<string> namespaces_to_inject;
-
-	// Handle AUTO mode: inject namespace declarations for undeclared prefixes
-	if (ns_config.mode == NamespaceMode::AUTO) {
-		// Scan for prefixes used in the document
-		auto doc_prefixes = DetectDocumentPrefixes(xml_str);
-
-		// Also detect prefixes used in XPath
-		auto xpath_prefixes = DetectXPathPrefixes(xpath);
-
-		// Combine both sets
-		std::set<std::string> all_prefixes;
-		all_prefixes.insert(doc_prefixes.begin(), doc_prefixes.end());
-		all_prefixes.insert(xpath_prefixes.begin(), xpath_prefixes.end());
-
-		// Build namespace map for undeclared prefixes
-		for (const auto &prefix : all_prefixes) {
-			// Check if already declared in document (look for xmlns:prefix=)
-			std::string decl_pattern = "xmlns:" + prefix + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				// Not declared - look up in common namespaces or create mock
-				std::string uri = GetCommonNamespaceURI(prefix);
-				if (uri.empty()) {
-					// Create mock namespace
-					uri = "urn:mock:" + prefix;
-				}
-				namespaces_to_inject[prefix] = uri;
-			}
-		}
-	}
-
-	// When explicit custom namespaces are provided, also inject them for undeclared prefixes
-	// This allows users to provide MAP namespaces for prefixes that aren't declared in the document
-	if (ns_config.HasCustomNamespaces()) {
-		for (const auto &ns : ns_config.custom_namespaces) {
-			// Check if this prefix is declared in the document
-			std::string decl_pattern = "xmlns:" + ns.first + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				// Not declared - inject the user-provided namespace
-				namespaces_to_inject[ns.first] = ns.second;
-			}
-		}
-	}
+	return ExtractAllTextByXPath(StringRef(xml_str), xpath, ns_config);
+}
 
-	// Inject namespace declarations into the document if we have any
-	if (!namespaces_to_inject.empty()) {
-		effective_xml = InjectNamespaceDeclarations(xml_str, namespaces_to_inject);
-	}
+std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const string_t &xml_str, const std::string &xpath,
+                                                         const NamespaceConfig &ns_config) {
+	std::vector<std::string> results;
 
-	XMLDocRAII xml_doc(effective_xml);
+	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return results;
 	}
 
-	// Register custom namespaces if provided (for declared namespaces in the document)
-	xml_doc.RegisterCustomNamespaces(ns_config.custom_namespaces);
-
-	// Evaluate XPath
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	auto ns_xpath = PrepareNamespaceXPath(xml_doc, xpath, ns_config);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(ns_xpath, xml_doc.xpath_ctx, nullptr);
 
 	if (xpath_obj) {
 		if (xpath_obj->nodesetval) {
@@ -779,9 +1116,13 @@ std::vector<std::string> XMLUtils::ExtractAllTextByXPath(const std::string &xml_
 }
 
 std::string XMLUtils::PrettyPrintXML(const std::string &xml_str) {
+	return PrettyPrintXML(StringRef(xml_str));
+}
+
+std::string XMLUtils::PrettyPrintXML(const string_t &xml_str) {
 	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid()) {
-		return xml_str; // Return original if parsing fails
+		return xml_str.GetString(); // Return original if parsing fails
 	}
 
 	xmlChar *formatted_str = nullptr;
@@ -789,13 +1130,17 @@ std::string XMLUtils::PrettyPrintXML(const std::string &xml_str) {
 	xmlDocDumpFormatMemory(xml_doc.doc, &formatted_str, &size, 1); // format=1 for pretty printing
 
 	XMLCharPtr formatted_ptr(formatted_str); // DuckDB-style smart pointer
-	return formatted_ptr ? std::string(reinterpret_cast<const char *>(formatted_ptr.get())) : xml_str;
+	return formatted_ptr ? std::string(reinterpret_cast<const char *>(formatted_ptr.get())) : xml_str.GetString();
 }
 
 std::string XMLUtils::MinifyXML(const std::string &xml_str) {
+	return MinifyXML(StringRef(xml_str));
+}
+
+std::string XMLUtils::MinifyXML(const string_t &xml_str) {
 	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid()) {
-		return xml_str; // Return original if parsing fails
+		return xml_str.GetString(); // Return original if parsing fails
 	}
 
 	xmlChar *minified_str = nullptr;
@@ -803,50 +1148,24 @@ std::string XMLUtils::MinifyXML(const std::string &xml_str) {
 	xmlDocDumpMemory(xml_doc.doc, &minified_str, &size); // No formatting
 
 	XMLCharPtr minified_ptr(minified_str); // DuckDB-style smart pointer
-	return minified_ptr ? std::string(reinterpret_cast<const char *>(minified_ptr.get())) : xml_str;
+	return minified_ptr ? std::string(reinterpret_cast<const char *>(minified_ptr.get())) : xml_str.GetString();
 }
 
 bool XMLUtils::ValidateXMLSchema(const std::string &xml_str, const std::string &xsd_schema) {
-	// Fail-closed entity loader must be installed before parsing the caller-supplied XSD:
-	// an <xs:import>/<xs:include schemaLocation="file://..."> (or external DTD) would otherwise
-	// make libxml2 open arbitrary local files (GHSA-vf8w-rr6w-h445). The schema parser takes no
-	// XML_PARSE_* options, so the external entity loader is the only interception point.
-	EnsureSecureParsing();
-	// Parse the XSD schema using DuckDB-style smart pointers
-	XMLSchemaParserPtr parser_ctx(xmlSchemaNewMemParserCtxt(xsd_schema.c_str(), xsd_schema.length()));
-	if (!parser_ctx) {
-		return false;
-	}
-
-	// Set silent error handler for schema parsing
-	xmlSchemaSetParserErrors(parser_ctx.get(), XMLSilentSchemaErrorHandler, XMLSilentSchemaErrorHandler, nullptr);
-
-	XMLSchemaPtr schema(xmlSchemaParse(parser_ctx.get()));
-	if (!schema) {
-		return false;
-	}
-
-	// Create validation context
-	XMLSchemaValidPtr valid_ctx(xmlSchemaNewValidCtxt(schema.get()));
-	if (!valid_ctx) {
-		return false;
-	}
-
-	// Set silent error handler for validation
-	xmlSchemaSetValidErrors(valid_ctx.get(), XMLSilentSchemaErrorHandler, XMLSilentSchemaErrorHandler, nullptr);
-
-	// Parse and validate the XML document
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid()) {
-		return false;
-	}
-
-	int validation_result = xmlSchemaValidateDoc(valid_ctx.get(), xml_doc.doc);
+	return ValidateXMLSchema(StringRef(xml_str), xsd_schema);
+}
 
-	return (validation_result == 0);
+bool XMLUtils::ValidateXMLSchema(const string_t &xml_str, const std::string &xsd_schema) {
+	XMLSchemaValidator validator(XMLSchemaValidator::Compile(xsd_schema.data(), xsd_schema.size()));
+	return validator.Validate(xml_str);
 }
 
 std::vector<XMLComment> XMLUtils::ExtractComments(const std::string &xml_str) {
+	return ExtractComments(StringRef(xml_str));
+}
+
+// DOM versions of the document analyzers, for documents with a DOCTYPE (see XMLSAXAnalysis)
+static std::vector<XMLComment> ExtractCommentsFromDOM(const string_t &xml_str) {
 	std::vector<XMLComment> comments;
 	XMLDocRAII xml_doc(xml_str);
 
@@ -881,7 +1200,23 @@ std::vector<XMLComment> XMLUtils::ExtractComments(const std::string &xml_str) {
 	return comments;
 }
 
+std::vector<XMLComment> XMLUtils::ExtractComments(const string_t &xml_str) {
+	XMLCommentAnalyzer analyzer;
+	switch (XMLSAXAnalysis::Run(xml_str, {&analyzer})) {
+	case XMLSAXAnalysisResult::COMPLETE:
+		return std::move(analyzer.comments);
+	case XMLSAXAnalysisResult::UNSUPPORTED:
+		return ExtractCommentsFromDOM(xml_str);
+	default:
+		return std::vector<XMLComment>();
+	}
+}
+
 std::vector<XMLComment> XMLUtils::ExtractCData(const std::string &xml_str) {
+	return ExtractCData(StringRef(xml_str));
+}
+
+static std::vector<XMLComment> ExtractCDataFromDOM(const string_t &xml_str) {
 	std::vector<XMLComment> cdata_sections;
 	XMLDocRAII xml_doc(xml_str);
 
@@ -916,7 +1251,23 @@ std::vector<XMLComment> XMLUtils::ExtractCData(const std::string &xml_str) {
 	return cdata_sections;
 }
 
+std::vector<XMLComment> XMLUtils::ExtractCData(const string_t &xml_str) {
+	XMLCDataAnalyzer analyzer;
+	switch (XMLSAXAnalysis::Run(xml_str, {&analyzer})) {
+	case XMLSAXAnalysisResult::COMPLETE:
+		return std::move(analyzer.sections);
+	case XMLSAXAnalysisResult::UNSUPPORTED:
+		return ExtractCDataFromDOM(xml_str);
+	default:
+		return std::vector<XMLComment>();
+	}
+}
+
 std::vector<XMLNamespace> XMLUtils::ExtractNamespaces(const std::string &xml_str) {
+	return ExtractNamespaces(StringRef(xml_str));
+}
+
+static std::vector<XMLNamespace> ExtractNamespacesFromDOM(const string_t &xml_str) {
 	std::vector<XMLNamespace> namespaces;
 	XMLDocRAII xml_doc(xml_str);
 
@@ -928,6 +1279,15 @@ std::vector<XMLNamespace> XMLUtils::ExtractNamespaces(const std::string &xml_str
 
 	std::function<void(xmlNodePtr)> traverse_namespaces = [&](xmlNodePtr node) {
 		for (xmlNodePtr cur = node; cur; cur = cur->next) {
+			// Only elements carry namespaces; an entity reference's child is the entity declaration,
+			// which has no ns field at all
+			if (cur->type != XML_ELEMENT_NODE) {
+				if (cur->children) {
+					traverse_namespaces(cur->children);
+				}
+				continue;
+			}
+
 			// Check node's namespace
 			if (cur->ns && cur->ns->href) {
 				std::string prefix = cur->ns->prefix ? std::string((const char *)cur->ns->prefix) : "";
@@ -969,7 +1329,23 @@ std::vector<XMLNamespace> XMLUtils::ExtractNamespaces(const std::string &xml_str
 	return namespaces;
 }
 
+std::vector<XMLNamespace> XMLUtils::ExtractNamespaces(const string_t &xml_str) {
+	XMLNamespaceAnalyzer analyzer;
+	switch (XMLSAXAnalysis::Run(xml_str, {&analyzer})) {
+	case XMLSAXAnalysisResult::COMPLETE:
+		return std::move(analyzer.namespaces);
+	case XMLSAXAnalysisResult::UNSUPPORTED:
+		return ExtractNamespacesFromDOM(xml_str);
+	default:
+		return std::vector<XMLNamespace>();
+	}
+}
+
 XMLStats XMLUtils::GetXMLStats(const std::string &xml_str) {
+	return GetXMLStats(StringRef(xml_str));
+}
+
+static XMLStats GetXMLStatsFromDOM(const string_t &xml_str) {
 	XMLStats stats = {0, 0, 0, 0, 0};
 	XMLDocRAII xml_doc(xml_str);
 
@@ -977,7 +1353,7 @@ XMLStats XMLUtils::GetXMLStats(const std::string &xml_str) {
 		return stats;
 	}
 
-	stats.size_bytes = xml_str.length();
+	stats.size_bytes = xml_str.GetSize();
 	std::set<std::string> unique_namespaces;
 
 	std::function<void(xmlNodePtr, int)> traverse_stats = [&](xmlNodePtr node, int depth) {
@@ -1011,1230 +1387,636 @@ XMLStats XMLUtils::GetXMLStats(const std::string &xml_str) {
 	return stats;
 }
 
-std::string XMLUtils::XMLToJSON(const std::string &xml_str) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid()) {
-		return "{}";
+XMLStats XMLUtils::GetXMLStats(const string_t &xml_str) {
+	XMLStatsAnalyzer analyzer;
+	switch (XMLSAXAnalysis::Run(xml_str, {&analyzer})) {
+	case XMLSAXAnalysisResult::COMPLETE:
+		return analyzer.GetStats(xml_str.GetSize());
+	case XMLSAXAnalysisResult::UNSUPPORTED:
+		return GetXMLStatsFromDOM(xml_str);
+	default:
+		return XMLStats {0, 0, 0, 0, 0};
 	}
+}
 
-	std::function<std::string(xmlNodePtr, bool)> node_to_json = [&](xmlNodePtr node, bool is_root) -> std::string {
-		if (!node || node->type != XML_ELEMENT_NODE) {
-			return "null";
-		}
-
-		std::string node_name = std::string((const char *)node->name);
-		std::string result = "{";
-
-		// Add attributes if any
-		bool has_content = false;
-		for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
-			if (has_content)
-				result += ",";
-			std::string attr_name = std::string((const char *)attr->name);
-
-			XMLCharPtr attr_value(xmlNodeListGetString(xml_doc.doc, attr->children, 1)); // DuckDB-style smart pointer
-			std::string attr_val = attr_value ? std::string(reinterpret_cast<const char *>(attr_value.get())) : "";
-
-			result += "\"@" + EscapeJSONString(attr_name) + "\":\"" + EscapeJSONString(attr_val) + "\"";
-			has_content = true;
-		}
+std::string XMLUtils::XMLToJSON(const std::string &xml_str) {
+	return XMLToJSON(StringRef(xml_str));
+}
 
-		// Get direct text content only (not including children text)
-		// Include both XML_TEXT_NODE and XML_CDATA_SECTION_NODE (GitHub Issue #63)
-		std::string direct_text;
-		for (xmlNodePtr child = node->children; child; child = child->next) {
-			if ((child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE) && child->content) {
-				direct_text += std::string((const char *)child->content);
-			}
-		}
+std::string XMLUtils::XMLToJSON(const string_t &xml_str) {
+	return XMLToJSON(xml_str, XMLToJSONOptions());
+}
 
-		// Clean up whitespace
-		direct_text.erase(0, direct_text.find_first_not_of(" \t\n\r"));
-		direct_text.erase(direct_text.find_last_not_of(" \t\n\r") + 1);
+std::string XMLUtils::XMLToJSON(const std::string &xml_str, const XMLToJSONOptions &options) {
+	return XMLToJSON(StringRef(xml_str), options);
+}
 
-		if (!direct_text.empty()) {
-			if (has_content)
-				result += ",";
-			result += "\"#text\":\"" + EscapeJSONString(direct_text) + "\"";
-			has_content = true;
-		}
+std::string XMLUtils::XMLToJSON(const string_t &xml_str, const XMLToJSONOptions &options) {
+	XMLToJSONWriter writer(options);
+	return XMLToJSON(xml_str, writer);
+}
 
-		// Add children elements
-		std::map<std::string, std::vector<std::string>> children_by_name;
-		for (xmlNodePtr child = node->children; child; child = child->next) {
-			if (child->type == XML_ELEMENT_NODE) {
-				std::string child_name = std::string((const char *)child->name);
-				std::string child_json = node_to_json(child, false);
-				children_by_name[child_name].push_back(child_json);
-			}
-		}
+const std::string &XMLUtils::XMLToJSON(const string_t &xml_str, XMLToJSONWriter &writer) {
+	writer.Reset();
+	switch (XMLSAXAnalysis::Run(xml_str, {&writer})) {
+	case XMLSAXAnalysisResult::COMPLETE:
+		break;
+	case XMLSAXAnalysisResult::UNSUPPORTED: {
+		XMLDocRAII xml_doc(xml_str);
+		writer.WriteDocument(xml_doc.IsValid() ? xml_doc.doc : nullptr);
+		break;
+	}
+	default:
+		writer.Reset();
+		break;
+	}
+	return writer.Finish();
+}
 
-		for (const auto &child_group : children_by_name) {
-			if (has_content)
-				result += ",";
+namespace {
 
-			if (child_group.second.size() == 1) {
-				result += "\"" + EscapeJSONString(child_group.first) + "\":" + child_group.second[0];
-			} else {
-				result += "\"" + EscapeJSONString(child_group.first) + "\":[";
-				for (size_t i = 0; i < child_group.second.size(); i++) {
-					if (i > 0)
-						result += ",";
-					result += child_group.second[i];
+using namespace duckdb_yyjson; // NOLINT
+
+struct JSONDocDeleter {
+	void operator()(yyjson_doc *doc) {
+		yyjson_doc_free(doc);
+	}
+};
+
+// Writes a parsed JSON value as XML straight into `out`, following the mapping json_to_xml has
+// always used: object members become child elements in key order ('@' keys attributes, "#text" the
+// text after the children), an array named `name` becomes <name_list> holding one <name> per
+// element, and null is an empty element. No tree is built; objects only gather their members to
+// order them. Returns false, with the reason in `error`, when a key is not a usable XML name.
+class JSONToXMLWriter {
+public:
+	JSONToXMLWriter(std::string &out, std::string &error) : out(out), error(error) {
+	}
+
+	bool WriteElement(const char *name, idx_t name_size, yyjson_val *val, idx_t depth) {
+		if (depth > MAX_DEPTH) {
+			error = StringUtil::Format("JSON is nested deeper than %llu levels", MAX_DEPTH);
+			return false;
+		}
+		if (!CheckName(name, name_size)) {
+			return false;
+		}
+		switch (yyjson_get_type(val)) {
+		case YYJSON_TYPE_OBJ:
+			return WriteObject(name, name_size, val, depth);
+		case YYJSON_TYPE_ARR: {
+			OpenTag(name, name_size);
+			out += "_list";
+			if (yyjson_arr_size(val) == 0) {
+				out += "/>";
+				return true;
+			}
+			out += '>';
+			size_t idx, max;
+			yyjson_val *element;
+			yyjson_arr_foreach(val, idx, max, element) {
+				if (!WriteElement(name, name_size, element, depth + 1)) {
+					return false;
 				}
-				result += "]";
 			}
-			has_content = true;
+			CloseTag(name, name_size);
+			out += "_list>";
+			return true;
 		}
+		case YYJSON_TYPE_NULL:
+		case YYJSON_TYPE_NONE:
+			OpenTag(name, name_size);
+			out += "/>";
+			return true;
+		default:
+			OpenTag(name, name_size);
+			out += '>';
+			AppendText(val, false);
+			CloseTag(name, name_size);
+			out += '>';
+			return true;
+		}
+	}
 
-		result += "}";
+private:
+	struct Member {
+		const char *key;
+		idx_t key_size;
+		yyjson_val *val;
 
-		// For the root element, wrap it with the element name
-		if (is_root) {
-			return "{\"" + EscapeJSONString(node_name) + "\":" + result + "}";
+		bool IsAttribute() const {
+			return key_size > 0 && key[0] == '@';
+		}
+		bool IsText() const {
+			return key_size == 5 && memcmp(key, "#text", 5) == 0;
 		}
-
-		return result;
 	};
 
-	xmlNodePtr root = xmlDocGetRootElement(xml_doc.doc);
-	if (root) {
-		return node_to_json(root, true);
+	static bool KeyLess(const Member &a, const Member &b) {
+		auto cmp = memcmp(a.key, b.key, MinValue(a.key_size, b.key_size));
+		return cmp < 0 || (cmp == 0 && a.key_size < b.key_size);
 	}
 
-	return "{}";
-}
-
-std::string XMLUtils::XMLToJSON(const std::string &xml_str, const XMLToJSONOptions &options) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid()) {
-		return "{}";
+	static bool KeyEquals(const Member &a, const Member &b) {
+		return a.key_size == b.key_size && memcmp(a.key, b.key, a.key_size) == 0;
 	}
 
-	// Create a set for fast lookup of force_list elements
-	std::unordered_set<std::string> force_list_set(options.force_list.begin(), options.force_list.end());
-
-	std::function<std::string(xmlNodePtr, bool)> node_to_json = [&](xmlNodePtr node, bool is_root) -> std::string {
-		if (!node || node->type != XML_ELEMENT_NODE) {
-			return "null";
-		}
-
-		// Get node name based on namespace handling mode
-		std::string node_name;
-		std::string local_name = std::string((const char *)node->name);
-
-		if (options.namespaces == "strip") {
-			// Strip namespaces: use local name only
-			node_name = local_name;
-		} else if (options.namespaces == "expand" && node->ns && node->ns->href) {
-			// Expand: use full URI as prefix
-			node_name = std::string((const char *)node->ns->href) + ":" + local_name;
-		} else if (options.namespaces == "keep" && node->ns && node->ns->prefix) {
-			// Keep: preserve namespace prefix
-			node_name = std::string((const char *)node->ns->prefix) + ":" + local_name;
-		} else {
-			// No namespace or keep mode without prefix
-			node_name = local_name;
-		}
-
-		std::string result = "{";
-
-		// Add attributes if any
-		bool has_content = false;
-		for (xmlAttrPtr attr = node->properties; attr; attr = attr->next) {
-			if (has_content)
-				result += ",";
-
-			std::string attr_local_name = std::string((const char *)attr->name);
-			std::string attr_name;
-
-			if (options.namespaces == "strip") {
-				// Strip namespaces from attributes
-				attr_name = attr_local_name;
-			} else if (options.namespaces == "expand" && attr->ns && attr->ns->href) {
-				// Expand: use full URI as prefix
-				attr_name = std::string((const char *)attr->ns->href) + ":" + attr_local_name;
-			} else if (options.namespaces == "keep" && attr->ns && attr->ns->prefix) {
-				// Keep: preserve namespace prefix
-				attr_name = std::string((const char *)attr->ns->prefix) + ":" + attr_local_name;
-			} else {
-				// No namespace or keep mode without prefix
-				attr_name = attr_local_name;
-			}
-
-			XMLCharPtr attr_value(xmlNodeListGetString(xml_doc.doc, attr->children, 1));
-			std::string attr_val = attr_value ? std::string(reinterpret_cast<const char *>(attr_value.get())) : "";
-
-			result +=
-			    "\"" + EscapeJSONString(options.attr_prefix + attr_name) + "\":\"" + EscapeJSONString(attr_val) + "\"";
-			has_content = true;
+	bool CheckName(const char *name, idx_t name_size) {
+		// xmlValidateName stops at a NUL, so an embedded one would pass as a truncated prefix
+		if (name_size > 0 && !memchr(name, '\0', name_size) &&
+		    xmlValidateName(reinterpret_cast<const xmlChar *>(name), 0) == 0) {
+			return true;
 		}
+		error = StringUtil::Format("key '%s' is not a valid XML name", std::string(name, name_size));
+		return false;
+	}
 
-		// Add namespace declarations if xmlns_key is set and this is the root
-		if (is_root && !options.xmlns_key.empty()) {
-			// Collect all namespace declarations
-			std::map<std::string, std::string> namespaces;
+	void OpenTag(const char *name, idx_t name_size) {
+		out += '<';
+		out.append(name, name_size);
+	}
 
-			// Get all namespace definitions on this node
-			for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next) {
-				std::string prefix = ns->prefix ? std::string((const char *)ns->prefix) : "";
-				std::string href = ns->href ? std::string((const char *)ns->href) : "";
-				if (!href.empty()) {
-					namespaces[prefix] = href;
-				}
-			}
+	void CloseTag(const char *name, idx_t name_size) {
+		out += "</";
+		out.append(name, name_size);
+	}
 
-			// Add xmlns metadata if any namespaces found
-			if (!namespaces.empty()) {
-				if (has_content)
-					result += ",";
-				result += "\"" + EscapeJSONString(options.xmlns_key) + "\":{";
-				bool first_ns = true;
-				for (const auto &ns_pair : namespaces) {
-					if (!first_ns)
-						result += ",";
-					result +=
-					    "\"" + EscapeJSONString(ns_pair.first) + "\":\"" + EscapeJSONString(ns_pair.second) + "\"";
-					first_ns = false;
-				}
-				result += "}";
-				has_content = true;
+	// A scalar's text: strings unescaped by the parser, numbers as written, and objects or arrays
+	// (only reachable as attribute values or "#text") as their JSON
+	void AppendText(yyjson_val *val, bool attribute) {
+		switch (yyjson_get_type(val)) {
+		case YYJSON_TYPE_STR:
+			XMLUtils::AppendXMLEscaped(out, yyjson_get_str(val), yyjson_get_len(val), attribute);
+			break;
+		case YYJSON_TYPE_RAW:
+			out.append(yyjson_get_raw(val), yyjson_get_len(val));
+			break;
+		case YYJSON_TYPE_BOOL:
+			out += yyjson_get_bool(val) ? "true" : "false";
+			break;
+		case YYJSON_TYPE_ARR:
+		case YYJSON_TYPE_OBJ: {
+			size_t json_size = 0;
+			char *json = yyjson_val_write(val, YYJSON_WRITE_NOFLAG, &json_size);
+			if (json) {
+				XMLUtils::AppendXMLEscaped(out, json, json_size, attribute);
+				free(json);
 			}
+			break;
 		}
-
-		// Get direct text content only (not including children text)
-		// Include both XML_TEXT_NODE and XML_CDATA_SECTION_NODE (GitHub Issue #63)
-		std::string direct_text;
-		for (xmlNodePtr child = node->children; child; child = child->next) {
-			if ((child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE) && child->content) {
-				direct_text += std::string((const char *)child->content);
-			}
+		default:
+			break;
 		}
+	}
 
-		// Clean up whitespace
-		direct_text.erase(0, direct_text.find_first_not_of(" \t\n\r"));
-		direct_text.erase(direct_text.find_last_not_of(" \t\n\r") + 1);
+	static bool HasText(yyjson_val *val) {
+		return val && !yyjson_is_null(val) && !(yyjson_is_str(val) && yyjson_get_len(val) == 0);
+	}
 
-		if (!direct_text.empty()) {
-			if (has_content)
-				result += ",";
-			result += "\"" + EscapeJSONString(options.text_key) + "\":\"" + EscapeJSONString(direct_text) + "\"";
-			has_content = true;
+	bool WriteObject(const char *name, idx_t name_size, yyjson_val *obj, idx_t depth) {
+		// Gather the members on top of the shared stack, in key order with a repeated key keeping
+		// its last value
+		idx_t begin = members.size();
+		size_t idx, max;
+		yyjson_val *key, *val;
+		yyjson_obj_foreach(obj, idx, max, key, val) {
+			members.push_back(Member {yyjson_get_str(key), yyjson_get_len(key), val});
 		}
-
-		// Add children elements
-		std::map<std::string, std::vector<std::string>> children_by_name;
-		for (xmlNodePtr child = node->children; child; child = child->next) {
-			if (child->type == XML_ELEMENT_NODE) {
-				// Get child name using same namespace logic as parent
-				std::string child_local_name = std::string((const char *)child->name);
-				std::string child_name;
-
-				if (options.namespaces == "strip") {
-					child_name = child_local_name;
-				} else if (options.namespaces == "expand" && child->ns && child->ns->href) {
-					child_name = std::string((const char *)child->ns->href) + ":" + child_local_name;
-				} else if (options.namespaces == "keep" && child->ns && child->ns->prefix) {
-					child_name = std::string((const char *)child->ns->prefix) + ":" + child_local_name;
-				} else {
-					child_name = child_local_name;
-				}
-
-				std::string child_json = node_to_json(child, false);
-				children_by_name[child_name].push_back(child_json);
+		std::stable_sort(members.begin() + begin, members.end(), KeyLess);
+		idx_t end = begin;
+		for (idx_t i = begin; i < members.size(); i++) {
+			if (i + 1 < members.size() && KeyEquals(members[i], members[i + 1])) {
+				continue;
 			}
+			members[end++] = members[i];
 		}
+		members.resize(end);
 
-		for (const auto &child_group : children_by_name) {
-			if (has_content)
-				result += ",";
-
-			// Check if this element should be forced to a list OR has multiple instances
-			bool should_be_array = force_list_set.count(child_group.first) > 0 || child_group.second.size() > 1;
+		bool success = WriteMembers(name, name_size, begin, end, depth);
+		members.resize(begin);
+		return success;
+	}
 
-			if (should_be_array) {
-				result += "\"" + EscapeJSONString(child_group.first) + "\":[";
-				for (size_t i = 0; i < child_group.second.size(); i++) {
-					if (i > 0)
-						result += ",";
-					result += child_group.second[i];
+	bool WriteMembers(const char *name, idx_t name_size, idx_t begin, idx_t end, idx_t depth) {
+		OpenTag(name, name_size);
+		yyjson_val *text = nullptr;
+		bool has_children = false;
+		for (idx_t i = begin; i < end; i++) {
+			auto &member = members[i];
+			if (member.IsAttribute()) {
+				// XML has no null attribute; leave it out
+				if (yyjson_is_null(member.val)) {
+					continue;
 				}
-				result += "]";
+				if (!CheckName(member.key + 1, member.key_size - 1)) {
+					return false;
+				}
+				out += ' ';
+				out.append(member.key + 1, member.key_size - 1);
+				out += "=\"";
+				AppendText(member.val, true);
+				out += '"';
+			} else if (member.IsText()) {
+				text = member.val;
 			} else {
-				result += "\"" + EscapeJSONString(child_group.first) + "\":" + child_group.second[0];
+				has_children = true;
 			}
-			has_content = true;
 		}
-
-		// Handle empty elements if no content was added
-		if (!has_content) {
-			if (options.empty_elements == "null") {
-				return "null";
-			} else if (options.empty_elements == "string") {
-				return "\"\"";
+		if (!has_children && !HasText(text)) {
+			out += "/>";
+			return true;
+		}
+		out += '>';
+		for (idx_t i = begin; i < end; i++) {
+			// A copy: writing the child gathers its own members on the stack, which may reallocate it
+			auto member = members[i];
+			if (member.IsAttribute() || member.IsText()) {
+				continue;
 			}
-			// Default "object" case - return empty object
+			if (!WriteElement(member.key, member.key_size, member.val, depth + 1)) {
+				return false;
+			}
+		}
+		if (HasText(text)) {
+			AppendText(text, false);
 		}
+		CloseTag(name, name_size);
+		out += '>';
+		return true;
+	}
 
-		result += "}";
+	// The writer recurses once per level; libxml2 itself refuses documents nested deeper than 256
+	static constexpr idx_t MAX_DEPTH = 1000;
 
-		// For the root element, wrap it with the element name
-		if (is_root) {
-			return "{\"" + EscapeJSONString(node_name) + "\":" + result + "}";
-		}
+	std::string &out;
+	std::string &error;
+	// The members of every object being written, innermost last
+	vector<Member> members;
+};
 
-		return result;
-	};
+} // namespace
 
-	xmlNodePtr root = xmlDocGetRootElement(xml_doc.doc);
-	if (root) {
-		return node_to_json(root, true);
+void XMLUtils::AppendXMLEscaped(std::string &out, const char *data, idx_t size, bool attribute) {
+	// Copy the runs between special characters in one go. The escapes match libxml2's serializer:
+	// attribute values also escape '"' and the whitespace that attribute normalization would fold.
+	idx_t run_start = 0;
+	for (idx_t i = 0; i < size; i++) {
+		const char *entity;
+		switch (data[i]) {
+		case '&':
+			entity = "&amp;";
+			break;
+		case '<':
+			entity = "&lt;";
+			break;
+		case '>':
+			entity = "&gt;";
+			break;
+		case '\r':
+			entity = "&#13;";
+			break;
+		case '"':
+			entity = attribute ? "&quot;" : nullptr;
+			break;
+		case '\n':
+			entity = attribute ? "&#10;" : nullptr;
+			break;
+		case '\t':
+			entity = attribute ? "&#9;" : nullptr;
+			break;
+		case '\0':
+			// Not allowed anywhere in XML
+			entity = "";
+			break;
+		default:
+			entity = nullptr;
+			break;
+		}
+		if (!entity) {
+			continue;
+		}
+		out.append(data + run_start, i - run_start);
+		out += entity;
+		run_start = i + 1;
 	}
-
-	return "{}";
+	out.append(data + run_start, size - run_start);
 }
 
-std::string XMLUtils::JSONToXML(const std::string &json_str) {
-	if (json_str.empty() || json_str == "{}") {
-		return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root></root>";
+bool XMLUtils::TryJSONToXML(const string_t &json_str, std::string &out, std::string &error) {
+	out.assign("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	if (json_str.GetSize() == 0) {
+		out += "<root></root>";
+		return true;
 	}
 
-	// Create a new XML document
-	XMLDocPtr doc(xmlNewDoc(BAD_CAST "1.0"));
+	// Numbers are read as raw text so they come out exactly as written
+	yyjson_read_err read_error;
+	std::unique_ptr<yyjson_doc, JSONDocDeleter> doc(yyjson_read_opts(const_cast<char *>(json_str.GetData()),
+	                                                                 json_str.GetSize(), YYJSON_READ_NUMBER_AS_RAW,
+	                                                                 nullptr, &read_error));
 	if (!doc) {
-		return "<?xml version=\"1.0\"?>\n<root></root>\n";
+		error = StringUtil::Format("malformed JSON at byte %llu: %s", static_cast<uint64_t>(read_error.pos),
+		                           read_error.msg);
+		return false;
 	}
 
-	// Simple JSON parser implementation
-	// This handles basic JSON structures: objects, arrays, strings, numbers, booleans, null
-	std::function<xmlNodePtr(const std::string &, const std::string &, xmlDocPtr)> json_to_node =
-	    [&](const std::string &json_value, const std::string &node_name, xmlDocPtr document) -> xmlNodePtr {
-		std::string trimmed = json_value;
-		// Trim whitespace
-		trimmed.erase(0, trimmed.find_first_not_of(" \t\n\r"));
-		trimmed.erase(trimmed.find_last_not_of(" \t\n\r") + 1);
-
-		xmlNodePtr node = xmlNewNode(nullptr, BAD_CAST node_name.c_str());
-		if (!node)
-			return nullptr;
-
-		if (trimmed.empty() || trimmed == "null") {
-			// Empty node for null values
-			return node;
-		}
-
-		if (trimmed[0] == '"' && trimmed[trimmed.length() - 1] == '"') {
-			// String value - remove quotes and set as text content
-			std::string str_content = trimmed.substr(1, trimmed.length() - 2);
-			xmlNodePtr text_node = xmlNewText(BAD_CAST str_content.c_str());
-			if (text_node) {
-				xmlAddChild(node, text_node);
-			}
-			return node;
-		}
-
-		if (trimmed[0] == '[' && trimmed[trimmed.length() - 1] == ']') {
-			// Array - each element becomes a child with same name
-			std::string array_content = trimmed.substr(1, trimmed.length() - 2);
-
-			// Simple array parsing
-			std::vector<std::string> elements;
-			int brace_depth = 0;
-			int bracket_depth = 0;
-			bool in_string = false;
-			size_t element_start = 0;
-
-			for (size_t i = 0; i < array_content.length(); i++) {
-				char c = array_content[i];
-
-				if (!in_string) {
-					if (c == '"')
-						in_string = true;
-					else if (c == '{')
-						brace_depth++;
-					else if (c == '}')
-						brace_depth--;
-					else if (c == '[')
-						bracket_depth++;
-					else if (c == ']')
-						bracket_depth--;
-					else if (c == ',' && brace_depth == 0 && bracket_depth == 0) {
-						elements.push_back(array_content.substr(element_start, i - element_start));
-						element_start = i + 1;
-					}
-				} else {
-					if (c == '"' && (i == 0 || array_content[i - 1] != '\\')) {
-						in_string = false;
-					}
-				}
-			}
-
-			// Add the last element
-			if (element_start < array_content.length()) {
-				elements.push_back(array_content.substr(element_start));
-			}
-
-			// Convert each array element to a child node
-			for (const auto &element : elements) {
-				xmlNodePtr child = json_to_node(element, node_name, document);
-				if (child) {
-					xmlAddChild(node, child);
-				}
-			}
-
-			// Change parent node name to indicate it's a list
-			xmlNodeSetName(node, BAD_CAST(node_name + "_list").c_str());
-			return node;
-		}
-
-		if (trimmed[0] == '{' && trimmed[trimmed.length() - 1] == '}') {
-			// Object - each property becomes a child element
-			std::string object_content = trimmed.substr(1, trimmed.length() - 2);
-
-			// Simple object parsing
-			std::map<std::string, std::string> properties;
-			int brace_depth = 0;
-			int bracket_depth = 0;
-			bool in_string = false;
-			size_t prop_start = 0;
-
-			for (size_t i = 0; i < object_content.length(); i++) {
-				char c = object_content[i];
-
-				if (!in_string) {
-					if (c == '"')
-						in_string = true;
-					else if (c == '{')
-						brace_depth++;
-					else if (c == '}')
-						brace_depth--;
-					else if (c == '[')
-						bracket_depth++;
-					else if (c == ']')
-						bracket_depth--;
-					else if (c == ',' && brace_depth == 0 && bracket_depth == 0) {
-						std::string prop = object_content.substr(prop_start, i - prop_start);
-
-						// Parse key:value pair
-						size_t colon_pos = prop.find(':');
-						if (colon_pos != std::string::npos) {
-							std::string key = prop.substr(0, colon_pos);
-							std::string value = prop.substr(colon_pos + 1);
-
-							// Trim and remove quotes from key
-							key.erase(0, key.find_first_not_of(" \t\n\r"));
-							key.erase(key.find_last_not_of(" \t\n\r") + 1);
-							if (key.length() >= 2 && key[0] == '"' && key[key.length() - 1] == '"') {
-								key = key.substr(1, key.length() - 2);
-							}
-
-							// Trim value
-							value.erase(0, value.find_first_not_of(" \t\n\r"));
-							value.erase(value.find_last_not_of(" \t\n\r") + 1);
-
-							properties[key] = value;
-						}
-
-						prop_start = i + 1;
-					}
-				} else {
-					if (c == '"' && (i == 0 || object_content[i - 1] != '\\')) {
-						in_string = false;
-					}
-				}
-			}
-
-			// Add the last property
-			if (prop_start < object_content.length()) {
-				std::string prop = object_content.substr(prop_start);
-
-				size_t colon_pos = prop.find(':');
-				if (colon_pos != std::string::npos) {
-					std::string key = prop.substr(0, colon_pos);
-					std::string value = prop.substr(colon_pos + 1);
-
-					// Trim and remove quotes from key
-					key.erase(0, key.find_first_not_of(" \t\n\r"));
-					key.erase(key.find_last_not_of(" \t\n\r") + 1);
-					if (key.length() >= 2 && key[0] == '"' && key[key.length() - 1] == '"') {
-						key = key.substr(1, key.length() - 2);
-					}
-
-					// Trim value
-					value.erase(0, value.find_first_not_of(" \t\n\r"));
-					value.erase(value.find_last_not_of(" \t\n\r") + 1);
-
-					properties[key] = value;
-				}
-			}
-
-			// Handle properties - separate attributes from elements
-			std::string text_content;
-
-			for (const auto &prop : properties) {
-				if (prop.first.length() > 0 && prop.first[0] == '@') {
-					// This is an attribute (starts with @)
-					std::string attr_name = prop.first.substr(1); // Remove @ prefix
-					std::string attr_value = prop.second;
-
-					// Remove quotes from attribute value if present
-					if (attr_value.length() >= 2 && attr_value[0] == '"' &&
-					    attr_value[attr_value.length() - 1] == '"') {
-						attr_value = attr_value.substr(1, attr_value.length() - 2);
-					}
-
-					xmlSetProp(node, BAD_CAST attr_name.c_str(), BAD_CAST attr_value.c_str());
-				} else if (prop.first == "#text") {
-					// This is text content
-					text_content = prop.second;
-
-					// Remove quotes from text content if present
-					if (text_content.length() >= 2 && text_content[0] == '"' &&
-					    text_content[text_content.length() - 1] == '"') {
-						text_content = text_content.substr(1, text_content.length() - 2);
-					}
-				} else {
-					// This is a child element
-					xmlNodePtr child = json_to_node(prop.second, prop.first, document);
-					if (child) {
-						xmlAddChild(node, child);
-					}
-				}
-			}
-
-			// Add text content if present
-			if (!text_content.empty()) {
-				xmlNodePtr text_node = xmlNewText(BAD_CAST text_content.c_str());
-				if (text_node) {
-					xmlAddChild(node, text_node);
-				}
-			}
-
-			return node;
-		}
-
-		// Primitive value (number, boolean) - set as text content
-		xmlNodePtr text_node = xmlNewText(BAD_CAST trimmed.c_str());
-		if (text_node) {
-			xmlAddChild(node, text_node);
-		}
-
-		return node;
-	};
-
-	// Check if JSON is an object with a single key that could be the root element name
-	std::string trimmed = json_str;
-	trimmed.erase(0, trimmed.find_first_not_of(" \t\n\r"));
-	trimmed.erase(trimmed.find_last_not_of(" \t\n\r") + 1);
-
-	std::string root_element_name = "root";
-	std::string actual_json_content = json_str;
-
-	// Check if JSON has the pattern {"root_name": {...}} and extract it
-	if (trimmed.length() > 4 && trimmed[0] == '{' && trimmed[trimmed.length() - 1] == '}') {
-		// Simple parsing to find first key
-		size_t first_quote = trimmed.find('"', 1);
-		if (first_quote != std::string::npos) {
-			size_t second_quote = trimmed.find('"', first_quote + 1);
-			if (second_quote != std::string::npos) {
-				size_t colon = trimmed.find(':', second_quote);
-				if (colon != std::string::npos) {
-					std::string potential_root = trimmed.substr(first_quote + 1, second_quote - first_quote - 1);
-
-					// Check if the value is an object (indicating this should be the root element)
-					size_t value_start = colon + 1;
-					while (value_start < trimmed.length() &&
-					       (trimmed[value_start] == ' ' || trimmed[value_start] == '\t')) {
-						value_start++;
-					}
-
-					if (value_start < trimmed.length() && trimmed[value_start] == '{') {
-						// Find the matching closing brace
-						int brace_count = 1;
-						size_t value_end = value_start + 1;
-						bool in_string = false;
-
-						while (value_end < trimmed.length() && brace_count > 0) {
-							char c = trimmed[value_end];
-							if (!in_string) {
-								if (c == '"')
-									in_string = true;
-								else if (c == '{')
-									brace_count++;
-								else if (c == '}')
-									brace_count--;
-							} else {
-								if (c == '"' && (value_end == 0 || trimmed[value_end - 1] != '\\')) {
-									in_string = false;
-								}
-							}
-							value_end++;
-						}
-
-						// Check if this is the only key-value pair in the object
-						size_t remaining_start = value_end;
-						while (remaining_start < trimmed.length() &&
-						       (trimmed[remaining_start] == ' ' || trimmed[remaining_start] == '\t')) {
-							remaining_start++;
-						}
-
-						if (remaining_start < trimmed.length() && trimmed[remaining_start] == '}') {
-							// This is the only key, use it as root element and extract its value
-							root_element_name = potential_root;
-							actual_json_content = trimmed.substr(value_start, value_end - value_start);
-						}
-					}
-				}
-			}
+	auto root = yyjson_doc_get_root(doc.get());
+	if (yyjson_is_obj(root) && yyjson_obj_size(root) == 0) {
+		out += "<root></root>";
+		return true;
+	}
+	JSONToXMLWriter writer(out, error);
+	if (yyjson_is_obj(root) && yyjson_obj_size(root) == 1) {
+		// {"name": {...}} names the root element
+		yyjson_obj_iter iter;
+		yyjson_obj_iter_init(root, &iter);
+		auto key = yyjson_obj_iter_next(&iter);
+		auto val = yyjson_obj_iter_get_val(key);
+		if (yyjson_is_obj(val)) {
+			return writer.WriteElement(yyjson_get_str(key), yyjson_get_len(key), val, 0);
 		}
 	}
+	return writer.WriteElement("root", 4, root, 0);
+}
 
-	// Convert JSON to XML node
-	xmlNodePtr root_node = json_to_node(actual_json_content, root_element_name, doc.get());
-	if (root_node) {
-		xmlDocSetRootElement(doc.get(), root_node);
+std::string XMLUtils::JSONToXML(const std::string &json_str) {
+	std::string xml;
+	std::string error;
+	if (!TryJSONToXML(StringRef(json_str), xml, error)) {
+		throw InvalidInputException("Could not convert JSON to XML: %s", error);
 	}
+	return xml;
+}
 
-	// Convert to string with encoding="UTF-8"
-	xmlChar *xml_string = nullptr;
-	int size = 0;
-	xmlDocDumpFormatMemoryEnc(doc.get(), &xml_string, &size, "UTF-8", 0);
-
-	XMLCharPtr xml_ptr(xml_string);
-	std::string result = xml_ptr ? std::string(reinterpret_cast<const char *>(xml_ptr.get()))
-	                             : "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root></root>";
-
-	// Remove trailing newline to match expected test format
-	if (!result.empty() && result.back() == '\n') {
-		result.pop_back();
+XMLNodeSerializer::XMLNodeSerializer() : buffer(xmlBufferCreate()), output(nullptr) {
+	if (buffer) {
+		output = xmlOutputBufferCreateBuffer(buffer, nullptr);
 	}
-
-	return result;
 }
 
-std::string XMLUtils::ExtractXMLFragment(const std::string &xml_str, const std::string &xpath) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return "";
+XMLNodeSerializer::~XMLNodeSerializer() {
+	if (output) {
+		xmlOutputBufferClose(output);
 	}
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return "";
+	if (buffer) {
+		xmlBufferFree(buffer);
 	}
-
-	std::string fragment_xml;
-
-	// Return only the first matching node
-	if (xpath_obj->nodesetval->nodeNr > 0) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[0];
-		if (node) {
-			// Create a temporary document for dumping this node
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				// Copy the node to avoid ownership issues
-				xmlNodePtr copied_node = xmlCopyNode(node, 1); // 1 = recursive copy
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					// Dump the node as XML string
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						// Remove XML declaration from individual nodes
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							// Remove leading whitespace/newlines
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						// Remove trailing whitespace/newlines
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
-
-						fragment_xml = node_xml;
-					}
-				}
-			}
-		}
-	}
-
-	xmlXPathFreeObject(xpath_obj);
-	return fragment_xml;
 }
 
-std::string XMLUtils::ExtractXMLFragment(const std::string &xml_str, const std::string &xpath,
-                                         const case_insensitive_map_t<string> &namespaces) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return "";
+bool XMLNodeSerializer::Serialize(xmlNodePtr node, string_t &result) {
+	if (!node || !output) {
+		return false;
 	}
-
-	xml_doc.RegisterCustomNamespaces(namespaces);
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return "";
+	// Copy the node into a document of its own so namespaces in scope on its ancestors are declared
+	// on the copy, and so the copy can be freed without touching the source tree
+	XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
+	if (!temp_doc) {
+		return false;
 	}
+	xmlNodePtr copied_node = xmlCopyNode(node, 1); // 1 = recursive copy
+	if (!copied_node) {
+		return false;
+	}
+	xmlDocSetRootElement(temp_doc.get(), copied_node);
 
-	std::string fragment_xml;
-
-	if (xpath_obj->nodesetval->nodeNr > 0) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[0];
-		if (node) {
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				xmlNodePtr copied_node = xmlCopyNode(node, 1);
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
-
-						fragment_xml = node_xml;
-					}
-				}
-			}
-		}
+	// Dumping the node rather than the document leaves out the XML declaration. Passing "UTF-8"
+	// keeps non-ASCII literal; without an encoding libxml2 escapes every non-ASCII character to a
+	// numeric character reference (e.g. 'ö' -> '&#xF6;'), unlike the read_xml reader and
+	// xml_extract_text.
+	xmlBufferEmpty(buffer);
+	xmlNodeDumpOutput(output, temp_doc.get(), copied_node, 0, 0, "UTF-8");
+	if (xmlOutputBufferFlush(output) < 0) {
+		return false;
 	}
 
-	xmlXPathFreeObject(xpath_obj);
-	return fragment_xml;
+	auto is_trimmed = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+	auto data = reinterpret_cast<const char *>(xmlBufferContent(buffer));
+	idx_t begin = 0;
+	idx_t end = NumericCast<idx_t>(xmlBufferLength(buffer));
+	while (begin < end && is_trimmed(data[begin])) {
+		begin++;
+	}
+	while (end > begin && is_trimmed(data[end - 1])) {
+		end--;
+	}
+	result = string_t(data + begin, NumericCast<uint32_t>(end - begin));
+	return true;
 }
 
-std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
+// The serialized form of the first node in an XPath result, or "" when it has none
+static std::string SerializeFirstNode(xmlXPathObjectPtr xpath_obj) {
+	if (!xpath_obj || !xpath_obj->nodesetval || xpath_obj->nodesetval->nodeNr == 0) {
 		return "";
 	}
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
+	XMLNodeSerializer serializer;
+	string_t node_xml;
+	if (!serializer.Serialize(xpath_obj->nodesetval->nodeTab[0], node_xml)) {
 		return "";
 	}
+	return node_xml.GetString();
+}
 
-	std::string fragment_xml;
-
-	// Return ALL matching nodes, separated by newlines
+// The serialized form of every node in an XPath result, in document order
+static std::vector<std::string> SerializeNodeSet(xmlXPathObjectPtr xpath_obj) {
+	std::vector<std::string> results;
+	if (!xpath_obj || !xpath_obj->nodesetval) {
+		return results;
+	}
+	XMLNodeSerializer serializer;
+	string_t node_xml;
 	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			// Create a temporary document for dumping this node
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				// Copy the node to avoid ownership issues
-				xmlNodePtr copied_node = xmlCopyNode(node, 1); // 1 = recursive copy
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					// Dump the node as XML string
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						// Remove XML declaration from individual nodes
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							// Remove leading whitespace/newlines
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						// Remove trailing whitespace/newlines
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
-
-						if (!fragment_xml.empty()) {
-							fragment_xml += "\n";
-						}
-						fragment_xml += node_xml;
-					}
-				}
-			}
+		if (serializer.Serialize(xpath_obj->nodesetval->nodeTab[i], node_xml)) {
+			results.push_back(node_xml.GetString());
 		}
 	}
-
-	xmlXPathFreeObject(xpath_obj);
-
-	// Add trailing newline for consistent string splitting
-	if (!fragment_xml.empty()) {
-		fragment_xml += "\n";
-	}
-
-	return fragment_xml;
+	return results;
 }
 
-std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
-                                            const case_insensitive_map_t<string> &namespaces) {
-	XMLDocRAII xml_doc(xml_str);
-	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return "";
-	}
-
-	xml_doc.RegisterCustomNamespaces(namespaces);
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
+// Every node of an XPath result serialized and joined by newlines, with a trailing newline for
+// consistent string splitting
+static std::string SerializeNodeSetJoined(xmlXPathObjectPtr xpath_obj) {
+	std::string fragment_xml;
 	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return "";
+		return fragment_xml;
 	}
-
-	std::string fragment_xml;
-
+	XMLNodeSerializer serializer;
+	string_t node_xml;
 	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				xmlNodePtr copied_node = xmlCopyNode(node, 1);
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
-
-						if (!fragment_xml.empty()) {
-							fragment_xml += "\n";
-						}
-						fragment_xml += node_xml;
-					}
-				}
+		if (serializer.Serialize(xpath_obj->nodesetval->nodeTab[i], node_xml)) {
+			if (!fragment_xml.empty()) {
+				fragment_xml += "\n";
 			}
+			fragment_xml.append(node_xml.GetData(), node_xml.GetSize());
 		}
 	}
-
-	xmlXPathFreeObject(xpath_obj);
-
 	if (!fragment_xml.empty()) {
 		fragment_xml += "\n";
 	}
-
 	return fragment_xml;
 }
 
-std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
-                                            const NamespaceConfig &ns_config) {
-	// Determine the effective XML to parse
-	std::string effective_xml = xml_str;
-	case_insensitive_map_t<string> namespaces_to_inject;
-
-	// Handle AUTO mode: inject namespace declarations for undeclared prefixes
-	if (ns_config.mode == NamespaceMode::AUTO) {
-		auto doc_prefixes = DetectDocumentPrefixes(xml_str);
-		auto xpath_prefixes = DetectXPathPrefixes(xpath);
-
-		std::set<std::string> all_prefixes;
-		all_prefixes.insert(doc_prefixes.begin(), doc_prefixes.end());
-		all_prefixes.insert(xpath_prefixes.begin(), xpath_prefixes.end());
-
-		for (const auto &prefix : all_prefixes) {
-			std::string decl_pattern = "xmlns:" + prefix + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				std::string uri = GetCommonNamespaceURI(prefix);
-				if (uri.empty()) {
-					uri = "urn:mock:" + prefix;
-				}
-				namespaces_to_inject[prefix] = uri;
-			}
-		}
-	}
-
-	// When explicit custom namespaces are provided, also inject them for undeclared prefixes
-	if (ns_config.HasCustomNamespaces()) {
-		for (const auto &ns : ns_config.custom_namespaces) {
-			std::string decl_pattern = "xmlns:" + ns.first + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				namespaces_to_inject[ns.first] = ns.second;
-			}
-		}
-	}
-
-	if (!namespaces_to_inject.empty()) {
-		effective_xml = InjectNamespaceDeclarations(xml_str, namespaces_to_inject);
-	}
+std::string XMLUtils::ExtractXMLFragment(const std::string &xml_str, const std::string &xpath) {
+	return ExtractXMLFragment(StringRef(xml_str), xpath);
+}
 
-	XMLDocRAII xml_doc(effective_xml);
+std::string XMLUtils::ExtractXMLFragment(const string_t &xml_str, const std::string &xpath) {
+	XMLDocRAII uncached;
+	auto &xml_doc = XMLDocumentCache::Get(xml_str, false, uncached);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
 		return "";
 	}
 
-	xml_doc.RegisterCustomNamespaces(ns_config.custom_namespaces);
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return "";
-	}
-
-	std::string fragment_xml;
-
-	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				xmlNodePtr copied_node = xmlCopyNode(node, 1);
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
-
-						if (!fragment_xml.empty()) {
-							fragment_xml += "\n";
-						}
-						fragment_xml += node_xml;
-					}
-				}
-			}
-		}
-	}
-
-	xmlXPathFreeObject(xpath_obj);
-
-	if (!fragment_xml.empty()) {
-		fragment_xml += "\n";
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
+	auto fragment_xml = SerializeFirstNode(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
 	}
-
 	return fragment_xml;
 }
 
-std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath) {
-	std::vector<std::string> results;
-
+std::string XMLUtils::ExtractXMLFragment(const std::string &xml_str, const std::string &xpath,
+                                         const case_insensitive_map_t<string> &namespaces) {
 	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return results;
+		return "";
 	}
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return results;
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
+	auto fragment_xml = SerializeFirstNode(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
 	}
+	return fragment_xml;
+}
 
-	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			// Create a temporary document for dumping this node
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				// Copy the node to avoid ownership issues
-				xmlNodePtr copied_node = xmlCopyNode(node, 1); // 1 = recursive copy
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					// Dump the node as XML string
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						// Remove XML declaration from individual nodes
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							// Remove leading whitespace/newlines
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
+std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
+                                            xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractXMLFragmentAll(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
 
-						// Remove trailing whitespace/newlines
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
+std::string XMLUtils::ExtractXMLFragmentAll(const string_t &xml_str, const std::string &xpath,
+                                            xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractXMLFragmentAll(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
 
-						results.push_back(node_xml);
-					}
-				}
-			}
-		}
+std::string XMLUtils::ExtractXMLFragmentAll(XMLDocRAII &xml_doc, const std::string &xpath,
+                                            xmlXPathCompExprPtr compiled) {
+	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
+		return "";
 	}
 
-	xmlXPathFreeObject(xpath_obj);
-	return results;
+	// Return ALL matching nodes, separated by newlines
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, compiled);
+	auto fragment_xml = SerializeNodeSetJoined(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
+	}
+	return fragment_xml;
 }
 
-std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
-                                                          const case_insensitive_map_t<string> &namespaces) {
-	std::vector<std::string> results;
-
+std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
+                                            const case_insensitive_map_t<string> &namespaces) {
 	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return results;
+		return "";
 	}
 
 	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
-
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return results;
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
+	auto fragment_xml = SerializeNodeSetJoined(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
 	}
+	return fragment_xml;
+}
 
-	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				xmlNodePtr copied_node = xmlCopyNode(node, 1);
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
+std::string XMLUtils::ExtractXMLFragmentAll(const std::string &xml_str, const std::string &xpath,
+                                            const NamespaceConfig &ns_config) {
+	return ExtractXMLFragmentAll(StringRef(xml_str), xpath, ns_config);
+}
 
-						results.push_back(node_xml);
-					}
-				}
-			}
-		}
+std::string XMLUtils::ExtractXMLFragmentAll(const string_t &xml_str, const std::string &xpath,
+                                            const NamespaceConfig &ns_config) {
+	XMLDocRAII xml_doc(xml_str);
+	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
+		return "";
 	}
 
-	xmlXPathFreeObject(xpath_obj);
-	return results;
+	auto ns_xpath = PrepareNamespaceXPath(xml_doc, xpath, ns_config);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(ns_xpath, xml_doc.xpath_ctx, nullptr);
+	auto fragment_xml = SerializeNodeSetJoined(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
+	}
+	return fragment_xml;
 }
 
 std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
-                                                          const NamespaceConfig &ns_config) {
-	std::vector<std::string> results;
+                                                          xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractXMLFragmentList(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
 
-	// Determine the effective XML to parse
-	std::string effective_xml = xml_str;
-	case_insensitive_map_t<string> namespaces_to_inject;
-
-	// Handle AUTO mode: inject namespace declarations for undeclared prefixes
-	if (ns_config.mode == NamespaceMode::AUTO) {
-		auto doc_prefixes = DetectDocumentPrefixes(xml_str);
-		auto xpath_prefixes = DetectXPathPrefixes(xpath);
-
-		std::set<std::string> all_prefixes;
-		all_prefixes.insert(doc_prefixes.begin(), doc_prefixes.end());
-		all_prefixes.insert(xpath_prefixes.begin(), xpath_prefixes.end());
-
-		for (const auto &prefix : all_prefixes) {
-			std::string decl_pattern = "xmlns:" + prefix + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				std::string uri = GetCommonNamespaceURI(prefix);
-				if (uri.empty()) {
-					uri = "urn:mock:" + prefix;
-				}
-				namespaces_to_inject[prefix] = uri;
-			}
-		}
-	}
+std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const string_t &xml_str, const std::string &xpath,
+                                                          xmlXPathCompExprPtr compiled) {
+	XMLDocRAII uncached;
+	return ExtractXMLFragmentList(XMLDocumentCache::Get(xml_str, false, uncached), xpath, compiled);
+}
 
-	// When explicit custom namespaces are provided, also inject them for undeclared prefixes
-	if (ns_config.HasCustomNamespaces()) {
-		for (const auto &ns : ns_config.custom_namespaces) {
-			std::string decl_pattern = "xmlns:" + ns.first + "=";
-			if (xml_str.find(decl_pattern) == std::string::npos) {
-				namespaces_to_inject[ns.first] = ns.second;
-			}
-		}
+std::vector<std::string> XMLUtils::ExtractXMLFragmentList(XMLDocRAII &xml_doc, const std::string &xpath,
+                                                          xmlXPathCompExprPtr compiled) {
+	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
+		return std::vector<std::string>();
 	}
 
-	if (!namespaces_to_inject.empty()) {
-		effective_xml = InjectNamespaceDeclarations(xml_str, namespaces_to_inject);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, compiled);
+	auto results = SerializeNodeSet(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
 	}
+	return results;
+}
 
-	XMLDocRAII xml_doc(effective_xml);
+std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
+                                                          const case_insensitive_map_t<string> &namespaces) {
+	XMLDocRAII xml_doc(xml_str);
 	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
-		return results;
+		return std::vector<std::string>();
 	}
 
-	xml_doc.RegisterCustomNamespaces(ns_config.custom_namespaces);
-
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), xml_doc.xpath_ctx);
+	xml_doc.RegisterCustomNamespaces(namespaces);
 
-	if (!xpath_obj || !xpath_obj->nodesetval) {
-		if (xpath_obj)
-			xmlXPathFreeObject(xpath_obj);
-		return results;
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, xml_doc.xpath_ctx, nullptr);
+	auto results = SerializeNodeSet(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
 	}
+	return results;
+}
 
-	for (int i = 0; i < xpath_obj->nodesetval->nodeNr; i++) {
-		xmlNodePtr node = xpath_obj->nodesetval->nodeTab[i];
-		if (node) {
-			XMLDocPtr temp_doc(xmlNewDoc(BAD_CAST "1.0"));
-			if (temp_doc) {
-				xmlNodePtr copied_node = xmlCopyNode(node, 1);
-				if (copied_node) {
-					xmlDocSetRootElement(temp_doc.get(), copied_node);
-
-					xmlChar *node_str = nullptr;
-					int size = 0;
-					// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no
-					// output-encoding handler (temp_doc has encoding=NULL), so libxml2
-					// escapes every non-ASCII character to a numeric character reference
-					// (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" explicitly keeps non-ASCII
-					// literal, matching the read_xml reader and xml_extract_text. The
-					// JSON->XML path already does this (see xmlDocDumpFormatMemoryEnc above).
-					xmlDocDumpFormatMemoryEnc(temp_doc.get(), &node_str, &size, "UTF-8", 0);
-
-					if (node_str) {
-						XMLCharPtr node_ptr(node_str);
-						std::string node_xml = std::string(reinterpret_cast<const char *>(node_ptr.get()));
-
-						size_t xml_decl_end = node_xml.find("?>");
-						if (xml_decl_end != std::string::npos) {
-							node_xml = node_xml.substr(xml_decl_end + 2);
-							node_xml.erase(0, node_xml.find_first_not_of(" \t\n\r"));
-						}
-
-						size_t end = node_xml.find_last_not_of(" \t\n\r");
-						if (end != std::string::npos) {
-							node_xml = node_xml.substr(0, end + 1);
-						}
+std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const std::string &xml_str, const std::string &xpath,
+                                                          const NamespaceConfig &ns_config) {
+	return ExtractXMLFragmentList(StringRef(xml_str), xpath, ns_config);
+}
 
-						results.push_back(node_xml);
-					}
-				}
-			}
-		}
+std::vector<std::string> XMLUtils::ExtractXMLFragmentList(const string_t &xml_str, const std::string &xpath,
+                                                          const NamespaceConfig &ns_config) {
+	XMLDocRAII xml_doc(xml_str);
+	if (!xml_doc.IsValid() || !xml_doc.xpath_ctx) {
+		return std::vector<std::string>();
 	}
 
-	xmlXPathFreeObject(xpath_obj);
+	auto ns_xpath = PrepareNamespaceXPath(xml_doc, xpath, ns_config);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(ns_xpath, xml_doc.xpath_ctx, nullptr);
+	auto results = SerializeNodeSet(xpath_obj);
+	if (xpath_obj) {
+		xmlXPathFreeObject(xpath_obj);
+	}
 	return results;
 }
 
@@ -2249,343 +2031,323 @@ void XMLUtils::ValidateXMLElementName(const std::string &name) {
 	}
 }
 
-std::string XMLUtils::ScalarToXML(const std::string &value, const std::string &node_name) {
-	// Use RAII-safe libxml2 document creation
-	XMLDocPtr doc(xmlNewDoc(BAD_CAST "1.0"));
-	if (!doc) {
-		return "<" + node_name + "></" + node_name + ">";
-	}
+static const char XML_DECLARATION[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
 
-	// Create root node
-	xmlNodePtr root_node = xmlNewNode(nullptr, BAD_CAST node_name.c_str());
-	if (!root_node) {
-		return "<" + node_name + "></" + node_name + ">";
+// Only text whose first character other than whitespace or a byte order mark is '<' can be an XML
+// document, which settles most strings without parsing them
+static bool MayBeXMLDocument(const string_t &text) {
+	auto data = text.GetData();
+	idx_t size = text.GetSize();
+	idx_t pos = 0;
+	if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+		pos = 3;
 	}
-
-	xmlDocSetRootElement(doc.get(), root_node);
-
-	// Add text content (libxml2 handles XML escaping automatically)
-	xmlNodePtr text_node = xmlNewText(BAD_CAST value.c_str());
-	if (text_node) {
-		xmlAddChild(root_node, text_node);
+	while (pos < size && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\n' || data[pos] == '\r')) {
+		pos++;
 	}
+	return pos < size && data[pos] == '<';
+}
 
-	// Convert to string using RAII-safe memory management
-	xmlChar *xml_string = nullptr;
-	int size = 0;
-	// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no output-encoding
-	// handler (doc has encoding=NULL), so libxml2 escapes every non-ASCII character to a
-	// numeric character reference (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" keeps non-ASCII
-	// literal, matching the fragment serializers (xml_extract_*) and the read_xml reader.
-	xmlDocDumpFormatMemoryEnc(doc.get(), &xml_string, &size, "UTF-8", 0);
-
-	// Use XMLCharPtr for automatic cleanup
-	XMLCharPtr xml_ptr(xml_string);
-
-	if (xml_ptr) {
-		return std::string(reinterpret_cast<const char *>(xml_ptr.get()));
-	} else {
-		return "<" + node_name + ">" + value + "</" + node_name + ">";
+void XMLValueSerializer::ValidateFieldNames(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::LIST:
+		ValidateFieldNames(ListType::GetChildType(type));
+		break;
+	case LogicalTypeId::STRUCT:
+		// STRUCT field names become element names; reject any that would inject markup
+		for (auto &child : StructType::GetChildTypes(type)) {
+			XMLUtils::ValidateXMLElementName(CompatIdentifierName(child.first));
+			ValidateFieldNames(child.second);
+		}
+		break;
+	default:
+		break;
 	}
 }
 
-void XMLUtils::ConvertListToXML(Vector &input_vector, Vector &result, idx_t count, const std::string &node_name) {
-	auto list_suffix = "_list";
-	auto element_name = node_name;
-	auto child_type = ListType::GetChildType(input_vector.GetType());
+const std::string &XMLValueSerializer::ElementName::Read(const UnifiedVectorFormat &names, idx_t row) {
+	auto idx = names.sel->get_index(row);
+	if (!names.validity.RowIsValid(idx)) {
+		return default_name;
+	}
+	auto &name_str = UnifiedVectorFormat::GetData<string_t>(names)[idx];
+	if (!checked || name_str.GetSize() != name.size() || memcmp(name_str.GetData(), name.data(), name.size()) != 0) {
+		name = name_str.GetString();
+		XMLUtils::ValidateXMLElementName(name);
+		checked = true;
+	}
+	return name;
+}
 
-	for (idx_t i = 0; i < count; i++) {
-		// Vector::GetValue handles FLAT, CONSTANT and DICTIONARY input vectors safely
-		Value list_value = input_vector.GetValue(i);
-		if (list_value.IsNull()) {
-			// NULL in -> NULL out
-			result.SetValue(i, Value(result.GetType()));
-			continue;
-		}
+XMLValueSerializer::ValueKind XMLValueSerializer::GetValueKind(const LogicalType &type) {
+	if (XMLTypes::IsXMLFragmentType(type) || XMLTypes::IsXMLType(type)) {
+		return ValueKind::XML;
+	}
+	switch (type.id()) {
+	case LogicalTypeId::LIST:
+		return ValueKind::LIST;
+	case LogicalTypeId::STRUCT:
+		return ValueKind::STRUCT;
+	case LogicalTypeId::VARCHAR:
+		return type.HasAlias() && type.GetAlias() == "JSON" ? ValueKind::JSON : ValueKind::VARCHAR;
+	default:
+		return ValueKind::OTHER;
+	}
+}
 
-		XMLDocPtr doc(xmlNewDoc(BAD_CAST "1.0"));
-		if (!doc) {
-			result.SetValue(i, Value("<" + node_name + list_suffix + "></" + node_name + list_suffix + ">"));
-			continue;
+void XMLValueSerializer::InitializeColumn(Column &column, Vector &vector, idx_t count) {
+	column.kind = GetValueKind(vector.GetType());
+	switch (column.kind) {
+	case ValueKind::LIST: {
+		CompatToUnifiedFormat(vector, count, column.format);
+		column.children.push_back(make_uniq<Column>());
+		InitializeColumn(*column.children.back(), ListVector::GetEntry(vector), ListVector::GetListSize(vector));
+		break;
+	}
+	case ValueKind::STRUCT: {
+		// The fields of a dictionary STRUCT are as long as its dictionary, so read a flat copy instead
+		Vector *source = &vector;
+		if (vector.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+			column.owned = make_uniq<Vector>(vector);
+			column.owned->Flatten(count);
+			source = column.owned.get();
 		}
-
-		// Create root container element
-		xmlNodePtr root_node = xmlNewNode(nullptr, BAD_CAST(node_name + list_suffix).c_str());
-		xmlDocSetRootElement(doc.get(), root_node);
-
-		// Process each list element
-		for (const auto &child_value : ListValue::GetChildren(list_value)) {
-			// Create element node for each list item
-			xmlNodePtr item_node = xmlNewNode(nullptr, BAD_CAST element_name.c_str());
-			xmlAddChild(root_node, item_node);
-
-			// Convert the child value based on its type
-			if (child_type.id() == LogicalTypeId::VARCHAR) {
-				// Plain text content (NULL list elements stay as empty nodes)
-				if (!child_value.IsNull()) {
-					std::string child_str = StringValue::Get(child_value);
-					xmlNodePtr text_node = xmlNewText(BAD_CAST child_str.c_str());
-					if (text_node)
-						xmlAddChild(item_node, text_node);
-				}
-			} else {
-				// For other types, convert recursively
-				xmlNodePtr child_node = ConvertValueToXMLNode(child_value, child_type, element_name, doc.get());
-				if (child_node) {
-					// Add the child node's children to the item node
-					xmlNodePtr content = child_node->children;
-					while (content) {
-						xmlNodePtr next = content->next;
-						xmlUnlinkNode(content);
-						xmlAddChild(item_node, content);
-						content = next;
-					}
-					// Free the wrapper node
-					xmlFreeNode(child_node);
-				}
-			}
+		CompatToUnifiedFormat(*source, count, column.format);
+		auto &child_types = StructType::GetChildTypes(source->GetType());
+		auto &entries = StructVector::GetEntries(*source);
+		for (idx_t i = 0; i < entries.size(); i++) {
+			column.field_names.push_back(CompatIdentifierName(child_types[i].first));
+			column.children.push_back(make_uniq<Column>());
+			InitializeColumn(*column.children.back(), *entries[i], count);
 		}
+		break;
+	}
+	case ValueKind::OTHER:
+		// Converted a vector at a time, with the text Value::ToString would give
+		column.owned = make_uniq<Vector>(LogicalType::VARCHAR, count);
+		VectorOperations::DefaultCast(vector, *column.owned, count);
+		CompatToUnifiedFormat(*column.owned, count, column.format);
+		break;
+	default:
+		CompatToUnifiedFormat(vector, count, column.format);
+		break;
+	}
+}
 
-		// Convert document to string
-		xmlChar *xml_string = nullptr;
-		int size = 0;
-		// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no output-encoding
-		// handler (doc has encoding=NULL), so libxml2 escapes every non-ASCII character to a
-		// numeric character reference (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" keeps non-ASCII
-		// literal, matching the fragment serializers (xml_extract_*) and the read_xml reader.
-		xmlDocDumpFormatMemoryEnc(doc.get(), &xml_string, &size, "UTF-8", 0);
+void XMLValueSerializer::Initialize(Vector &input, idx_t count) {
+	root.owned.reset();
+	root.children.clear();
+	root.field_names.clear();
+	InitializeColumn(root, input, count);
+}
 
-		XMLCharPtr xml_ptr(xml_string);
-		std::string xml_result = xml_ptr ? std::string(reinterpret_cast<const char *>(xml_ptr.get()))
-		                                 : "<" + node_name + list_suffix + "></" + node_name + list_suffix + ">";
+bool XMLValueSerializer::RowIsValid(idx_t row) const {
+	return root.format.validity.RowIsValid(root.format.sel->get_index(row));
+}
 
-		result.SetValue(i, Value(xml_result));
+void XMLValueSerializer::WriteText(const string_t &text) {
+	XMLUtils::AppendXMLEscaped(*out, text.GetData(), text.GetSize(), false);
+}
+
+bool XMLValueSerializer::WriteJSONContent(const string_t &json) {
+	// The children of the root element json_to_xml writes: everything between its start and end tags
+	if (!XMLUtils::TryJSONToXML(json, json_buffer, json_error)) {
+		WriteText(json);
+		return true;
 	}
+	auto start_tag_end = json_buffer.find('>', sizeof(XML_DECLARATION) - 1);
+	if (start_tag_end == std::string::npos || json_buffer[start_tag_end - 1] == '/') {
+		return false;
+	}
+	auto end_tag = json_buffer.rfind("</");
+	if (end_tag == std::string::npos || end_tag <= start_tag_end + 1) {
+		return false;
+	}
+	out->append(json_buffer, start_tag_end + 1, end_tag - start_tag_end - 1);
+	return true;
 }
 
-void XMLUtils::ConvertStructToXML(Vector &input_vector, Vector &result, idx_t count, const std::string &node_name) {
-	auto struct_type = input_vector.GetType();
-	auto &child_types = StructType::GetChildTypes(struct_type);
+bool XMLValueSerializer::WriteEmbeddedDocument(const string_t &text) {
+	XMLDocRAII doc(text);
+	xmlNodePtr doc_root = doc.IsValid() ? xmlDocGetRootElement(doc.doc) : nullptr;
+	string_t serialized;
+	if (!doc_root || !node_serializer.Serialize(doc_root, serialized)) {
+		return false;
+	}
+	out->append(serialized.GetData(), serialized.GetSize());
+	return true;
+}
 
-	for (idx_t i = 0; i < count; i++) {
-		// Vector::GetValue handles FLAT, CONSTANT and DICTIONARY input vectors safely
-		Value struct_value = input_vector.GetValue(i);
-		if (struct_value.IsNull()) {
-			// NULL in -> NULL out
-			result.SetValue(i, Value(result.GetType()));
-			continue;
+bool XMLValueSerializer::WriteContent(Column &column, idx_t row, const std::string &name, bool as_text) {
+	auto idx = column.format.sel->get_index(row);
+	if (!column.format.validity.RowIsValid(idx)) {
+		return false;
+	}
+	switch (column.kind) {
+	case ValueKind::LIST: {
+		auto &entry = UnifiedVectorFormat::GetData<list_entry_t>(column.format)[idx];
+		for (idx_t i = 0; i < entry.length; i++) {
+			WriteElement(*column.children[0], entry.offset + i, name, true, false);
 		}
-		auto &field_values = StructValue::GetChildren(struct_value);
-
-		XMLDocPtr doc(xmlNewDoc(BAD_CAST "1.0"));
-		if (!doc) {
-			result.SetValue(i, Value("<" + node_name + "></" + node_name + ">"));
-			continue;
+		return entry.length > 0;
+	}
+	case ValueKind::STRUCT:
+		for (idx_t i = 0; i < column.children.size(); i++) {
+			WriteElement(*column.children[i], idx, column.field_names[i], true, false);
 		}
+		return !column.children.empty();
+	default:
+		break;
+	}
 
-		// Create root element
-		xmlNodePtr root_node = xmlNewNode(nullptr, BAD_CAST node_name.c_str());
-		xmlDocSetRootElement(doc.get(), root_node);
-
-		// Process each struct field
-		for (idx_t field_idx = 0; field_idx < child_types.size(); field_idx++) {
-			const std::string &field_name = CompatIdentifierName(child_types[field_idx].first);
-			// STRUCT field names become element names; reject any that would inject markup.
-			ValidateXMLElementName(field_name);
-			auto &field_type = child_types[field_idx].second;
-
-			// Create field element
-			xmlNodePtr field_node = xmlNewNode(nullptr, BAD_CAST field_name.c_str());
-			xmlAddChild(root_node, field_node);
-
-			// Convert recursively using the node-based function
-			auto &field_value = field_values[field_idx];
-			if (!field_value.IsNull()) {
-				xmlNodePtr child_node = ConvertValueToXMLNode(field_value, field_type, field_name, doc.get());
-				if (child_node) {
-					// Add the child node directly to the field node
-					// Note: we need to add the *children* of the returned node, not the node itself
-					// since ConvertValueToXMLNode already creates the named node
-					xmlNodePtr content = child_node->children;
-					while (content) {
-						xmlNodePtr next = content->next;
-						xmlUnlinkNode(content);
-						xmlAddChild(field_node, content);
-						content = next;
-					}
-					// Free the wrapper node
-					xmlFreeNode(child_node);
-				}
-			} else {
-				// For NULL values, field_node remains empty
-			}
+	auto &text = UnifiedVectorFormat::GetData<string_t>(column.format)[idx];
+	if (!as_text) {
+		if (column.kind == ValueKind::JSON) {
+			return WriteJSONContent(text);
+		}
+		// A string that is an XML document is embedded as its root element
+		if (column.kind == ValueKind::VARCHAR && MayBeXMLDocument(text) && WriteEmbeddedDocument(text)) {
+			return true;
 		}
-
-		// Convert document to string
-		xmlChar *xml_string = nullptr;
-		int size = 0;
-		// Serialize as literal UTF-8. Plain xmlDocDumpMemory() runs with no output-encoding
-		// handler (doc has encoding=NULL), so libxml2 escapes every non-ASCII character to a
-		// numeric character reference (e.g. 'ö' -> '&#xF6;'). Passing "UTF-8" keeps non-ASCII
-		// literal, matching the fragment serializers (xml_extract_*) and the read_xml reader.
-		xmlDocDumpFormatMemoryEnc(doc.get(), &xml_string, &size, "UTF-8", 0);
-
-		XMLCharPtr xml_ptr(xml_string);
-		std::string xml_result = xml_ptr ? std::string(reinterpret_cast<const char *>(xml_ptr.get()))
-		                                 : "<" + node_name + "></" + node_name + ">";
-
-		result.SetValue(i, Value(xml_result));
 	}
+	WriteText(text);
+	return true;
 }
 
-xmlNodePtr XMLUtils::ConvertValueToXMLNode(const Value &value, const LogicalType &type, const std::string &node_name,
-                                           xmlDocPtr doc) {
-	if (!doc) {
-		return nullptr;
+void XMLValueSerializer::WriteElement(Column &column, idx_t row, const std::string &name, bool list_name,
+                                      bool as_text) {
+	// A nested LIST is named <name_list>; its elements repeat `name`
+	bool is_list = list_name && column.kind == ValueKind::LIST &&
+	               column.format.validity.RowIsValid(column.format.sel->get_index(row));
+	*out += '<';
+	*out += name;
+	if (is_list) {
+		*out += "_list";
 	}
-
-	// Create the main node for this value
-	xmlNodePtr node = xmlNewNode(nullptr, BAD_CAST node_name.c_str());
-	if (!node) {
-		return nullptr;
+	auto start_tag_end = out->size();
+	*out += '>';
+	if (!WriteContent(column, row, name, as_text)) {
+		out->resize(start_tag_end);
+		*out += "/>";
+		return;
+	}
+	*out += "</";
+	*out += name;
+	if (is_list) {
+		*out += "_list";
+	}
+	*out += '>';
+}
+
+void XMLValueSerializer::WriteRootElement(idx_t idx, const std::string &name) {
+	if (root.kind == ValueKind::LIST) {
+		// The elements of a top-level LIST are named after the root; strings among them are text
+		auto &entry = UnifiedVectorFormat::GetData<list_entry_t>(root.format)[idx];
+		auto &element = *root.children[0];
+		bool as_text = element.kind == ValueKind::XML || element.kind == ValueKind::JSON ||
+		               element.kind == ValueKind::VARCHAR;
+		*out += '<';
+		*out += name;
+		if (entry.length == 0) {
+			*out += "_list/>";
+			return;
+		}
+		*out += "_list>";
+		for (idx_t i = 0; i < entry.length; i++) {
+			WriteElement(element, entry.offset + i, name, false, as_text);
+		}
+		*out += "</";
+		*out += name;
+		*out += "_list>";
+		return;
+	}
+	*out += '<';
+	*out += name;
+	*out += '>';
+	if (root.kind == ValueKind::STRUCT) {
+		for (idx_t i = 0; i < root.children.size(); i++) {
+			WriteElement(*root.children[i], idx, root.field_names[i], false, false);
+		}
+	} else {
+		WriteText(UnifiedVectorFormat::GetData<string_t>(root.format)[idx]);
 	}
+	*out += "</";
+	*out += name;
+	*out += '>';
+}
 
-	if (value.IsNull()) {
-		// Empty node for NULL values
-		return node;
-	}
-
-	// Handle type hierarchy similar to ValueToXMLFunction
-	if (XMLTypes::IsXMLFragmentType(type)) {
-		// XMLFragment → Insert verbatim as text
-		std::string content = value.GetValue<string>();
-		xmlNodePtr text_node = xmlNewText(BAD_CAST content.c_str());
-		if (text_node)
-			xmlAddChild(node, text_node);
-		return node;
-	} else if (XMLTypes::IsXMLType(type)) {
-		// XML → Insert verbatim as text
-		std::string content = value.GetValue<string>();
-		xmlNodePtr text_node = xmlNewText(BAD_CAST content.c_str());
-		if (text_node)
-			xmlAddChild(node, text_node);
-		return node;
-	} else if (type.id() == LogicalTypeId::LIST) {
-		// LIST → Create list structure with _list suffix
-		// Change node name to include _list suffix
-		xmlNodeSetName(node, BAD_CAST(node_name + "_list").c_str());
-
-		auto child_type = ListType::GetChildType(type);
-		auto list_value = ListValue::GetChildren(value);
-
-		// Add each list element as a child node
-		for (const auto &child_value : list_value) {
-			xmlNodePtr child_node = ConvertValueToXMLNode(child_value, child_type, node_name, doc);
-			if (child_node) {
-				xmlAddChild(node, child_node);
-			}
+void XMLValueSerializer::WriteDocument(idx_t row, const std::string &name, std::string &out_p) {
+	out = &out_p;
+	auto idx = root.format.sel->get_index(row);
+	switch (root.kind) {
+	case ValueKind::XML: {
+		// Already XML: passed through as is
+		auto &xml = UnifiedVectorFormat::GetData<string_t>(root.format)[idx];
+		out_p.append(xml.GetData(), xml.GetSize());
+		return;
+	}
+	case ValueKind::JSON: {
+		auto &json = UnifiedVectorFormat::GetData<string_t>(root.format)[idx];
+		if (!XMLUtils::TryJSONToXML(json, json_buffer, json_error)) {
+			throw InvalidInputException("Could not convert JSON to XML: %s", json_error);
 		}
-		return node;
-	} else if (type.id() == LogicalTypeId::STRUCT) {
-		// STRUCT → Create struct with field names as tags
-		auto struct_value = StructValue::GetChildren(value);
-		auto &child_types = StructType::GetChildTypes(type);
-
-		// Add each struct field as a child node
-		for (size_t i = 0; i < child_types.size(); i++) {
-			const std::string &field_name = CompatIdentifierName(child_types[i].first);
-			// STRUCT field names become element names; reject any that would inject markup.
-			ValidateXMLElementName(field_name);
-			auto &field_type = child_types[i].second;
-			auto &field_value = struct_value[i];
-
-			xmlNodePtr field_node = ConvertValueToXMLNode(field_value, field_type, field_name, doc);
-			if (field_node) {
-				xmlAddChild(node, field_node);
-			}
+		out_p += json_buffer;
+		return;
+	}
+	case ValueKind::VARCHAR: {
+		auto &text = UnifiedVectorFormat::GetData<string_t>(root.format)[idx];
+		if (MayBeXMLDocument(text) && XMLUtils::IsValidXML(text)) {
+			out_p.append(text.GetData(), text.GetSize());
+			return;
 		}
-		return node;
-	} else {
-		// Check if this is an explicit JSON type (has JSON alias)
-		bool is_json_type = (type.id() == LogicalTypeId::VARCHAR && type.HasAlias() && type.GetAlias() == "JSON");
-
-		if (is_json_type) {
-			// JSON → Structural conversion
-			// For now, treat as text - could be enhanced to parse JSON and create nodes
-			std::string json_str = value.GetValue<string>();
-			std::string xml_result = JSONToXML(json_str);
-
-			// Parse the XML result and add child nodes.
-			// Use xmlReadMemory with explicit safe flags instead of the deprecated xmlParseMemory
-			// (which honors mutable libxml2 globals): forbid network and never substitute/fetch
-			// external entities. See EnsureSecureParsing() for the class-level defense.
-			XMLUtils::EnsureSecureParsing();
-			xmlDocPtr temp_doc = xmlReadMemory(xml_result.c_str(), xml_result.length(), "internal.xml", nullptr,
-			                                   XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
-			if (temp_doc && xmlDocGetRootElement(temp_doc)) {
-				xmlNodePtr temp_root = xmlDocGetRootElement(temp_doc);
-
-				// Copy children from temp root to our node
-				xmlNodePtr child = temp_root->children;
-				while (child) {
-					xmlNodePtr next = child->next;
-					xmlUnlinkNode(child);
-					xmlAddChild(node, child);
-					child = next;
-				}
-				xmlFreeDoc(temp_doc);
-			} else {
-				// Fallback to text
-				xmlNodePtr text_node = xmlNewText(BAD_CAST json_str.c_str());
-				if (text_node)
-					xmlAddChild(node, text_node);
-			}
-			return node;
-		} else {
-			// VARCHAR/Other → String content
-			std::string value_str;
-			if (type.id() == LogicalTypeId::VARCHAR) {
-				value_str = value.GetValue<string>();
-			} else {
-				value_str = value.ToString();
-			}
+		break;
+	}
+	default:
+		break;
+	}
 
-			// Check if input is already valid XML
-			if (type.id() == LogicalTypeId::VARCHAR && IsValidXML(value_str)) {
-				// Parse and add as child nodes. Explicit safe flags (see above): no network,
-				// no external entity substitution/fetch.
-				XMLUtils::EnsureSecureParsing();
-				xmlDocPtr temp_doc = xmlReadMemory(value_str.c_str(), value_str.length(), "internal.xml", nullptr,
-				                                   XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_NONET);
-				if (temp_doc && xmlDocGetRootElement(temp_doc)) {
-					xmlNodePtr temp_root = xmlDocGetRootElement(temp_doc);
-					xmlNodePtr copied_node = xmlCopyNode(temp_root, 1);
-					if (copied_node) {
-						xmlAddChild(node, copied_node);
-					}
-					xmlFreeDoc(temp_doc);
-				} else {
-					// Fallback to text
-					xmlNodePtr text_node = xmlNewText(BAD_CAST value_str.c_str());
-					if (text_node)
-						xmlAddChild(node, text_node);
-				}
-			} else {
-				// Simple text content
-				xmlNodePtr text_node = xmlNewText(BAD_CAST value_str.c_str());
-				if (text_node)
-					xmlAddChild(node, text_node);
-			}
-			return node;
+	out_p += XML_DECLARATION;
+	WriteRootElement(idx, name);
+	out_p += '\n';
+}
+
+void XMLValueSerializer::WriteRecord(idx_t row, const std::string &name, std::string &out_p) {
+	out = &out_p;
+	auto idx = root.format.sel->get_index(row);
+	switch (root.kind) {
+	case ValueKind::XML:
+	case ValueKind::VARCHAR: {
+		// Where WriteDocument passes a document through, its root element is embedded instead
+		auto &text = UnifiedVectorFormat::GetData<string_t>(root.format)[idx];
+		if ((root.kind == ValueKind::XML || MayBeXMLDocument(text)) && WriteEmbeddedDocument(text)) {
+			return;
+		}
+		break;
+	}
+	case ValueKind::JSON: {
+		auto &json = UnifiedVectorFormat::GetData<string_t>(root.format)[idx];
+		if (!XMLUtils::TryJSONToXML(json, json_buffer, json_error)) {
+			throw InvalidInputException("Could not convert JSON to XML: %s", json_error);
 		}
+		out_p.append(json_buffer, sizeof(XML_DECLARATION) - 1, std::string::npos);
+		return;
+	}
+	default:
+		break;
 	}
+	WriteRootElement(idx, name);
 }
 
 // HTML-specific extraction functions
 std::vector<HTMLLink> XMLUtils::ExtractHTMLLinks(const std::string &html_str) {
+	return ExtractHTMLLinks(StringRef(html_str));
+}
+
+std::vector<HTMLLink> XMLUtils::ExtractHTMLLinks(const string_t &html_str) {
 	std::vector<HTMLLink> links;
 
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return links;
 	}
@@ -2632,9 +2394,14 @@ std::vector<HTMLLink> XMLUtils::ExtractHTMLLinks(const std::string &html_str) {
 }
 
 std::vector<HTMLImage> XMLUtils::ExtractHTMLImages(const std::string &html_str) {
+	return ExtractHTMLImages(StringRef(html_str));
+}
+
+std::vector<HTMLImage> XMLUtils::ExtractHTMLImages(const string_t &html_str) {
 	std::vector<HTMLImage> images;
 
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return images;
 	}
@@ -2701,9 +2468,14 @@ std::vector<HTMLImage> XMLUtils::ExtractHTMLImages(const std::string &html_str)
 }
 
 std::vector<HTMLTable> XMLUtils::ExtractHTMLTables(const std::string &html_str) {
+	return ExtractHTMLTables(StringRef(html_str));
+}
+
+std::vector<HTMLTable> XMLUtils::ExtractHTMLTables(const string_t &html_str) {
 	std::vector<HTMLTable> tables;
 
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return tables;
 	}
@@ -2810,14 +2582,19 @@ std::vector<HTMLTable> XMLUtils::ExtractHTMLTables(const std::string &html_str)
 }
 
 std::string XMLUtils::ExtractHTMLText(const std::string &html_str, const std::string &selector) {
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	return ExtractHTMLText(StringRef(html_str), selector);
+}
+
+std::string XMLUtils::ExtractHTMLText(const string_t &html_str, const std::string &selector) {
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return "";
 	}
 
 	std::string xpath = selector.empty() ? "//text()" : selector;
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), html_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, html_doc.xpath_ctx, nullptr);
 
 	if (!xpath_obj || !xpath_obj->nodesetval) {
 		if (xpath_obj)
@@ -2841,12 +2618,17 @@ std::string XMLUtils::ExtractHTMLText(const std::string &html_str, const std::st
 }
 
 std::string XMLUtils::ExtractHTMLTextByXPath(const std::string &html_str, const std::string &xpath) {
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	return ExtractHTMLTextByXPath(StringRef(html_str), xpath);
+}
+
+std::string XMLUtils::ExtractHTMLTextByXPath(const string_t &html_str, const std::string &xpath) {
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return "";
 	}
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), html_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, html_doc.xpath_ctx, nullptr);
 
 	if (!xpath_obj || !xpath_obj->nodesetval) {
 		if (xpath_obj)
@@ -2870,15 +2652,22 @@ std::string XMLUtils::ExtractHTMLTextByXPath(const std::string &html_str, const
 	return text_content;
 }
 
-std::vector<std::string> XMLUtils::ExtractHTMLAllTextByXPath(const std::string &html_str, const std::string &xpath) {
+std::vector<std::string> XMLUtils::ExtractHTMLAllTextByXPath(const std::string &html_str, const std::string &xpath,
+                                                             xmlXPathCompExprPtr compiled) {
+	return ExtractHTMLAllTextByXPath(StringRef(html_str), xpath, compiled);
+}
+
+std::vector<std::string> XMLUtils::ExtractHTMLAllTextByXPath(const string_t &html_str, const std::string &xpath,
+                                                             xmlXPathCompExprPtr compiled) {
 	std::vector<std::string> results;
 
-	XMLDocRAII html_doc(html_str, true); // Use HTML parser
+	XMLDocRAII uncached;
+	auto &html_doc = XMLDocumentCache::Get(html_str, true, uncached);
 	if (!html_doc.IsValid() || !html_doc.xpath_ctx) {
 		return results;
 	}
 
-	xmlXPathObjectPtr xpath_obj = xmlXPathEvalExpression(BAD_CAST xpath.c_str(), html_doc.xpath_ctx);
+	xmlXPathObjectPtr xpath_obj = EvaluateXPath(xpath, html_doc.xpath_ctx, compiled);
 
 	if (!xpath_obj || !xpath_obj->nodesetval) {
 		if (xpath_obj)
@@ -2982,33 +2771,67 @@ std::string XMLUtils::HTMLEscape(const std::string &text) {
 
 std::set<std::string> DetectXPathPrefixes(const std::string &xpath) {
 	std::set<std::string> prefixes;
+	ForEachXPathQName(xpath, [&](const XPathQName &qname) {
+		prefixes.insert(xpath.substr(qname.start, qname.colon - qname.start));
+	});
+	return prefixes;
+}
 
-	// Regex pattern to match namespace prefixes in XPath
-	// Matches: prefix:name where prefix is NCName (valid XML name without colon)
-	// NCName pattern: [A-Za-z_][A-Za-z0-9._-]*
-	// We look for prefix: followed by a valid name character (not ::)
-	static const std::regex prefix_pattern(
-	    R"((?:^|[/\[\(@,|])([A-Za-z_][A-Za-z0-9._-]*):(?!:)([A-Za-z_*][A-Za-z0-9._-]*))", std::regex::optimize);
-
-	// XPath axes to exclude (these use :: not single :)
-	static const std::set<std::string> xpath_axes = {
-	    "ancestor",  "ancestor-or-self",  "attribute", "child",  "descendant", "descendant-or-self",
-	    "following", "following-sibling", "namespace", "parent", "preceding",  "preceding-sibling",
-	    "self"};
-
-	std::sregex_iterator iter(xpath.begin(), xpath.end(), prefix_pattern);
-	std::sregex_iterator end;
-
-	while (iter != end) {
-		std::string prefix = (*iter)[1].str();
-		// Don't include XPath axis specifiers
-		if (xpath_axes.find(prefix) == xpath_axes.end()) {
-			prefixes.insert(prefix);
+// Quote `value` as an XPath 1.0 string literal, which has no escapes: a value holding both quote
+// characters is spelled as a concat() of single-quoted parts and quoted apostrophes.
+static std::string XPathStringLiteral(const std::string &value) {
+	if (value.find('\'') == std::string::npos) {
+		return "'" + value + "'";
+	}
+	if (value.find('"') == std::string::npos) {
+		return "\"" + value + "\"";
+	}
+	std::string result = "concat(";
+	idx_t start = 0;
+	while (true) {
+		auto quote = value.find('\'', start);
+		result += "'" + value.substr(start, quote == std::string::npos ? std::string::npos : quote - start) + "'";
+		if (quote == std::string::npos) {
+			break;
 		}
-		++iter;
+		result += ", \"'\", ";
+		start = quote + 1;
 	}
+	return result + ")";
+}
 
-	return prefixes;
+// Rewrite the name tests that use a prefix of `undeclared_prefixes` (prefix -> uri) so they match
+// both nodes in that namespace and nodes whose name carries the prefix without any declaration
+// (libxml2 keeps such names as written, e.g. "gml:pos", with no namespace). Example:
+//   //gml:pos -> //*[(name()='gml:pos' and namespace-uri()='') or
+//                    (local-name()='pos' and namespace-uri()='http://www.opengis.net/gml')]
+std::string TransformXPathForUndeclaredPrefixes(const std::string &xpath,
+                                                const case_insensitive_map_t<string> &undeclared_prefixes) {
+	std::string result;
+	idx_t copied = 0;
+	ForEachXPathQName(xpath, [&](const XPathQName &qname) {
+		if (qname.is_function) {
+			return;
+		}
+		auto prefix = xpath.substr(qname.start, qname.colon - qname.start);
+		auto entry = undeclared_prefixes.find(prefix);
+		if (entry == undeclared_prefixes.end()) {
+			return;
+		}
+		auto local_name = xpath.substr(qname.colon + 1, qname.end - qname.colon - 1);
+		auto uri = XPathStringLiteral(entry->second);
+		result.append(xpath, copied, qname.start - copied);
+		if (local_name == "*") {
+			result += "*[(starts-with(name(), '" + prefix + ":') and namespace-uri() = '') or namespace-uri() = " +
+			          uri + "]";
+		} else {
+			result += "*[(name() = '" + prefix + ":" + local_name + "' and namespace-uri() = '') or (local-name() = '" +
+			          local_name + "' and namespace-uri() = " + uri + ")]";
+		}
+		copied = qname.end;
+	});
+	result.append(xpath, copied, std::string::npos);
+	return result;
 }
 
 // Inject namespace declarations into XML document for undeclared prefixes
@@ -3154,29 +2977,6 @@ std::string GetCommonNamespaceURI(const std::string &prefix) {
 	return "";
 }
 
-// Scan XML for prefixed names and return prefixes used in the document
-std::set<std::string> DetectDocumentPrefixes(const std::string &xml_str) {
-	std::set<std::string> prefixes;
-
-	// Pattern to match prefixed element or attribute names: prefix:name
-	static const std::regex prefix_pattern(R"(<([A-Za-z_][A-Za-z0-9._-]*):|\s([A-Za-z_][A-Za-z0-9._-]*):)",
-	                                       std::regex::optimize);
-
-	std::sregex_iterator iter(xml_str.begin(), xml_str.end(), prefix_pattern);
-	std::sregex_iterator end;
-
-	while (iter != end) {
-		// Match is in group 1 (element) or group 2 (attribute)
-		std::string prefix = (*iter)[1].matched ? (*iter)[1].str() : (*iter)[2].str();
-		if (!prefix.empty() && prefix != "xmlns") {
-			prefixes.insert(prefix);
-		}
-		++iter;
-	}
-
-	return prefixes;
-}
-
 // ============================================================================
 // Namespace Parameter Parsing
 // ============================================================================